@@ -0,0 +1,169 @@
+// Licensed under the MIT License.
+
+// Arena
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include "arena.h"
+#define ARENA_ALIGNMENT 16
+
+struct ArenaBlock
+{
+    struct ArenaBlock* next;
+    size_t capacity;
+};
+
+typedef struct ArenaBlock* ArenaBlock;
+
+static size_t align(size_t size)
+{
+    size_t remainder = size % ARENA_ALIGNMENT;
+
+    if (!remainder)
+    {
+        return size;
+    }
+
+    return size + ARENA_ALIGNMENT - remainder;
+}
+
+static char* block_data(ArenaBlock instance)
+{
+    return (char*)instance + align(sizeof * instance);
+}
+
+void arena(Arena instance, size_t blockSize)
+{
+    instance->first = NULL;
+    instance->current = NULL;
+    instance->offset = 0;
+    instance->blockSize = align(blockSize);
+}
+
+void* arena_allocate(Arena instance, size_t size)
+{
+    if (size > SIZE_MAX / 2)
+    {
+        return NULL;
+    }
+
+    size = align(size);
+
+    ArenaBlock current = instance->current;
+
+    if (current && current->capacity - instance->offset >= size)
+    {
+        void* result = block_data(current) + instance->offset;
+
+        instance->offset += size;
+
+        return result;
+    }
+
+    ArenaBlock next = instance->first;
+
+    if (current)
+    {
+        next = current->next;
+    }
+
+    if (!next || next->capacity < size)
+    {
+        size_t capacity = instance->blockSize;
+
+        if (size > capacity)
+        {
+            capacity = size;
+        }
+
+        ArenaBlock block = malloc(align(sizeof * block) + capacity);
+
+        if (!block)
+        {
+            return NULL;
+        }
+
+        block->next = next;
+        block->capacity = capacity;
+
+        if (current)
+        {
+            current->next = block;
+        }
+        else
+        {
+            instance->first = block;
+        }
+
+        next = block;
+    }
+
+    instance->current = next;
+    instance->offset = size;
+
+    return block_data(next);
+}
+
+void* arena_reallocate(
+    Arena instance,
+    void* pointer,
+    size_t size,
+    size_t newSize)
+{
+    if (!pointer)
+    {
+        return arena_allocate(instance, newSize);
+    }
+
+    ArenaBlock current = instance->current;
+
+    if (newSize <= SIZE_MAX / 2 &&
+        (char*)pointer + align(size) == block_data(current) + instance->offset)
+    {
+        size_t offset = instance->offset - align(size);
+
+        if (current->capacity - offset >= align(newSize))
+        {
+            instance->offset = offset + align(newSize);
+
+            return pointer;
+        }
+    }
+
+    void* result = arena_allocate(instance, newSize);
+
+    if (!result)
+    {
+        return NULL;
+    }
+
+    if (newSize < size)
+    {
+        size = newSize;
+    }
+
+    memcpy(result, pointer, size);
+
+    return result;
+}
+
+void arena_reset(Arena instance)
+{
+    instance->current = instance->first;
+    instance->offset = 0;
+}
+
+void finalize_arena(Arena instance)
+{
+    ArenaBlock block = instance->first;
+
+    while (block)
+    {
+        ArenaBlock next = block->next;
+
+        free(block);
+
+        block = next;
+    }
+}
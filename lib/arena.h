@@ -0,0 +1,51 @@
+// Licensed under the MIT License.
+
+// Arena
+
+#ifndef ARENA_H
+#define ARENA_H
+#include <stddef.h>
+
+struct ArenaBlock;
+
+// A bump-pointer allocator. Allocations are never freed individually; the
+// whole arena is reset or finalized at once. Blocks are kept across resets and
+// reused before new blocks are requested.
+
+struct Arena
+{
+    struct ArenaBlock* first;
+    struct ArenaBlock* current;
+    size_t offset;
+    size_t blockSize;
+};
+
+typedef struct Arena* Arena;
+
+// Initializes an empty arena. Blocks are allocated lazily, each holding at
+// least `blockSize` bytes.
+
+void arena(Arena instance, size_t blockSize);
+
+// Returns uninitialized memory suitably aligned for any object, or NULL if
+// memory is exhausted.
+
+void* arena_allocate(Arena instance, size_t size);
+
+// Resizes an allocation. The most recent allocation is resized in place when
+// its block has room; otherwise the contents are copied to a new allocation
+// and the old space is not reclaimed until the arena is reset. Returns NULL if
+// memory is exhausted, leaving the original allocation intact.
+
+void* arena_reallocate(
+    Arena instance,
+    void* pointer,
+    size_t size,
+    size_t newSize);
+
+// Releases every allocation in constant time, keeping the blocks for reuse.
+
+void arena_reset(Arena instance);
+void finalize_arena(Arena instance);
+
+#endif
@@ -0,0 +1,205 @@
+// Licensed under the MIT License.
+
+// Cache
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "cache.h"
+#define CACHE_MAGIC "AOCC0002"
+
+// Every file begins with a header identifying the input from which the
+// payload was compiled, and ends with a copy of that input. The hash only
+// names the file: on load, the stored input is compared byte for byte with the
+// input being solved, so a collision is a miss rather than a wrong payload.
+// The sizes guard against a file left truncated by an interrupted write.
+
+struct CacheHeader
+{
+    char magic[8];
+    unsigned long long hash;
+    unsigned long long length;
+    unsigned long long size;
+};
+
+static unsigned long long hash(const char* input, size_t length)
+{
+    const char* p = input;
+    const char* end = input + length;
+    unsigned long long result = 0xcbf29ce484222325ull ^ length;
+
+    for (; end - p >= 8; p += 8)
+    {
+        unsigned long long word;
+
+        memcpy(&word, p, sizeof word);
+
+        result = (result ^ word) * 0x100000001b3ull;
+        result ^= result >> 32;
+    }
+
+    for (; p < end; p++)
+    {
+        result = (result ^ (unsigned char)*p) * 0x100000001b3ull;
+    }
+
+    return result;
+}
+
+bool cache_enabled(void)
+{
+    const char* directory = getenv(SOLVER_CACHE_VARIABLE);
+
+    return directory && *directory;
+}
+
+static char* cache_path(
+    const char* name,
+    unsigned long long key,
+    const char* extension)
+{
+    const char* directory = getenv(SOLVER_CACHE_VARIABLE);
+    size_t size = strlen(directory) + strlen(name) + strlen(extension) + 20;
+    char* result = malloc(size);
+
+    if (!result)
+    {
+        return NULL;
+    }
+
+    snprintf(result, size, "%s/%s-%016llx%s", directory, name, key, extension);
+
+    return result;
+}
+
+bool cache_load(
+    Cache instance,
+    const char* name,
+    const char* input,
+    size_t length)
+{
+    if (!cache_enabled())
+    {
+        return false;
+    }
+
+    unsigned long long key = hash(input, length);
+    char* path = cache_path(name, key, ".bin");
+
+    if (!path)
+    {
+        return false;
+    }
+
+    Exception exception = input_open(&instance->file, path);
+
+    free(path);
+
+    if (exception)
+    {
+        return false;
+    }
+
+    struct CacheHeader header;
+
+    if (instance->file.length < sizeof header)
+    {
+        finalize_input(&instance->file);
+
+        return false;
+    }
+
+    memcpy(&header, instance->file.buffer, sizeof header);
+
+    const char* data = instance->file.buffer + sizeof header;
+    size_t available = instance->file.length - sizeof header;
+
+    if (memcmp(header.magic, CACHE_MAGIC, sizeof header.magic) != 0 ||
+        header.hash != key ||
+        header.length != length ||
+        header.size > available ||
+        available - header.size != length ||
+        memcmp(data + header.size, input, length) != 0)
+    {
+        finalize_input(&instance->file);
+
+        return false;
+    }
+
+    instance->data = data;
+    instance->size = header.size;
+
+    return true;
+}
+
+bool cache_store(
+    const char* name,
+    const char* input,
+    size_t length,
+    const void* data,
+    size_t size)
+{
+    if (!cache_enabled())
+    {
+        return false;
+    }
+
+    unsigned long long key = hash(input, length);
+    char* path = cache_path(name, key, ".bin");
+    char* temporaryPath = cache_path(name, key, ".tmp");
+
+    if (!path || !temporaryPath)
+    {
+        free(path);
+        free(temporaryPath);
+
+        return false;
+    }
+
+    struct CacheHeader header;
+
+    memcpy(header.magic, CACHE_MAGIC, sizeof header.magic);
+
+    header.hash = key;
+    header.length = length;
+    header.size = size;
+
+    // The payload is written to a temporary file and renamed into place, so a
+    // concurrent load sees either no file or a complete one.
+
+    bool result = false;
+    FILE* stream = fopen(temporaryPath, "wb");
+
+    if (stream)
+    {
+        result =
+            fwrite(&header, sizeof header, 1, stream) == 1 &&
+            fwrite(data, 1, size, stream) == size &&
+            fwrite(input, 1, length, stream) == length;
+
+        if (fclose(stream) == EOF)
+        {
+            result = false;
+        }
+
+        if (result && rename(temporaryPath, path) != 0)
+        {
+            result = false;
+        }
+
+        if (!result)
+        {
+            remove(temporaryPath);
+        }
+    }
+
+    free(path);
+    free(temporaryPath);
+
+    return result;
+}
+
+void finalize_cache(Cache instance)
+{
+    finalize_input(&instance->file);
+}
@@ -0,0 +1,54 @@
+// Licensed under the MIT License.
+
+// Cache
+
+#ifndef CACHE_H
+#define CACHE_H
+#include <stdbool.h>
+#include "input.h"
+
+// The compiled form of an input: a binary payload that a solver derives from
+// the text of its input and can load instead of parsing the text again. Each
+// payload is stored in the directory named by the environment variable
+// `SOLVER_CACHE_VARIABLE`, in a file whose name combines the name of the
+// solver with a hash of the input. The file also holds a copy of the input,
+// which must match exactly for the payload to load. Payloads use the native
+// byte order and layout, so they are not portable between machines or builds.
+
+struct Cache
+{
+    struct Input file;
+    const void* data;
+    size_t size;
+};
+
+typedef struct Cache* Cache;
+
+// Returns true if the environment variable names a cache directory.
+
+bool cache_enabled(void);
+
+// Maps the payload that the named solver stored for the input. Returns false
+// if caching is disabled or no valid payload was stored for the input, in
+// which case the instance must not be finalized.
+
+bool cache_load(
+    Cache instance,
+    const char* name,
+    const char* input,
+    size_t length);
+
+// Stores the payload that the named solver compiled from the input. Returns
+// false if caching is disabled or the payload cannot be written; either way,
+// the solver continues with the structures it parsed.
+
+bool cache_store(
+    const char* name,
+    const char* input,
+    size_t length,
+    const void* data,
+    size_t size);
+
+void finalize_cache(Cache instance);
+
+#endif
@@ -0,0 +1,360 @@
+// Licensed under the MIT License.
+
+// Hash Table
+
+#include <stdlib.h>
+#include <string.h>
+#include "hash_table.h"
+#define HASH_TABLE_ALIGNMENT 8
+#define HASH_TABLE_INITIAL_CAPACITY 16
+
+static size_t align(size_t size)
+{
+    size_t remainder = size % HASH_TABLE_ALIGNMENT;
+
+    if (!remainder)
+    {
+        return size;
+    }
+
+    return size + HASH_TABLE_ALIGNMENT - remainder;
+}
+
+static bool equalsbytes(const void* left, const void* right, size_t size)
+{
+    return memcmp(left, right, size) == 0;
+}
+
+// Applies the MurmurHash3 finalizer so that the low bits select a slot well.
+// Zero marks an empty slot, so it is never returned.
+
+static unsigned int mix(unsigned int hash)
+{
+    hash ^= hash >> 16;
+    hash *= 0x85ebca6bu;
+    hash ^= hash >> 13;
+    hash *= 0xc2b2ae35u;
+    hash ^= hash >> 16;
+
+    if (!hash)
+    {
+        return 1;
+    }
+
+    return hash;
+}
+
+static char* entry(HashTable instance, size_t index)
+{
+    return instance->entries + index * instance->entrySize;
+}
+
+static bool find(
+    HashTable instance,
+    const void* key,
+    unsigned int hash,
+    size_t* result)
+{
+    if (!instance->capacity)
+    {
+        return false;
+    }
+
+    size_t mask = instance->capacity - 1;
+
+    for (size_t i = hash & mask, distance = 0; ; i = (i + 1) & mask, distance++)
+    {
+        unsigned int current = instance->hashes[i];
+
+        if (!current || ((i - current) & mask) < distance)
+        {
+            return false;
+        }
+
+        if (current == hash &&
+            instance->equals(entry(instance, i), key, instance->keySize))
+        {
+            *result = i;
+
+            return true;
+        }
+    }
+}
+
+// Claims a slot for a new entry. Each run of occupied slots is ordered by home
+// slot, so the new entry goes before the first entry that is closer to its home
+// slot than the new entry would be, and the rest of the run moves one slot
+// along.
+
+static size_t place(HashTable instance, unsigned int hash)
+{
+    size_t mask = instance->capacity - 1;
+    size_t result = hash & mask;
+
+    for (size_t distance = 0; instance->hashes[result]; distance++)
+    {
+        if (((result - instance->hashes[result]) & mask) < distance)
+        {
+            break;
+        }
+
+        result = (result + 1) & mask;
+    }
+
+    size_t empty = result;
+
+    while (instance->hashes[empty])
+    {
+        empty = (empty + 1) & mask;
+    }
+
+    while (empty != result)
+    {
+        size_t previous = (empty - 1) & mask;
+
+        instance->hashes[empty] = instance->hashes[previous];
+
+        memcpy(
+            entry(instance, empty),
+            entry(instance, previous),
+            instance->entrySize);
+
+        empty = previous;
+    }
+
+    instance->hashes[result] = hash;
+
+    return result;
+}
+
+static bool grow(HashTable instance)
+{
+    size_t newCapacity = instance->capacity * 2;
+
+    if (!newCapacity)
+    {
+        newCapacity = HASH_TABLE_INITIAL_CAPACITY;
+    }
+
+    unsigned int* newHashes = calloc(newCapacity, sizeof * newHashes);
+    char* newEntries = malloc(newCapacity * instance->entrySize);
+
+    if (!newHashes || !newEntries)
+    {
+        free(newHashes);
+        free(newEntries);
+
+        return false;
+    }
+
+    struct HashTable old = *instance;
+
+    instance->hashes = newHashes;
+    instance->entries = newEntries;
+    instance->capacity = newCapacity;
+
+    for (size_t i = 0; i < old.capacity; i++)
+    {
+        if (!old.hashes[i])
+        {
+            continue;
+        }
+
+        memcpy(
+            entry(instance, place(instance, old.hashes[i])),
+            entry(&old, i),
+            instance->entrySize);
+    }
+
+    free(old.hashes);
+    free(old.entries);
+
+    return true;
+}
+
+unsigned int hash_table_hash_bytes(const void* key, size_t size)
+{
+    const unsigned char* bytes = key;
+    unsigned int hash = 2166136261u ^ (unsigned int)size;
+
+    while (size >= sizeof hash)
+    {
+        unsigned int word;
+
+        memcpy(&word, bytes, sizeof word);
+
+        hash = (hash ^ word) * 16777619u;
+        hash ^= hash >> 15;
+        bytes += sizeof word;
+        size -= sizeof word;
+    }
+
+    while (size)
+    {
+        hash = (hash ^ *bytes) * 16777619u;
+        bytes++;
+        size--;
+    }
+
+    return hash;
+}
+
+void hash_table(
+    HashTable instance,
+    size_t keySize,
+    size_t valueSize,
+    HashTableHash hash,
+    HashTableEquals equals)
+{
+    if (!hash)
+    {
+        hash = hash_table_hash_bytes;
+    }
+
+    if (!equals)
+    {
+        equals = equalsbytes;
+    }
+
+    instance->hashes = NULL;
+    instance->entries = NULL;
+    instance->hash = hash;
+    instance->equals = equals;
+    instance->keySize = keySize;
+    instance->valueOffset = align(keySize);
+    instance->entrySize = align(instance->valueOffset + valueSize);
+    instance->count = 0;
+    instance->capacity = 0;
+}
+
+void* hash_table_get(HashTable instance, const void* key)
+{
+    size_t index;
+    unsigned int hash = mix(instance->hash(key, instance->keySize));
+
+    if (!find(instance, key, hash, &index))
+    {
+        return NULL;
+    }
+
+    return entry(instance, index) + instance->valueOffset;
+}
+
+void* hash_table_add(HashTable instance, const void* key, bool* added)
+{
+    size_t index;
+    unsigned int hash = mix(instance->hash(key, instance->keySize));
+
+    if (find(instance, key, hash, &index))
+    {
+        if (added)
+        {
+            *added = false;
+        }
+
+        return entry(instance, index) + instance->valueOffset;
+    }
+
+    if ((instance->count + 1) * 2 > instance->capacity && !grow(instance))
+    {
+        return NULL;
+    }
+
+    index = place(instance, hash);
+    instance->count++;
+
+    char* result = entry(instance, index);
+
+    memcpy(result, key, instance->keySize);
+    memset(
+        result + instance->keySize,
+        0,
+        instance->entrySize - instance->keySize);
+
+    if (added)
+    {
+        *added = true;
+    }
+
+    return result + instance->valueOffset;
+}
+
+bool hash_table_remove(HashTable instance, const void* key)
+{
+    size_t index;
+    unsigned int hash = mix(instance->hash(key, instance->keySize));
+
+    if (!find(instance, key, hash, &index))
+    {
+        return false;
+    }
+
+    size_t mask = instance->capacity - 1;
+    size_t next = (index + 1) & mask;
+
+    while (instance->hashes[next] && ((next - instance->hashes[next]) & mask))
+    {
+        instance->hashes[index] = instance->hashes[next];
+
+        memcpy(
+            entry(instance, index),
+            entry(instance, next),
+            instance->entrySize);
+
+        index = next;
+        next = (next + 1) & mask;
+    }
+
+    instance->hashes[index] = 0;
+    instance->count--;
+
+    return true;
+}
+
+void hash_table_clear(HashTable instance)
+{
+    if (instance->capacity)
+    {
+        memset(
+            instance->hashes,
+            0,
+            instance->capacity * sizeof * instance->hashes);
+    }
+
+    instance->count = 0;
+}
+
+void hash_table_begin(HashTable instance, HashTableIterator iterator)
+{
+    (void)instance;
+
+    iterator->index = 0;
+    iterator->key = NULL;
+    iterator->value = NULL;
+}
+
+bool hash_table_next(HashTable instance, HashTableIterator iterator)
+{
+    while (iterator->index < instance->capacity)
+    {
+        size_t i = iterator->index;
+
+        iterator->index++;
+
+        if (instance->hashes[i])
+        {
+            iterator->key = entry(instance, i);
+            iterator->value = entry(instance, i) + instance->valueOffset;
+
+            return true;
+        }
+    }
+
+    return false;
+}
+
+void finalize_hash_table(HashTable instance)
+{
+    free(instance->hashes);
+    free(instance->entries);
+}
@@ -0,0 +1,84 @@
+// Licensed under the MIT License.
+
+// Hash Table
+
+#ifndef HASH_TABLE_H
+#define HASH_TABLE_H
+#include <stdbool.h>
+#include <stddef.h>
+
+// Returns the hash code of a key. The table mixes the result, so the low bits
+// need not be well-distributed.
+
+typedef unsigned int (*HashTableHash)(const void* key, size_t size);
+
+// Returns true if two keys are equal.
+
+typedef bool (*HashTableEquals)(
+    const void* left,
+    const void* right,
+    size_t size);
+
+// An open-addressing hash table with Robin Hood probing. Keys and values are
+// stored inline in a single array, and the table doubles in size when it is
+// half full.
+
+struct HashTable
+{
+    unsigned int* hashes;
+    char* entries;
+    HashTableHash hash;
+    HashTableEquals equals;
+    size_t keySize;
+    size_t valueOffset;
+    size_t entrySize;
+    size_t count;
+    size_t capacity;
+};
+
+struct HashTableIterator
+{
+    size_t index;
+    void* key;
+    void* value;
+};
+
+typedef struct HashTable* HashTable;
+typedef struct HashTableIterator* HashTableIterator;
+
+// Hashes the bytes of a key. Used when the `hash` argument to `hash_table` is
+// NULL.
+
+unsigned int hash_table_hash_bytes(const void* key, size_t size);
+
+// Initializes an empty table. If `hash` or `equals` is NULL, keys are hashed
+// and compared byte by byte, so they must not contain padding.
+
+void hash_table(
+    HashTable instance,
+    size_t keySize,
+    size_t valueSize,
+    HashTableHash hash,
+    HashTableEquals equals);
+
+// Returns a pointer to the value for the key, or NULL if the key is absent.
+// Pointers into the table are invalidated by `hash_table_add` and
+// `hash_table_remove`.
+
+void* hash_table_get(HashTable instance, const void* key);
+
+// Returns a pointer to the value for the key, first adding the key with a
+// zeroed value if it is absent. Sets `added` (if not NULL) to indicate whether
+// the key was added. Returns NULL if memory is exhausted.
+
+void* hash_table_add(HashTable instance, const void* key, bool* added);
+bool hash_table_remove(HashTable instance, const void* key);
+void hash_table_clear(HashTable instance);
+
+// Visits every entry in an unspecified order.
+
+void hash_table_begin(HashTable instance, HashTableIterator iterator);
+bool hash_table_next(HashTable instance, HashTableIterator iterator);
+void finalize_hash_table(HashTable instance);
+
+#endif
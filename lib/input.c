@@ -0,0 +1,157 @@
+// Licensed under the MIT License.
+
+// Input
+
+#if defined(__unix__) || defined(__APPLE__)
+#define _POSIX_C_SOURCE 200809L
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+#include <stdlib.h>
+#include "input.h"
+#define INPUT_INITIAL_CAPACITY 4096
+
+static bool map(Input instance, FILE* stream)
+{
+#if defined(__unix__) || defined(__APPLE__)
+    struct stat status;
+    int descriptor = fileno(stream);
+
+    if (descriptor == -1 ||
+        fstat(descriptor, &status) == -1 ||
+        !S_ISREG(status.st_mode) ||
+        status.st_size <= 0)
+    {
+        return false;
+    }
+
+    off_t offset = lseek(descriptor, 0, SEEK_CUR);
+
+    if (offset == -1 || offset >= status.st_size)
+    {
+        return false;
+    }
+
+    size_t mappingLength = status.st_size;
+    void* mapping = mmap(
+        NULL,
+        mappingLength,
+        PROT_READ,
+        MAP_PRIVATE,
+        descriptor,
+        0);
+
+    if (mapping == MAP_FAILED)
+    {
+        return false;
+    }
+
+    posix_madvise(mapping, mappingLength, POSIX_MADV_SEQUENTIAL);
+
+    instance->buffer = (const char*)mapping + offset;
+    instance->length = mappingLength - offset;
+    instance->mapping = mapping;
+    instance->mappingLength = mappingLength;
+
+    return true;
+#else
+    (void)instance;
+    (void)stream;
+
+    return false;
+#endif
+}
+
+static Exception slurp(Input instance, FILE* stream)
+{
+    size_t count = 0;
+    size_t capacity = INPUT_INITIAL_CAPACITY;
+    char* buffer = malloc(capacity);
+
+    if (!buffer)
+    {
+        return EXCEPTION_OUT_OF_MEMORY;
+    }
+
+    for (;;)
+    {
+        if (count == capacity)
+        {
+            char* resized = realloc(buffer, capacity * 2);
+
+            if (!resized)
+            {
+                free(buffer);
+
+                return EXCEPTION_OUT_OF_MEMORY;
+            }
+
+            buffer = resized;
+            capacity *= 2;
+        }
+
+        size_t read = fread(buffer + count, 1, capacity - count, stream);
+
+        if (!read)
+        {
+            break;
+        }
+
+        count += read;
+    }
+
+    if (ferror(stream))
+    {
+        free(buffer);
+
+        return EXCEPTION_IO;
+    }
+
+    instance->buffer = buffer;
+    instance->length = count;
+    instance->mapping = NULL;
+    instance->mappingLength = 0;
+
+    return EXCEPTION_NONE;
+}
+
+Exception input_read(Input instance, FILE* stream)
+{
+    if (map(instance, stream))
+    {
+        return EXCEPTION_NONE;
+    }
+
+    return slurp(instance, stream);
+}
+
+Exception input_open(Input instance, const char* path)
+{
+    FILE* stream = fopen(path, "rb");
+
+    if (!stream)
+    {
+        return EXCEPTION_IO;
+    }
+
+    Exception result = input_read(instance, stream);
+
+    fclose(stream);
+
+    return result;
+}
+
+void finalize_input(Input instance)
+{
+#if defined(__unix__) || defined(__APPLE__)
+    if (instance->mapping)
+    {
+        munmap(instance->mapping, instance->mappingLength);
+
+        return;
+    }
+#endif
+
+    free((char*)instance->buffer);
+}
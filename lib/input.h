@@ -0,0 +1,28 @@
+// Licensed under the MIT License.
+
+// Input
+
+#ifndef INPUT_H
+#define INPUT_H
+#include <stdbool.h>
+#include <stdio.h>
+#include "solver.h"
+
+struct Input
+{
+    const char* buffer;
+    size_t length;
+    void* mapping;
+    size_t mappingLength;
+};
+
+typedef struct Input* Input;
+
+// Maps the stream into memory if it refers to a regular file; otherwise, reads
+// the stream into a single growable buffer.
+
+Exception input_read(Input instance, FILE* stream);
+Exception input_open(Input instance, const char* path);
+void finalize_input(Input instance);
+
+#endif
@@ -0,0 +1,159 @@
+// Licensed under the MIT License.
+
+// Memory Statistics
+
+#if defined(__unix__) || defined(__APPLE__)
+#define _POSIX_C_SOURCE 200809L
+#include <sys/resource.h>
+#endif
+#include <stdlib.h>
+#include "memory.h"
+#if defined(__GLIBC__)
+#include <malloc.h>
+#endif
+
+// glibc allows a program to replace the allocator by defining `malloc` and
+// its relatives; the replacements forward to the glibc implementation. The
+// sanitizers replace the allocator themselves, so they take precedence.
+
+#if defined(__GLIBC__) && \
+    !defined(__SANITIZE_ADDRESS__) && \
+    !defined(__SANITIZE_THREAD__)
+#define MEMORY_INTERPOSE
+#endif
+
+static bool memoryEnabled;
+static size_t memoryAllocations;
+static size_t memoryAllocatedBytes;
+static long long memoryLiveBytes;
+static long long memoryPeakBytes;
+
+#ifdef MEMORY_INTERPOSE
+void* __libc_malloc(size_t size);
+void* __libc_calloc(size_t count, size_t size);
+void* __libc_realloc(void* pointer, size_t size);
+void __libc_free(void* pointer);
+
+static void record_allocation(void* pointer)
+{
+    if (!pointer)
+    {
+        return;
+    }
+
+    size_t size = malloc_usable_size(pointer);
+
+    memoryAllocations++;
+    memoryAllocatedBytes += size;
+    memoryLiveBytes += size;
+
+    if (memoryLiveBytes > memoryPeakBytes)
+    {
+        memoryPeakBytes = memoryLiveBytes;
+    }
+}
+
+void* malloc(size_t size)
+{
+    void* result = __libc_malloc(size);
+
+    if (memoryEnabled)
+    {
+        record_allocation(result);
+    }
+
+    return result;
+}
+
+void* calloc(size_t count, size_t size)
+{
+    void* result = __libc_calloc(count, size);
+
+    if (memoryEnabled)
+    {
+        record_allocation(result);
+    }
+
+    return result;
+}
+
+void* realloc(void* pointer, size_t size)
+{
+    if (!memoryEnabled)
+    {
+        return __libc_realloc(pointer, size);
+    }
+
+    size_t oldSize = 0;
+
+    if (pointer)
+    {
+        oldSize = malloc_usable_size(pointer);
+    }
+
+    void* result = __libc_realloc(pointer, size);
+
+    if (result || !size)
+    {
+        memoryLiveBytes -= oldSize;
+    }
+
+    record_allocation(result);
+
+    return result;
+}
+
+void free(void* pointer)
+{
+    if (memoryEnabled && pointer)
+    {
+        memoryLiveBytes -= malloc_usable_size(pointer);
+    }
+
+    __libc_free(pointer);
+}
+#endif
+
+void memory_statistics_begin(void)
+{
+    memoryAllocations = 0;
+    memoryAllocatedBytes = 0;
+    memoryLiveBytes = 0;
+    memoryPeakBytes = 0;
+    memoryEnabled = true;
+}
+
+static long peak_resident_bytes(void)
+{
+#if defined(__unix__) || defined(__APPLE__)
+    struct rusage usage;
+
+    if (getrusage(RUSAGE_SELF, &usage) == -1)
+    {
+        return -1;
+    }
+
+#if defined(__APPLE__)
+    return usage.ru_maxrss;
+#else
+    return usage.ru_maxrss * 1024L;
+#endif
+#else
+    return -1;
+#endif
+}
+
+bool memory_statistics_end(MemoryStatistics result)
+{
+    memoryEnabled = false;
+    result->allocations = memoryAllocations;
+    result->allocatedBytes = memoryAllocatedBytes;
+    result->peakBytes = memoryPeakBytes;
+    result->peakResidentBytes = peak_resident_bytes();
+
+#ifdef MEMORY_INTERPOSE
+    return true;
+#else
+    return false;
+#endif
+}
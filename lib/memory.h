@@ -0,0 +1,35 @@
+// Licensed under the MIT License.
+
+// Memory Statistics
+
+#ifndef MEMORY_H
+#define MEMORY_H
+#include <stdbool.h>
+#include <stddef.h>
+
+// Heap usage between a call to `memory_statistics_begin` and a call to
+// `memory_statistics_end`. Sizes are the usable sizes reported by the
+// allocator, so they include its rounding but not its bookkeeping.
+
+struct MemoryStatistics
+{
+    size_t allocations;
+    size_t allocatedBytes;
+    size_t peakBytes;
+    long peakResidentBytes;
+};
+
+typedef struct MemoryStatistics* MemoryStatistics;
+
+// Starts counting calls to `malloc`, `calloc`, and `realloc`. Counting is not
+// thread-safe, so it must only be enabled while one thread allocates.
+
+void memory_statistics_begin(void);
+
+// Stops counting and writes the statistics. Returns false if this platform
+// does not support interposing the allocator. `peakResidentBytes` is the peak
+// resident set size of the process, or -1 if it is unavailable.
+
+bool memory_statistics_end(MemoryStatistics result);
+
+#endif
@@ -0,0 +1,152 @@
+// Licensed under the MIT License.
+
+// Number
+
+#include <stdbool.h>
+#include <string.h>
+#include "number.h"
+#if defined(__GNUC__) && defined(__BYTE_ORDER__) && \
+    __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+#define NUMBER_SWAR
+#endif
+
+#ifdef NUMBER_SWAR
+static const unsigned long long NUMBER_POWERS[] =
+{
+    1, 10, 100, 1000, 10000, 100000, 1000000, 10000000, 100000000
+};
+
+// Converts eight digit values, one per byte with the most significant digit in
+// the lowest byte, into an integer.
+
+static unsigned long long eight(unsigned long long digits)
+{
+    digits = (digits * 10) + (digits >> 8);
+
+    return (((digits & 0x000000ff000000ffull) * (100 + (1000000ull << 32))) +
+        (((digits >> 16) & 0x000000ff000000ffull) * (1 + (10000ull << 32))))
+        >> 32;
+}
+#endif
+
+const char* number_parse_decimal(
+    const char* begin,
+    const char* end,
+    long long* result)
+{
+    const char* p = begin;
+    bool negative = false;
+    unsigned long long value = 0;
+
+    while (p < end && (*p == ' ' || *p == '\t'))
+    {
+        p++;
+    }
+
+    if (p < end && (*p == '-' || *p == '+'))
+    {
+        negative = *p == '-';
+        p++;
+    }
+
+    const char* digits = p;
+
+#ifdef NUMBER_SWAR
+    // Reads eight characters at a time. After the exclusive-or, a byte holds a
+    // digit if and only if it is less than 10; adding 0x76 sets the high bit
+    // of every other byte. A carry can only corrupt the bytes that follow the
+    // first non-digit, which are ignored.
+
+    while (end - p >= 8)
+    {
+        unsigned long long word;
+
+        memcpy(&word, p, sizeof word);
+
+        word ^= 0x3030303030303030ull;
+
+        unsigned long long mask = ((word + 0x7676767676767676ull) | word) &
+            0x8080808080808080ull;
+        int count = 8;
+
+        if (mask)
+        {
+            count = __builtin_ctzll(mask) >> 3;
+        }
+
+        if (!count)
+        {
+            break;
+        }
+
+        if (count < 8)
+        {
+            word <<= (8 - count) * 8;
+        }
+
+        value = (value * NUMBER_POWERS[count]) + eight(word);
+        p += count;
+
+        if (count < 8)
+        {
+            break;
+        }
+    }
+#endif
+
+    while (p < end && *p >= '0' && *p <= '9')
+    {
+        value = (value * 10) + (*p - '0');
+        p++;
+    }
+
+    if (p == digits)
+    {
+        *result = 0;
+
+        return begin;
+    }
+
+    if (negative)
+    {
+        value = -value;
+    }
+
+    *result = (long long)value;
+
+    return p;
+}
+
+const char* number_parse_hexadecimal(
+    const char* begin,
+    const char* end,
+    long long* result)
+{
+    const char* p = begin;
+    unsigned long long value = 0;
+
+    for (; p < end; p++)
+    {
+        int digit;
+        char lower = *p | 0x20;
+
+        if (*p >= '0' && *p <= '9')
+        {
+            digit = *p - '0';
+        }
+        else if (lower >= 'a' && lower <= 'f')
+        {
+            digit = lower - 'a' + 10;
+        }
+        else
+        {
+            break;
+        }
+
+        value = (value * 16) + digit;
+    }
+
+    *result = (long long)value;
+
+    return p;
+}
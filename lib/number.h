@@ -0,0 +1,28 @@
+// Licensed under the MIT License.
+
+// Number
+
+#ifndef NUMBER_H
+#define NUMBER_H
+
+// Parses an optionally signed decimal integer from the beginning of a buffer,
+// skipping leading spaces and tabs, without regard to the locale. Returns a
+// pointer past the last character consumed, which is `begin` if the buffer
+// does not begin with a number. Out-of-range values wrap.
+
+const char* number_parse_decimal(
+    const char* begin,
+    const char* end,
+    long long* result);
+
+// Parses an unsigned hexadecimal integer, in either case and without a
+// prefix, from the beginning of a buffer. Returns a pointer past the last
+// digit, which is `begin` if the buffer does not begin with a hexadecimal
+// digit.
+
+const char* number_parse_hexadecimal(
+    const char* begin,
+    const char* end,
+    long long* result);
+
+#endif
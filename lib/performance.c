@@ -0,0 +1,185 @@
+// Licensed under the MIT License.
+
+// Performance Counters
+
+#if defined(__linux__)
+#define _DEFAULT_SOURCE
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+#include <string.h>
+#include "performance.h"
+
+const char* performance_event_name(PerformanceEvent event)
+{
+    switch (event)
+    {
+        case PERFORMANCE_EVENT_CYCLES: return "cycles";
+        case PERFORMANCE_EVENT_INSTRUCTIONS: return "instructions";
+        case PERFORMANCE_EVENT_L1D_MISSES: return "l1d_misses";
+        case PERFORMANCE_EVENT_LLC_MISSES: return "llc_misses";
+        case PERFORMANCE_EVENT_BRANCH_MISSES: return "branch_misses";
+        default: return "";
+    }
+}
+
+#if defined(__linux__)
+static unsigned long long cache_miss(unsigned long long cache)
+{
+    return cache |
+        (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+        (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+}
+
+static int open_event(PerformanceEvent event)
+{
+    struct perf_event_attr attributes;
+
+    memset(&attributes, 0, sizeof attributes);
+
+    attributes.size = sizeof attributes;
+    attributes.type = PERF_TYPE_HARDWARE;
+    attributes.disabled = 1;
+    attributes.inherit = 1;
+    attributes.exclude_kernel = 1;
+    attributes.exclude_hv = 1;
+    attributes.read_format =
+        PERF_FORMAT_TOTAL_TIME_ENABLED |
+        PERF_FORMAT_TOTAL_TIME_RUNNING;
+
+    switch (event)
+    {
+        case PERFORMANCE_EVENT_CYCLES:
+            attributes.config = PERF_COUNT_HW_CPU_CYCLES;
+            break;
+
+        case PERFORMANCE_EVENT_INSTRUCTIONS:
+            attributes.config = PERF_COUNT_HW_INSTRUCTIONS;
+            break;
+
+        case PERFORMANCE_EVENT_L1D_MISSES:
+            attributes.type = PERF_TYPE_HW_CACHE;
+            attributes.config = cache_miss(PERF_COUNT_HW_CACHE_L1D);
+            break;
+
+        case PERFORMANCE_EVENT_LLC_MISSES:
+            attributes.type = PERF_TYPE_HW_CACHE;
+            attributes.config = cache_miss(PERF_COUNT_HW_CACHE_LL);
+            break;
+
+        case PERFORMANCE_EVENT_BRANCH_MISSES:
+            attributes.config = PERF_COUNT_HW_BRANCH_MISSES;
+            break;
+
+        default: return -1;
+    }
+
+    return syscall(SYS_perf_event_open, &attributes, 0, -1, -1, 0);
+}
+#endif
+
+bool performance_counters(PerformanceCounters instance)
+{
+    bool result = false;
+
+    for (PerformanceEvent event = 0; event < PERFORMANCE_EVENT_NONE; event++)
+    {
+#if defined(__linux__)
+        instance->descriptors[event] = open_event(event);
+#else
+        instance->descriptors[event] = -1;
+#endif
+
+        if (instance->descriptors[event] != -1)
+        {
+            result = true;
+        }
+    }
+
+    return result;
+}
+
+void performance_counters_start(PerformanceCounters instance)
+{
+#if defined(__linux__)
+    for (PerformanceEvent event = 0; event < PERFORMANCE_EVENT_NONE; event++)
+    {
+        int descriptor = instance->descriptors[event];
+
+        if (descriptor != -1)
+        {
+            ioctl(descriptor, PERF_EVENT_IOC_RESET, 0);
+            ioctl(descriptor, PERF_EVENT_IOC_ENABLE, 0);
+        }
+    }
+#else
+    (void)instance;
+#endif
+}
+
+void performance_counters_stop(PerformanceCounters instance)
+{
+#if defined(__linux__)
+    for (PerformanceEvent event = 0; event < PERFORMANCE_EVENT_NONE; event++)
+    {
+        int descriptor = instance->descriptors[event];
+
+        if (descriptor != -1)
+        {
+            ioctl(descriptor, PERF_EVENT_IOC_DISABLE, 0);
+        }
+    }
+#else
+    (void)instance;
+#endif
+}
+
+bool performance_counters_read(
+    PerformanceCounters instance,
+    PerformanceEvent event,
+    unsigned long long* result)
+{
+#if defined(__linux__)
+    unsigned long long values[3];
+    int descriptor = instance->descriptors[event];
+
+    if (descriptor == -1 ||
+        read(descriptor, values, sizeof values) != sizeof values ||
+        !values[2])
+    {
+        return false;
+    }
+
+    *result = values[0];
+
+    if (values[2] < values[1])
+    {
+        *result = (double)values[0] * values[1] / values[2];
+    }
+
+    return true;
+#else
+    (void)instance;
+    (void)event;
+    (void)result;
+
+    return false;
+#endif
+}
+
+void finalize_performance_counters(PerformanceCounters instance)
+{
+#if defined(__linux__)
+    for (PerformanceEvent event = 0; event < PERFORMANCE_EVENT_NONE; event++)
+    {
+        if (instance->descriptors[event] != -1)
+        {
+            close(instance->descriptors[event]);
+        }
+    }
+#else
+    (void)instance;
+#endif
+}
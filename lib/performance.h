@@ -0,0 +1,51 @@
+// Licensed under the MIT License.
+
+// Performance Counters
+
+#ifndef PERFORMANCE_H
+#define PERFORMANCE_H
+#include <stdbool.h>
+
+enum PerformanceEvent
+{
+    PERFORMANCE_EVENT_CYCLES,
+    PERFORMANCE_EVENT_INSTRUCTIONS,
+    PERFORMANCE_EVENT_L1D_MISSES,
+    PERFORMANCE_EVENT_LLC_MISSES,
+    PERFORMANCE_EVENT_BRANCH_MISSES,
+    PERFORMANCE_EVENT_NONE
+};
+
+// Hardware performance counters for the calling thread and the threads it
+// creates, measured in user mode. On Linux, each event is opened with
+// `perf_event_open`; elsewhere, no events are available.
+
+struct PerformanceCounters
+{
+    int descriptors[PERFORMANCE_EVENT_NONE];
+};
+
+typedef enum PerformanceEvent PerformanceEvent;
+typedef struct PerformanceCounters* PerformanceCounters;
+
+const char* performance_event_name(PerformanceEvent event);
+
+// Opens a counter for each event, leaving it stopped. Returns false if no
+// event is available, for example because the kernel forbids access.
+
+bool performance_counters(PerformanceCounters instance);
+void performance_counters_start(PerformanceCounters instance);
+void performance_counters_stop(PerformanceCounters instance);
+
+// Reads the value of an event, scaled to account for time during which the
+// kernel multiplexed the counter out. Returns false if the event is
+// unavailable.
+
+bool performance_counters_read(
+    PerformanceCounters instance,
+    PerformanceEvent event,
+    unsigned long long* result);
+
+void finalize_performance_counters(PerformanceCounters instance);
+
+#endif
@@ -0,0 +1,187 @@
+// Licensed under the MIT License.
+
+// Queue
+
+#include <stdlib.h>
+#include <string.h>
+#include "queue.h"
+#define QUEUE_INITIAL_CAPACITY 64
+
+void queue(Queue instance, size_t itemSize)
+{
+    instance->items = NULL;
+    instance->itemSize = itemSize;
+    instance->capacity = 0;
+    instance->first = 0;
+    instance->count = 0;
+}
+
+// Copies `count` items starting at the position `index`, which may wrap
+// around the end of the buffer, to or from a contiguous array.
+
+static void copy_out(Queue instance, size_t index, char* result, size_t count)
+{
+    size_t head = instance->capacity - index;
+
+    if (head > count)
+    {
+        head = count;
+    }
+
+    memcpy(
+        result,
+        instance->items + index * instance->itemSize,
+        head * instance->itemSize);
+    memcpy(
+        result + head * instance->itemSize,
+        instance->items,
+        (count - head) * instance->itemSize);
+}
+
+static void copy_in(
+    Queue instance,
+    size_t index,
+    const char* items,
+    size_t count)
+{
+    size_t head = instance->capacity - index;
+
+    if (head > count)
+    {
+        head = count;
+    }
+
+    memcpy(
+        instance->items + index * instance->itemSize,
+        items,
+        head * instance->itemSize);
+    memcpy(
+        instance->items,
+        items + head * instance->itemSize,
+        (count - head) * instance->itemSize);
+}
+
+static bool queue_grow(Queue instance, size_t capacity)
+{
+    size_t newCapacity = instance->capacity * 2;
+
+    if (!newCapacity)
+    {
+        newCapacity = QUEUE_INITIAL_CAPACITY;
+    }
+
+    while (newCapacity < capacity)
+    {
+        newCapacity *= 2;
+    }
+
+    char* newItems = malloc(newCapacity * instance->itemSize);
+
+    if (!newItems)
+    {
+        return false;
+    }
+
+    if (instance->count)
+    {
+        copy_out(instance, instance->first, newItems, instance->count);
+    }
+
+    free(instance->items);
+
+    instance->items = newItems;
+    instance->capacity = newCapacity;
+    instance->first = 0;
+
+    return true;
+}
+
+bool queue_reserve(Queue instance, size_t capacity)
+{
+    return capacity <= instance->capacity || queue_grow(instance, capacity);
+}
+
+void* queue_enqueue(Queue instance)
+{
+    if (instance->count == instance->capacity &&
+        !queue_grow(instance, instance->count + 1))
+    {
+        return NULL;
+    }
+
+    size_t last = (instance->first + instance->count) &
+        (instance->capacity - 1);
+
+    instance->count++;
+
+    return instance->items + last * instance->itemSize;
+}
+
+bool queue_enqueue_many(Queue instance, const void* items, size_t count)
+{
+    if (instance->count + count > instance->capacity &&
+        !queue_grow(instance, instance->count + count))
+    {
+        return false;
+    }
+
+    if (!count)
+    {
+        return true;
+    }
+
+    size_t last = (instance->first + instance->count) &
+        (instance->capacity - 1);
+
+    copy_in(instance, last, items, count);
+
+    instance->count += count;
+
+    return true;
+}
+
+void* queue_dequeue(Queue instance)
+{
+    if (!instance->count)
+    {
+        return NULL;
+    }
+
+    char* result = instance->items + instance->first * instance->itemSize;
+
+    instance->first = (instance->first + 1) & (instance->capacity - 1);
+    instance->count--;
+
+    return result;
+}
+
+size_t queue_dequeue_many(Queue instance, void* result, size_t count)
+{
+    if (count > instance->count)
+    {
+        count = instance->count;
+    }
+
+    if (!count)
+    {
+        return 0;
+    }
+
+    copy_out(instance, instance->first, result, count);
+
+    instance->first = (instance->first + count) & (instance->capacity - 1);
+    instance->count -= count;
+
+    return count;
+}
+
+void queue_clear(Queue instance)
+{
+    instance->first = 0;
+    instance->count = 0;
+}
+
+void finalize_queue(Queue instance)
+{
+    free(instance->items);
+}
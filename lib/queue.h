@@ -0,0 +1,58 @@
+// Licensed under the MIT License.
+
+// Queue
+
+#ifndef QUEUE_H
+#define QUEUE_H
+#include <stdbool.h>
+#include <stddef.h>
+
+// A first-in, first-out queue of fixed-size items in a ring buffer. The
+// capacity is always a power of two, so positions wrap around with a mask
+// rather than a branch, and the buffer doubles when it is full.
+
+struct Queue
+{
+    char* items;
+    size_t itemSize;
+    size_t capacity;
+    size_t first;
+    size_t count;
+};
+
+typedef struct Queue* Queue;
+
+// Initializes an empty queue. The buffer is allocated lazily.
+
+void queue(Queue instance, size_t itemSize);
+
+// Ensures that the queue can hold `capacity` items without allocating.
+// Returns false if memory is exhausted.
+
+bool queue_reserve(Queue instance, size_t capacity);
+
+// Adds an item to the back of the queue and returns a pointer to it, so that
+// the caller can initialize it in place. Returns NULL if memory is exhausted.
+
+void* queue_enqueue(Queue instance);
+
+// Copies `count` contiguous items to the back of the queue. Returns false if
+// memory is exhausted, leaving the queue unchanged.
+
+bool queue_enqueue_many(Queue instance, const void* items, size_t count);
+
+// Removes the item at the front of the queue and returns a pointer to it, or
+// NULL if the queue is empty. The pointer is invalidated by the next call that
+// adds an item.
+
+void* queue_dequeue(Queue instance);
+
+// Removes up to `count` items from the front of the queue and copies them to
+// `result`. Returns the number of items removed.
+
+size_t queue_dequeue_many(Queue instance, void* result, size_t count);
+
+void queue_clear(Queue instance);
+void finalize_queue(Queue instance);
+
+#endif
@@ -0,0 +1,229 @@
+// Licensed under the MIT License.
+
+// Shard
+
+#if defined(__unix__) || defined(__APPLE__)
+#define _POSIX_C_SOURCE 200809L
+#include <pthread.h>
+#include <unistd.h>
+#define SHARD_THREADS
+#endif
+#include <stdlib.h>
+#include <string.h>
+#include "shard.h"
+#define SHARD_MINIMUM_LENGTH 65536
+
+struct ShardTask
+{
+    const char* input;
+    size_t length;
+    ShardSolver solver;
+    void* context;
+    Exception exception;
+    long long result;
+};
+
+typedef struct ShardTask* ShardTask;
+
+static void* run(void* argument)
+{
+    ShardTask task = argument;
+
+    task->exception = task->solver(
+        task->input,
+        task->length,
+        task->context,
+        &task->result);
+
+    return NULL;
+}
+
+static int processor_count(void)
+{
+#ifdef SHARD_THREADS
+    long result = sysconf(_SC_NPROCESSORS_ONLN);
+
+    if (result > 0)
+    {
+        return result;
+    }
+#endif
+
+    return 1;
+}
+
+// Returns the beginning of the first part that starts at or after `p`.
+
+static const char* boundary(const char* p, const char* end, Shard shard)
+{
+    while (p < end)
+    {
+        const char* lineFeed = memchr(p, '\n', end - p);
+
+        if (!lineFeed)
+        {
+            return end;
+        }
+
+        p = lineFeed + 1;
+
+        if (shard == SHARD_LINE)
+        {
+            return p;
+        }
+
+        if (p < end && *p == '\n')
+        {
+            return p + 1;
+        }
+    }
+
+    return end;
+}
+
+static Exception solve_part(
+    const char* input,
+    size_t length,
+    void* context,
+    long long* result)
+{
+    Solver* solver = context;
+
+    return (*solver)(input, length, result);
+}
+
+Exception shard_solve(
+    const char* input,
+    size_t length,
+    Solver solver,
+    Shard shard,
+    int threads,
+    long long* result)
+{
+    return shard_solve_context(
+        input,
+        length,
+        solve_part,
+        &solver,
+        shard,
+        threads,
+        result);
+}
+
+Exception shard_solve_context(
+    const char* input,
+    size_t length,
+    ShardSolver solver,
+    void* context,
+    Shard shard,
+    int threads,
+    long long* result)
+{
+    int processors = processor_count();
+
+    if (threads > processors)
+    {
+        threads = processors;
+    }
+
+    if (threads < 1)
+    {
+        threads = 1;
+    }
+
+    if ((size_t)threads > length / SHARD_MINIMUM_LENGTH)
+    {
+        threads = length / SHARD_MINIMUM_LENGTH;
+    }
+
+    if (shard == SHARD_NONE || threads < 2)
+    {
+        return solver(input, length, context, result);
+    }
+
+    ShardTask tasks = calloc(threads, sizeof * tasks);
+
+    if (!tasks)
+    {
+        return EXCEPTION_OUT_OF_MEMORY;
+    }
+
+    int count = 0;
+    const char* end = input + length;
+    const char* begin = input;
+
+    for (int i = 1; i <= threads && begin < end; i++)
+    {
+        const char* next = end;
+
+        if (i < threads)
+        {
+            next = boundary(input + length / threads * i, end, shard);
+        }
+
+        if (next <= begin)
+        {
+            continue;
+        }
+
+        tasks[count].input = begin;
+        tasks[count].length = next - begin;
+        tasks[count].solver = solver;
+        tasks[count].context = context;
+        tasks[count].exception = EXCEPTION_NONE;
+        tasks[count].result = 0;
+        count++;
+        begin = next;
+    }
+
+#ifdef SHARD_THREADS
+    int started = 0;
+    pthread_t* workers = malloc(count * sizeof * workers);
+
+    if (workers)
+    {
+        while (started < count - 1 &&
+            !pthread_create(workers + started, NULL, run, tasks + started + 1))
+        {
+            started++;
+        }
+    }
+
+    for (int i = started + 1; i < count; i++)
+    {
+        run(tasks + i);
+    }
+
+    run(tasks);
+
+    for (int i = 0; i < started; i++)
+    {
+        pthread_join(workers[i], NULL);
+    }
+
+    free(workers);
+#else
+    for (int i = 0; i < count; i++)
+    {
+        run(tasks + i);
+    }
+#endif
+
+    Exception exception = EXCEPTION_NONE;
+
+    *result = 0;
+
+    for (int i = 0; i < count; i++)
+    {
+        if (tasks[i].exception && !exception)
+        {
+            exception = tasks[i].exception;
+        }
+
+        *result += tasks[i].result;
+    }
+
+    free(tasks);
+
+    return exception;
+}
@@ -0,0 +1,44 @@
+// Licensed under the MIT License.
+
+// Shard
+
+#ifndef SHARD_H
+#define SHARD_H
+#include "solver.h"
+
+// Splits the input into at most `threads` parts of roughly equal length at
+// line boundaries (`SHARD_LINE`) or blank-line boundaries (`SHARD_BLOCK`),
+// solves each part on its own thread, and sums the results. The number of
+// threads is at least one and at most the number of online processors. Inputs
+// too short to be worth splitting are solved on the calling thread.
+
+Exception shard_solve(
+    const char* input,
+    size_t length,
+    Solver solver,
+    Shard shard,
+    int threads,
+    long long* result);
+
+// Solves a part of the input given the `context` shared by every part. The
+// context must not be modified while the parts are solved.
+
+typedef Exception (*ShardSolver)(
+    const char* input,
+    size_t length,
+    void* context,
+    long long* result);
+
+// Equivalent to `shard_solve`, but passes `context` to each part, so that a
+// solver can parse a shared header once and split only the rest of its input.
+
+Exception shard_solve_context(
+    const char* input,
+    size_t length,
+    ShardSolver solver,
+    void* context,
+    Shard shard,
+    int threads,
+    long long* result);
+
+#endif
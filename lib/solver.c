@@ -0,0 +1,483 @@
+// Licensed under the MIT License.
+
+// Solver
+
+#if defined(__unix__) || defined(__APPLE__)
+#define _POSIX_C_SOURCE 200809L
+#define SOLVER_MONOTONIC
+#endif
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "input.h"
+#include "memory.h"
+#include "performance.h"
+#include "shard.h"
+#include "solver.h"
+#include "stream.h"
+#include "trace.h"
+#include "workspace.h"
+#define SOLVER_PHASES_CAPACITY 16
+#define SOLVER_WORK_CAPACITY 16
+
+struct SolverPhase
+{
+    const char* name;
+    clock_t elapsed;
+};
+
+struct SolverWork
+{
+    const char* name;
+    long long amount;
+};
+
+static bool solverPhasesEnabled;
+static int solverPhaseCount;
+static int solverPhaseCurrent = -1;
+static clock_t solverPhaseStart;
+static struct SolverPhase solverPhases[SOLVER_PHASES_CAPACITY];
+static bool solverTraceEnabled;
+static const char* solverTracePhase;
+static int solverThreads = 1;
+static bool solverWorkEnabled;
+static int solverWorkCount;
+static struct SolverWork solverWork[SOLVER_WORK_CAPACITY];
+
+const char* exception_message(Exception exception)
+{
+    switch (exception)
+    {
+        case EXCEPTION_NONE: return "";
+        case EXCEPTION_FORMAT: return "Error: Format.\n";
+        case EXCEPTION_KEY_NOT_FOUND: return "Error: Key not found.\n";
+        case EXCEPTION_OUT_OF_MEMORY: return "Error: Out of memory.\n";
+        case EXCEPTION_IO: return "Error: Input/output.\n";
+    }
+
+    return "Error.\n";
+}
+
+static void end_phase(void)
+{
+    clock_t now = clock();
+
+    if (solverPhaseCurrent != -1)
+    {
+        solverPhases[solverPhaseCurrent].elapsed += now - solverPhaseStart;
+    }
+
+    solverPhaseCurrent = -1;
+    solverPhaseStart = now;
+}
+
+static void end_trace(void)
+{
+    if (!solverTraceEnabled)
+    {
+        return;
+    }
+
+    if (solverTracePhase)
+    {
+        trace_end(solverTracePhase);
+    }
+
+    solverTracePhase = NULL;
+    solverTraceEnabled = false;
+
+    trace_close();
+}
+
+// Only `solver_main` enables tracing and phases, so solvers that run
+// concurrently under another driver never write the shared state below.
+
+void solver_phase(const char* name)
+{
+    if (solverTraceEnabled)
+    {
+        if (solverTracePhase)
+        {
+            trace_end(solverTracePhase);
+        }
+
+        solverTracePhase = name;
+
+        trace_begin(name);
+    }
+
+    if (!solverPhasesEnabled)
+    {
+        return;
+    }
+
+    end_phase();
+
+    for (int i = 0; i < solverPhaseCount; i++)
+    {
+        if (strcmp(solverPhases[i].name, name) == 0)
+        {
+            solverPhaseCurrent = i;
+
+            return;
+        }
+    }
+
+    if (solverPhaseCount == SOLVER_PHASES_CAPACITY)
+    {
+        return;
+    }
+
+    solverPhaseCurrent = solverPhaseCount;
+    solverPhases[solverPhaseCount].name = name;
+    solverPhases[solverPhaseCount].elapsed = 0;
+    solverPhaseCount++;
+}
+
+void solver_work(const char* name, long long amount)
+{
+    if (!solverWorkEnabled)
+    {
+        return;
+    }
+
+    for (int i = 0; i < solverWorkCount; i++)
+    {
+        if (strcmp(solverWork[i].name, name) == 0)
+        {
+            solverWork[i].amount += amount;
+
+            return;
+        }
+    }
+
+    if (solverWorkCount == SOLVER_WORK_CAPACITY)
+    {
+        return;
+    }
+
+    solverWork[solverWorkCount].name = name;
+    solverWork[solverWorkCount].amount = amount;
+    solverWorkCount++;
+}
+
+static void print_phases(const char* name)
+{
+    for (int i = 0; i < solverPhaseCount; i++)
+    {
+        fprintf(stderr, "%s,%s,%lf\n", name, solverPhases[i].name,
+            (double)solverPhases[i].elapsed / CLOCKS_PER_SEC);
+    }
+}
+
+static void print_work(const char* name)
+{
+    for (int i = 0; i < solverWorkCount; i++)
+    {
+        fprintf(stderr, "%s,%s,%lld\n", name, solverWork[i].name,
+            solverWork[i].amount);
+    }
+}
+
+static void print_counters(const char* name, PerformanceCounters counters)
+{
+    for (PerformanceEvent event = 0; event < PERFORMANCE_EVENT_NONE; event++)
+    {
+        unsigned long long value;
+
+        if (performance_counters_read(counters, event, &value))
+        {
+            fprintf(stderr, "%s,%s,%llu\n", name,
+                performance_event_name(event), value);
+        }
+    }
+}
+
+static void print_memory(const char* name, MemoryStatistics statistics)
+{
+    fprintf(stderr, "%s,allocations,%zu\n", name, statistics->allocations);
+    fprintf(stderr, "%s,allocated_bytes,%zu\n", name,
+        statistics->allocatedBytes);
+    fprintf(stderr, "%s,peak_bytes,%zu\n", name, statistics->peakBytes);
+
+    if (statistics->peakResidentBytes != -1)
+    {
+        fprintf(stderr, "%s,peak_resident_bytes,%ld\n", name,
+            statistics->peakResidentBytes);
+    }
+}
+
+// Returns the processor time of the process in seconds or, if the solver may
+// run on more than one thread, the monotonic wall-clock time.
+
+static double solver_time(int threads)
+{
+#ifdef SOLVER_MONOTONIC
+    struct timespec now;
+
+    if (threads > 1 && !clock_gettime(CLOCK_MONOTONIC, &now))
+    {
+        return now.tv_sec + now.tv_nsec / 1e9;
+    }
+#else
+    (void)threads;
+#endif
+
+    return (double)clock() / CLOCKS_PER_SEC;
+}
+
+int solver_threads(void)
+{
+    return solverThreads;
+}
+
+static int threads_from_environment(void)
+{
+    const char* value = getenv(SOLVER_THREADS_VARIABLE);
+
+    if (!value)
+    {
+        return 1;
+    }
+
+    int result = atoi(value);
+
+    if (result < 1)
+    {
+        return 1;
+    }
+
+    return result;
+}
+
+// Solves each input listed on the standard input stream, one path per line,
+// and prints one result per input. The workspaces of the calling thread are
+// kept until every input is solved, so each solver resets the structures of
+// the previous input rather than allocating them again.
+
+static int solve_batch(const char* name, Solver solver, Shard shard)
+{
+    struct Input manifest;
+    Exception exception = input_read(&manifest, stdin);
+
+    if (exception)
+    {
+        fprintf(stderr, "%s", exception_message(exception));
+
+        return 1;
+    }
+
+    long count;
+    char* path = NULL;
+    size_t capacity = 0;
+    int status = 0;
+    int threads = threads_from_environment();
+    struct Stream reader;
+
+    solverThreads = threads;
+
+    stream(&reader, manifest.buffer, manifest.length);
+
+    while ((count = stream_read_line(&reader, &path, &capacity)) > 0)
+    {
+        if (path[count - 1] == '\n')
+        {
+            path[count - 1] = '\0';
+        }
+
+        if (!path[0])
+        {
+            continue;
+        }
+
+        long long result;
+        struct Input input;
+        double start = solver_time(threads);
+
+        exception = input_open(&input, path);
+
+        if (!exception)
+        {
+            exception = shard_solve(
+                input.buffer,
+                input.length,
+                solver,
+                shard,
+                threads,
+                &result);
+
+            finalize_input(&input);
+        }
+
+        if (exception)
+        {
+            fprintf(stderr, "%s: %s", path, exception_message(exception));
+
+            status = 1;
+
+            continue;
+        }
+
+        printf("%s %lld %lf %s\n", name, result,
+            solver_time(threads) - start, path);
+    }
+
+    free(path);
+    finalize_input(&manifest);
+    workspace_release();
+
+    if (count < 0)
+    {
+        fprintf(stderr, "%s", exception_message(EXCEPTION_OUT_OF_MEMORY));
+
+        return 1;
+    }
+
+    return status;
+}
+
+int solver_main(const char* name, Solver solver)
+{
+    return solver_main_sharded(name, solver, SHARD_NONE);
+}
+
+int solver_main_sharded(const char* name, Solver solver, Shard shard)
+{
+    if (getenv(SOLVER_BATCH_VARIABLE))
+    {
+        return solve_batch(name, solver, shard);
+    }
+
+    long long result;
+    struct Input input;
+    int threads = 1;
+    bool memoryEnabled = getenv(SOLVER_MEMORY_VARIABLE) != NULL;
+
+    solverPhasesEnabled = getenv(SOLVER_PHASES_VARIABLE) != NULL;
+    solverWorkEnabled = getenv(SOLVER_WORK_VARIABLE) != NULL;
+
+    if (!memoryEnabled && !solverWorkEnabled)
+    {
+        threads = threads_from_environment();
+    }
+
+    solverThreads = threads;
+
+    double start = solver_time(threads);
+
+    const char* tracePath = getenv(SOLVER_TRACE_VARIABLE);
+
+    if (tracePath)
+    {
+        solverTraceEnabled = trace_open(tracePath);
+
+        if (!solverTraceEnabled)
+        {
+            fprintf(stderr, "Warning: Trace unavailable.\n");
+        }
+    }
+
+    if (memoryEnabled)
+    {
+        memory_statistics_begin();
+    }
+
+    solver_phase("read");
+
+    Exception exception = input_read(&input, stdin);
+
+    if (exception)
+    {
+        end_trace();
+        fprintf(stderr, "%s", exception_message(exception));
+
+        return 1;
+    }
+
+    bool countersEnabled = false;
+    struct PerformanceCounters counters;
+
+    if (getenv(SOLVER_COUNTERS_VARIABLE))
+    {
+        countersEnabled = performance_counters(&counters);
+
+        if (!countersEnabled)
+        {
+            fprintf(stderr, "Warning: Performance counters unavailable.\n");
+        }
+    }
+
+    solver_phase("parse");
+
+    if (countersEnabled)
+    {
+        performance_counters_start(&counters);
+    }
+
+    exception = shard_solve(
+        input.buffer,
+        input.length,
+        solver,
+        shard,
+        threads,
+        &result);
+
+    if (countersEnabled)
+    {
+        performance_counters_stop(&counters);
+    }
+
+    solver_phase("finalize");
+    finalize_input(&input);
+    workspace_release();
+    end_trace();
+
+    struct MemoryStatistics memory;
+
+    if (memoryEnabled && !memory_statistics_end(&memory))
+    {
+        fprintf(stderr, "Warning: Memory statistics unavailable.\n");
+
+        memoryEnabled = false;
+    }
+
+    if (exception)
+    {
+        if (countersEnabled)
+        {
+            finalize_performance_counters(&counters);
+        }
+
+        fprintf(stderr, "%s", exception_message(exception));
+
+        return 1;
+    }
+
+    printf("%s %lld %lf\n", name, result, solver_time(threads) - start);
+
+    if (solverPhasesEnabled)
+    {
+        end_phase();
+        print_phases(name);
+    }
+
+    if (solverWorkEnabled)
+    {
+        print_work(name);
+    }
+
+    if (memoryEnabled)
+    {
+        print_memory(name, &memory);
+    }
+
+    if (countersEnabled)
+    {
+        print_counters(name, &counters);
+        finalize_performance_counters(&counters);
+    }
+
+    return 0;
+}
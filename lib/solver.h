@@ -0,0 +1,101 @@
+// Licensed under the MIT License.
+
+// Solver
+
+#ifndef SOLVER_H
+#define SOLVER_H
+#include <stddef.h>
+#define SOLVER_BATCH_VARIABLE "SOLVER_BATCH"
+#define SOLVER_CACHE_VARIABLE "SOLVER_CACHE"
+#define SOLVER_COUNTERS_VARIABLE "SOLVER_COUNTERS"
+#define SOLVER_MEMORY_VARIABLE "SOLVER_MEMORY"
+#define SOLVER_PHASES_VARIABLE "SOLVER_PHASES"
+#define SOLVER_THREADS_VARIABLE "SOLVER_THREADS"
+#define SOLVER_TRACE_VARIABLE "SOLVER_TRACE"
+#define SOLVER_WORK_VARIABLE "SOLVER_WORK"
+
+enum Exception
+{
+    EXCEPTION_NONE,
+    EXCEPTION_FORMAT,
+    EXCEPTION_KEY_NOT_FOUND,
+    EXCEPTION_OUT_OF_MEMORY,
+    EXCEPTION_IO
+};
+
+// How an input may be split so that the result of a solver is the sum of its
+// results on each part.
+
+enum Shard
+{
+    SHARD_NONE,
+    SHARD_LINE,
+    SHARD_BLOCK
+};
+
+typedef enum Exception Exception;
+typedef enum Shard Shard;
+
+// The input is not null-terminated and may be a read-only memory mapping.
+
+typedef Exception (*Solver)(
+    const char* input,
+    size_t length,
+    long long* result);
+
+// Returns the message printed when a solver fails with `exception`, ending in
+// a line feed, or an empty string for `EXCEPTION_NONE`.
+
+const char* exception_message(Exception exception);
+
+// Reads the standard input stream, solves it, and prints the result. If the
+// environment variable named by `SOLVER_COUNTERS_VARIABLE` is set, hardware
+// performance counters are measured around the solver and written to the
+// standard error stream as comma-separated records of the form
+// `name,event,value`. Likewise, if the variable named by
+// `SOLVER_MEMORY_VARIABLE` is set, heap usage and the peak resident set size
+// of the run are written as records of the form `name,statistic,value`. If
+// the variable named by `SOLVER_BATCH_VARIABLE` is set, the standard input
+// stream is instead read as a list of paths, one per line; each file is
+// solved in turn and its result is printed with its path, without
+// instrumentation.
+
+int solver_main(const char* name, Solver solver);
+
+// Equivalent to `solver_main`, but if the environment variable named by
+// `SOLVER_THREADS_VARIABLE` is set to a number of threads, the input is split
+// as described by `shard` and the parts are solved concurrently. When more
+// than one thread is allowed, the printed time is elapsed wall-clock time
+// rather than processor time, which sums over every thread.
+
+int solver_main_sharded(const char* name, Solver solver, Shard shard);
+
+// Returns the number of threads that `solver_main` allows the current solver to
+// use: the value of `SOLVER_THREADS_VARIABLE`, or 1 if it is not set or if work
+// or memory is measured. A solver that must parse part of its input before the
+// rest can be split passes this number to `shard_solve_context`.
+
+int solver_threads(void);
+
+// Ends the current phase and begins the named phase. Phases with the same name
+// are accumulated. `solver_main` begins the "read" phase before reading the
+// input and the "parse" phase before calling the solver. If the environment
+// variable named by `SOLVER_PHASES_VARIABLE` is set, the time spent in each
+// phase is written to the standard error stream as comma-separated records of
+// the form `name,phase,seconds`. If the support library is built with tracing
+// and the variable named by `SOLVER_TRACE_VARIABLE` is set to a path, each
+// phase is also written to that file as a span on a timeline.
+
+void solver_phase(const char* name);
+
+// Adds `amount` to the named work counter, such as the number of items a
+// search visits. Counters with the same name are accumulated, so a solver can
+// tally work in local variables and report it once. If the environment
+// variable named by `SOLVER_WORK_VARIABLE` is set, each counter is written to
+// the standard error stream as a comma-separated record of the form
+// `name,counter,value`, and the input is not split across threads; otherwise,
+// this function does nothing.
+
+void solver_work(const char* name, long long amount);
+
+#endif
@@ -0,0 +1,158 @@
+// Licensed under the MIT License.
+
+// Stream
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "number.h"
+#include "stream.h"
+
+void stream(Stream instance, const char* input, size_t length)
+{
+    instance->current = input;
+    instance->end = input + length;
+}
+
+int stream_get_char(Stream instance)
+{
+    if (instance->current >= instance->end)
+    {
+        return EOF;
+    }
+
+    unsigned char result = *instance->current;
+
+    instance->current++;
+
+    return result;
+}
+
+long stream_read_line(Stream instance, char** buffer, size_t* capacity)
+{
+    struct StringView line;
+
+    if (!stream_next_line(instance, &line))
+    {
+        return 0;
+    }
+
+    size_t length = line.end - line.begin;
+
+    if (instance->current > line.end)
+    {
+        length++;
+    }
+
+    if (length + 1 > *capacity)
+    {
+        size_t newCapacity = *capacity;
+
+        if (newCapacity < 16)
+        {
+            newCapacity = 16;
+        }
+
+        while (newCapacity < length + 1)
+        {
+            newCapacity *= 2;
+        }
+
+        char* newBuffer = realloc(*buffer, newCapacity);
+
+        if (!newBuffer)
+        {
+            return -1;
+        }
+
+        *buffer = newBuffer;
+        *capacity = newCapacity;
+    }
+
+    memcpy(*buffer, line.begin, length);
+
+    (*buffer)[length] = '\0';
+
+    return length;
+}
+
+bool stream_next_line(Stream instance, StringView result)
+{
+    const char* begin = instance->current;
+
+    if (begin >= instance->end)
+    {
+        return false;
+    }
+
+    const char* newline = memchr(begin, '\n', instance->end - begin);
+
+    result->begin = begin;
+
+    if (newline)
+    {
+        result->end = newline;
+        instance->current = newline + 1;
+    }
+    else
+    {
+        result->end = instance->end;
+        instance->current = instance->end;
+    }
+
+    return true;
+}
+
+static bool string_view_is_delimiter(char value, const char* delimiters)
+{
+    return value && strchr(delimiters, value);
+}
+
+bool string_view_next_token(
+    StringView instance,
+    const char* delimiters,
+    StringView result)
+{
+    const char* p = instance->begin;
+
+    while (p < instance->end && string_view_is_delimiter(*p, delimiters))
+    {
+        p++;
+    }
+
+    if (p == instance->end)
+    {
+        instance->begin = p;
+
+        return false;
+    }
+
+    result->begin = p;
+
+    while (p < instance->end && !string_view_is_delimiter(*p, delimiters))
+    {
+        p++;
+    }
+
+    result->end = p;
+    instance->begin = p;
+
+    return true;
+}
+
+bool string_view_equals(StringView instance, const char* value)
+{
+    size_t length = strlen(value);
+
+    return (size_t)(instance->end - instance->begin) == length &&
+        memcmp(instance->begin, value, length) == 0;
+}
+
+long long string_view_to_long(StringView instance)
+{
+    long long result;
+
+    number_parse_decimal(instance->begin, instance->end, &result);
+
+    return result;
+}
@@ -0,0 +1,47 @@
+// Licensed under the MIT License.
+
+// Stream
+
+#ifndef STREAM_H
+#define STREAM_H
+#include <stdbool.h>
+#include <stddef.h>
+
+struct Stream
+{
+    const char* current;
+    const char* end;
+};
+
+struct StringView
+{
+    const char* begin;
+    const char* end;
+};
+
+typedef struct Stream* Stream;
+typedef struct StringView* StringView;
+
+void stream(Stream instance, const char* input, size_t length);
+
+// Equivalent to `getc`, but reads from an in-memory buffer.
+
+int stream_get_char(Stream instance);
+
+// Equivalent to POSIX `getline`. The buffer grows as needed. Returns the length
+// of the line, 0 at the end of the stream, or -1 if memory is exhausted.
+
+long stream_read_line(Stream instance, char** buffer, size_t* capacity);
+
+// Points the view at the next line without copying it. The view excludes the
+// line feed.
+
+bool stream_next_line(Stream instance, StringView result);
+bool string_view_next_token(
+    StringView instance,
+    const char* delimiters,
+    StringView result);
+bool string_view_equals(StringView instance, const char* value);
+long long string_view_to_long(StringView instance);
+
+#endif
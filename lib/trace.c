@@ -0,0 +1,96 @@
+// Licensed under the MIT License.
+
+// Trace
+
+#if defined(__unix__) || defined(__APPLE__)
+#define _POSIX_C_SOURCE 200809L
+#endif
+#include <stdio.h>
+#include <time.h>
+#include "trace.h"
+
+#ifdef TRACE_ENABLED
+static FILE* traceStream;
+static double traceStart;
+static const char* traceSeparator;
+
+// Returns the time in microseconds, the unit of the trace-event format.
+
+static double now(void)
+{
+#if defined(__unix__) || defined(__APPLE__)
+    struct timespec value;
+
+    if (clock_gettime(CLOCK_MONOTONIC, &value) == -1)
+    {
+        return 0;
+    }
+
+    return value.tv_sec * 1e6 + value.tv_nsec / 1e3;
+#else
+    return (double)clock() * 1e6 / CLOCKS_PER_SEC;
+#endif
+}
+
+static void write_event(const char* name, char phase)
+{
+    if (!traceStream)
+    {
+        return;
+    }
+
+    fprintf(traceStream,
+        "%s{\"name\":\"%s\",\"ph\":\"%c\",\"ts\":%.3lf,\"pid\":1,\"tid\":1}",
+        traceSeparator, name, phase, now() - traceStart);
+
+    traceSeparator = ",\n";
+}
+
+void trace_begin(const char* name)
+{
+    write_event(name, 'B');
+}
+
+void trace_end(const char* name)
+{
+    write_event(name, 'E');
+}
+#endif
+
+bool trace_open(const char* path)
+{
+#ifdef TRACE_ENABLED
+    traceStream = fopen(path, "w");
+
+    if (!traceStream)
+    {
+        return false;
+    }
+
+    fprintf(traceStream, "[\n");
+
+    traceStart = now();
+    traceSeparator = "";
+
+    return true;
+#else
+    (void)path;
+
+    return false;
+#endif
+}
+
+void trace_close(void)
+{
+#ifdef TRACE_ENABLED
+    if (!traceStream)
+    {
+        return;
+    }
+
+    fprintf(traceStream, "\n]\n");
+    fclose(traceStream);
+
+    traceStream = NULL;
+#endif
+}
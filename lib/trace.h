@@ -0,0 +1,37 @@
+// Licensed under the MIT License.
+
+// Trace
+
+#ifndef TRACE_H
+#define TRACE_H
+#include <stdbool.h>
+
+// Writes spans to a file in the Chrome trace-event format, which Perfetto and
+// `chrome://tracing` display as a timeline. Tracing is compiled in only if
+// `TRACE_ENABLED` is defined; otherwise, `trace_begin` and `trace_end` are
+// empty inline functions and cost nothing. Spans must be recorded from one
+// thread and nest properly.
+
+// Creates the trace file. Returns false if tracing is compiled out or the file
+// cannot be created.
+
+bool trace_open(const char* path);
+
+#ifdef TRACE_ENABLED
+void trace_begin(const char* name);
+void trace_end(const char* name);
+#else
+static inline void trace_begin(const char* name)
+{
+    (void)name;
+}
+
+static inline void trace_end(const char* name)
+{
+    (void)name;
+}
+#endif
+
+void trace_close(void);
+
+#endif
@@ -0,0 +1,144 @@
+// Licensed under the MIT License.
+
+// Workspace
+
+#if defined(__unix__) || defined(__APPLE__)
+#define _POSIX_C_SOURCE 200809L
+#include <pthread.h>
+#define WORKSPACE_THREADS
+#endif
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+#include "workspace.h"
+
+// The workspaces of a thread, in a list whose head is thread-specific data so
+// that concurrent solvers never share one.
+
+struct WorkspaceEntry
+{
+    struct WorkspaceEntry* next;
+    const char* name;
+    WorkspaceAction finalize;
+    void* data;
+};
+
+typedef struct WorkspaceEntry* WorkspaceEntry;
+
+#ifdef WORKSPACE_THREADS
+static bool workspaceKeyCreated;
+static pthread_key_t workspaceKey;
+static pthread_once_t workspaceOnce = PTHREAD_ONCE_INIT;
+#else
+static WorkspaceEntry workspaceFirst;
+#endif
+
+static void release(void* first)
+{
+    WorkspaceEntry entry = first;
+
+    while (entry)
+    {
+        WorkspaceEntry next = entry->next;
+
+        entry->finalize(entry->data);
+        free(entry->data);
+        free(entry);
+
+        entry = next;
+    }
+}
+
+#ifdef WORKSPACE_THREADS
+static void create_key(void)
+{
+    workspaceKeyCreated = !pthread_key_create(&workspaceKey, release);
+}
+#endif
+
+static WorkspaceEntry get_first(void)
+{
+#ifdef WORKSPACE_THREADS
+    pthread_once(&workspaceOnce, create_key);
+
+    if (!workspaceKeyCreated)
+    {
+        return NULL;
+    }
+
+    return pthread_getspecific(workspaceKey);
+#else
+    return workspaceFirst;
+#endif
+}
+
+static bool set_first(WorkspaceEntry value)
+{
+#ifdef WORKSPACE_THREADS
+    return workspaceKeyCreated && !pthread_setspecific(workspaceKey, value);
+#else
+    workspaceFirst = value;
+
+    return true;
+#endif
+}
+
+void* workspace_get(
+    const char* name,
+    size_t size,
+    WorkspaceAction initialize,
+    WorkspaceAction finalize)
+{
+    WorkspaceEntry first = get_first();
+
+    for (WorkspaceEntry entry = first; entry; entry = entry->next)
+    {
+        if (strcmp(entry->name, name) == 0)
+        {
+            return entry->data;
+        }
+    }
+
+    WorkspaceEntry entry = malloc(sizeof * entry);
+
+    if (!entry)
+    {
+        return NULL;
+    }
+
+    entry->data = malloc(size);
+
+    if (!entry->data)
+    {
+        free(entry);
+
+        return NULL;
+    }
+
+    entry->next = first;
+    entry->name = name;
+    entry->finalize = finalize;
+
+    initialize(entry->data);
+
+    if (!set_first(entry))
+    {
+        entry->next = NULL;
+
+        release(entry);
+
+        return NULL;
+    }
+
+    return entry->data;
+}
+
+void workspace_release(void)
+{
+    WorkspaceEntry first = get_first();
+
+    if (first && set_first(NULL))
+    {
+        release(first);
+    }
+}
@@ -0,0 +1,30 @@
+// Licensed under the MIT License.
+
+// Workspace
+
+#ifndef WORKSPACE_H
+#define WORKSPACE_H
+#include <stddef.h>
+
+// Initializes or finalizes the structures held in a workspace.
+
+typedef void (*WorkspaceAction)(void* instance);
+
+// Returns the workspace of `size` bytes that the calling thread keeps for
+// `name`, or NULL if memory is exhausted. A solver holds its growable
+// structures in a workspace and resets them for each input, so a thread that
+// solves many inputs allocates only when an input outgrows the ones before it.
+// The first call on each thread initializes the workspace with `initialize`;
+// `finalize` is called when the thread exits or releases its workspaces.
+
+void* workspace_get(
+    const char* name,
+    size_t size,
+    WorkspaceAction initialize,
+    WorkspaceAction finalize);
+
+// Finalizes every workspace of the calling thread.
+
+void workspace_release(void);
+
+#endif
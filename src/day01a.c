@@ -3,50 +3,165 @@
 // Trebuchet?! Part 1
 
 #include <ctype.h>
-#include <stdio.h>
-#include <time.h>
-#define BUFFER_SIZE 256
+#include <stddef.h>
+#include <string.h>
+#include "../lib/solver.h"
+#if defined(__GNUC__) && defined(__AVX2__)
+#include <immintrin.h>
+#define BLOCK_SIZE 32
+#elif defined(__GNUC__) && defined(__SSE2__)
+#include <emmintrin.h>
+#define BLOCK_SIZE 16
+#endif
 
-static int parse(char digit)
+// The calibration values of the lines read so far and the first and last
+// digits of the current line. The first digit is -1 until one is read.
+
+struct Calibration
+{
+    long long sum;
+    int first;
+    int last;
+};
+
+typedef struct Calibration* Calibration;
+
+void calibration(Calibration instance)
+{
+    instance->sum = 0;
+    instance->first = -1;
+    instance->last = 0;
+}
+
+void calibration_end_line(Calibration instance)
 {
-    if (!digit)
+    if (instance->first != -1)
     {
-        return 0;
+        instance->sum += (instance->first * 10) + instance->last;
     }
 
-    return digit - '0';
+    instance->first = -1;
 }
 
-int main(void)
+void calibration_read(Calibration instance, char symbol)
 {
-    char buffer[BUFFER_SIZE];
-    long sum = 0;
-    clock_t start = clock();
+    if (symbol == '\n')
+    {
+        calibration_end_line(instance);
+
+        return;
+    }
 
-    while (fgets(buffer, sizeof buffer, stdin))
+    if (!isdigit(symbol))
     {
-        char tens = 0;
-        char ones = 0;
+        return;
+    }
 
-        for (char* p = buffer; *p; p++)
-        {
-            if (!isdigit(*p))
-            {
-                continue;
-            }
+    if (instance->first == -1)
+    {
+        instance->first = symbol - '0';
+    }
 
-            if (!tens)
-            {
-                tens = *p;
-            }
+    instance->last = symbol - '0';
+}
+
+#ifdef BLOCK_SIZE
+// Returns a mask of the line feeds in a block, one bit per byte, and stores a
+// mask of its digits in `digits`.
+
+static unsigned int find(const char block[], unsigned int* digits)
+{
+#if BLOCK_SIZE == 32
+    __m256i bytes = _mm256_loadu_si256((const __m256i*)block);
+    __m256i values = _mm256_sub_epi8(bytes, _mm256_set1_epi8('0'));
+    __m256i nine = _mm256_set1_epi8(9);
 
-            ones = *p;
-        }
+    *digits = _mm256_movemask_epi8(
+        _mm256_cmpeq_epi8(_mm256_max_epu8(values, nine), nine));
 
-        sum += (parse(tens) * 10) + parse(ones);
+    return _mm256_movemask_epi8(
+        _mm256_cmpeq_epi8(bytes, _mm256_set1_epi8('\n')));
+#else
+    __m128i bytes = _mm_loadu_si128((const __m128i*)block);
+    __m128i values = _mm_sub_epi8(bytes, _mm_set1_epi8('0'));
+    __m128i nine = _mm_set1_epi8(9);
+
+    *digits = _mm_movemask_epi8(
+        _mm_cmpeq_epi8(_mm_max_epu8(values, nine), nine));
+
+    return _mm_movemask_epi8(_mm_cmpeq_epi8(bytes, _mm_set1_epi8('\n')));
+#endif
+}
+
+static void calibration_read_digits(
+    Calibration instance,
+    const char block[],
+    unsigned int digits)
+{
+    if (!digits)
+    {
+        return;
     }
 
-    printf("01a %ld %lf\n", sum, (double)(clock() - start) / CLOCKS_PER_SEC);
+    if (instance->first == -1)
+    {
+        instance->first = block[__builtin_ctz(digits)] - '0';
+    }
 
-    return 0;
+    instance->last = block[31 - __builtin_clz(digits)] - '0';
+}
+
+// Reads a block with one iteration per line feed rather than per byte. The
+// digits below the lowest line feed belong to the current line.
+
+static void calibration_read_block(Calibration instance, const char block[])
+{
+    unsigned int digits;
+    unsigned int lineFeeds = find(block, &digits);
+
+    while (lineFeeds)
+    {
+        unsigned int before = (lineFeeds & -lineFeeds) - 1;
+
+        calibration_read_digits(instance, block, digits & before);
+        calibration_end_line(instance);
+
+        digits &= ~before;
+        lineFeeds &= lineFeeds - 1;
+    }
+
+    calibration_read_digits(instance, block, digits);
+}
+#endif
+
+Exception solve(const char* input, size_t length, long long* result)
+{
+    struct Calibration sum;
+    const char* p = input;
+    const char* end = input + length;
+
+    calibration(&sum);
+
+#ifdef BLOCK_SIZE
+    for (; end - p >= BLOCK_SIZE; p += BLOCK_SIZE)
+    {
+        calibration_read_block(&sum, p);
+    }
+#endif
+
+    for (; p < end; p++)
+    {
+        calibration_read(&sum, *p);
+    }
+
+    calibration_end_line(&sum);
+
+    *result = sum.sum;
+
+    return EXCEPTION_NONE;
+}
+
+int main(void)
+{
+    return solver_main_sharded("01a", solve, SHARD_LINE);
 }
@@ -3,115 +3,195 @@
 // Trebuchet!? Part 2
 
 #include <ctype.h>
-#include <stdio.h>
-#include <stdlib.h>
+#include <stdbool.h>
 #include <string.h>
-#include <time.h>
-#define BUFFER_SIZE 256
+#include "../lib/solver.h"
+#include "../lib/stream.h"
 
-typedef char* String;
+#define AUTOMATON_ALPHABET 26
+#define AUTOMATON_CAPACITY 64
 
-static int parse(String value)
+// A deterministic finite automaton that recognizes the names of the digits,
+// spelled forward or backward. It is built from a trie of the names, as in
+// the Aho-Corasick algorithm, so every letter costs one transition.
+
+struct Automaton
+{
+    unsigned char next[AUTOMATON_CAPACITY][AUTOMATON_ALPHABET];
+    unsigned char outputs[AUTOMATON_CAPACITY];
+    int count;
+};
+
+typedef const char* String;
+typedef struct Automaton* Automaton;
+
+static void automaton_add(
+    Automaton instance,
+    String word,
+    int value,
+    bool reverse)
 {
-    char first = value[0];
+    int state = 0;
+    int length = strlen(word);
 
-    if (isdigit(first))
+    for (int k = 0; k < length; k++)
     {
-        return first - '0';
+        int symbol = word[k] - 'a';
+
+        if (reverse)
+        {
+            symbol = word[length - k - 1] - 'a';
+        }
+
+        if (!instance->next[state][symbol])
+        {
+            instance->next[state][symbol] = instance->count;
+            instance->count++;
+        }
+
+        state = instance->next[state][symbol];
     }
 
-    switch (first)
+    instance->outputs[state] = value;
+}
+
+void automaton(Automaton instance, bool reverse)
+{
+    String words[] =
     {
-        case 'f':
-            if (strstr(value + 1, "our") == value + 1)
-            {
-                return 4;
-            }
+        "one", "two", "three", "four", "five", "six", "seven", "eight", "nine"
+    };
 
-            if (strstr(value + 1, "ive") == value + 1)
-            {
-                return 5;
-            }
+    memset(instance, 0, sizeof * instance);
 
-            return 0;
+    instance->count = 1;
 
-        case 's':
-            if (strstr(value + 1, "ix") == value + 1)
-            {
-                return 6;
-            }
+    for (int i = 0; i < 9; i++)
+    {
+        automaton_add(instance, words[i], i + 1, reverse);
+    }
 
-            if (strstr(value + 1, "even") == value + 1)
-            {
-                return 7;
-            }
+    // Visit the states in breadth-first order, so that the failure state of
+    // each state, the longest proper suffix of its name that is also a state,
+    // has already been completed.
 
-            return 0;
+    int first = 0;
+    int last = 0;
+    unsigned char order[AUTOMATON_CAPACITY];
+    unsigned char failures[AUTOMATON_CAPACITY];
 
-        case 't':
-            if (strstr(value + 1, "wo") == value + 1)
-            {
-                return 2;
-            }
+    for (int symbol = 0; symbol < AUTOMATON_ALPHABET; symbol++)
+    {
+        int child = instance->next[0][symbol];
+
+        if (child)
+        {
+            failures[child] = 0;
+            order[last] = child;
+            last++;
+        }
+    }
+
+    while (first < last)
+    {
+        int state = order[first];
+        int failure = failures[state];
 
-            if (strstr(value + 1, "hree") == value + 1)
+        first++;
+
+        if (!instance->outputs[state])
+        {
+            instance->outputs[state] = instance->outputs[failure];
+        }
+
+        for (int symbol = 0; symbol < AUTOMATON_ALPHABET; symbol++)
+        {
+            int child = instance->next[state][symbol];
+
+            if (!child)
             {
-                return 3;
+                instance->next[state][symbol] = instance->next[failure][symbol];
+
+                continue;
             }
 
-            return 0;
+            failures[child] = instance->next[failure][symbol];
+            order[last] = child;
+            last++;
+        }
     }
+}
 
-    if (strstr(value, "one") == value)
-    {
-        return 1;
-    }
+// Advances the automaton past `symbol` and returns the digit that ends there,
+// or zero.
 
-    if (strstr(value, "eight") == value)
+static int automaton_read(Automaton instance, int* state, char symbol)
+{
+    if (isdigit(symbol))
     {
-        return 8;
+        *state = 0;
+
+        return symbol - '0';
     }
 
-    if (strstr(value, "nine") == value)
+    if (symbol < 'a' || symbol > 'z')
     {
-        return 9;
+        *state = 0;
+
+        return 0;
     }
 
-    return 0;
+    *state = instance->next[*state][symbol - 'a'];
+
+    return instance->outputs[*state];
 }
 
-int main(void)
+Exception solve(const char* input, size_t length, long long* result)
 {
-    char buffer[BUFFER_SIZE];
     long sum = 0;
-    clock_t start = clock();
+    struct Stream reader;
+    struct StringView line;
+    struct Automaton forward;
+    struct Automaton backward;
+
+    stream(&reader, input, length);
+    automaton(&forward, false);
+    automaton(&backward, true);
 
-    while (fgets(buffer, sizeof buffer, stdin))
+    while (stream_next_line(&reader, &line))
     {
         int tens = 0;
         int ones = 0;
+        int state = 0;
+        String p = line.begin;
 
-        for (char* p = buffer; *p; p++)
+        // No name of a digit contains another, so the first match to end is
+        // also the first to begin, and likewise for the last match.
+
+        while (!tens && p < line.end)
         {
-            int current = parse(p);
+            tens = automaton_read(&forward, &state, *p);
+            p++;
+        }
 
-            if (!current)
-            {
-                continue;
-            }
+        state = 0;
+        p = line.end;
 
-            if (!tens)
-            {
-                tens = current;
-            }
-
-            ones = current;
+        while (tens && !ones)
+        {
+            p--;
+            ones = automaton_read(&backward, &state, *p);
         }
 
         sum += (tens * 10) + ones;
     }
 
-    printf("01b %ld %lf\n", sum, (double)(clock() - start) / CLOCKS_PER_SEC);
+    *result = sum;
 
-    return 0;
+    return EXCEPTION_NONE;
+}
+
+int main(void)
+{
+    return solver_main_sharded("01b", solve, SHARD_LINE);
 }
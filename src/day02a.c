@@ -2,109 +2,164 @@
 
 // Cube Conundrum Part 1
 
-#include <stdio.h>
-#include <stdlib.h>
+#include <ctype.h>
+#include <stdbool.h>
 #include <string.h>
-#include <time.h>
-#define BUFFER_SIZE 256
-#define DELIMITERS ";, "
-#define EXCEPTION_FORMAT "Error: Format.\n"
+#include "../lib/solver.h"
+#include "../lib/stream.h"
+#include "../lib/number.h"
+#define BLUE_MAX 14
+#define GREEN_MAX 13
+#define RED_MAX 12
 
-enum PossibleResult
+// A game, with the greatest number of cubes of each color shown at once.
+
+struct Game
 {
-    POSSIBLE_RESULT_IMPOSSIBLE,
-    POSSIBLE_RESULT_POSSIBLE,
-    POSSIBLE_RESULT_FORMAT_EXCEPTION
+    long long id;
+    long long red;
+    long long green;
+    long long blue;
 };
 
-typedef char* String;
-typedef enum PossibleResult PossibleResult;
+typedef struct Game* Game;
 
-static PossibleResult possible(char token, int number)
+static const char* skip_spaces(const char* p, const char* end)
 {
-    switch (token)
+    while (p < end && *p == ' ')
     {
-        case 'r':
-            if (number > 12)
-            {
-                return POSSIBLE_RESULT_IMPOSSIBLE;
-            }
-            break;
-        case 'g':
-            if (number > 13)
-            {
-                return POSSIBLE_RESULT_IMPOSSIBLE;
-            }
-            break;
-        case 'b':
-            if (number > 14)
-            {
-                return POSSIBLE_RESULT_IMPOSSIBLE;
-            }
-            break;
-        default:
-            return POSSIBLE_RESULT_FORMAT_EXCEPTION;
+        p++;
     }
 
-    return POSSIBLE_RESULT_POSSIBLE;
+    return p;
 }
 
-int main(void)
+// Reads a line of the form `Game 1: 3 blue, 4 red; 1 red, 2 green` in one
+// pass. Only the first letter of each color is examined. Reading stops at the
+// first draw that makes the game impossible. Returns false if the line is
+// malformed.
+
+static bool game(Game instance, StringView line)
 {
-    char buffer[BUFFER_SIZE];
-    long sum = 0;
-    long game = 1;
-    clock_t start = clock();
+    const char* end = line->end;
+    const char* colon = memchr(line->begin, ':', end - line->begin);
 
-    while (fgets(buffer, sizeof buffer, stdin))
+    if (!colon)
     {
-        char* start = strchr(buffer, ':');
+        return false;
+    }
 
-        if (!start || !strtok(start, DELIMITERS))
-        {
-            fprintf(stderr, EXCEPTION_FORMAT);
+    const char* p = line->begin;
 
-            return 1;
-        }
+    while (p < colon && !isdigit(*p))
+    {
+        p++;
+    }
+
+    if (number_parse_decimal(p, colon, &instance->id) == p)
+    {
+        return false;
+    }
 
-        String token;
-        int lastNumber = 0;
-        PossibleResult lastPossibleResult = POSSIBLE_RESULT_POSSIBLE;
+    instance->red = 0;
+    instance->green = 0;
+    instance->blue = 0;
+    p = skip_spaces(colon + 1, end);
 
-        while ((token = strtok(NULL, DELIMITERS)))
+    while (p < end)
+    {
+        long long count;
+        long long limit;
+        long long* max;
+        const char* next = number_parse_decimal(p, end, &count);
+
+        if (next == p)
         {
-            if (!lastNumber)
-            {
-                lastNumber = atoi(token);
+            return false;
+        }
 
-                continue;
-            }
+        p = skip_spaces(next, end);
 
-            lastPossibleResult = possible(token[0], lastNumber);
-            lastNumber = 0;
+        if (p == end)
+        {
+            return false;
+        }
 
-            if (lastPossibleResult != POSSIBLE_RESULT_POSSIBLE)
-            {
+        switch (*p)
+        {
+            case 'r':
+                max = &instance->red;
+                limit = RED_MAX;
+                break;
+            case 'g':
+                max = &instance->green;
+                limit = GREEN_MAX;
+                break;
+            case 'b':
+                max = &instance->blue;
+                limit = BLUE_MAX;
                 break;
-            }
+            default:
+                return false;
+        }
+
+        if (count > *max)
+        {
+            *max = count;
         }
 
-        if (lastPossibleResult == POSSIBLE_RESULT_FORMAT_EXCEPTION)
+        if (count > limit)
         {
-            fprintf(stderr, EXCEPTION_FORMAT);
+            return true;
+        }
 
-            return 1;
+        while (p < end && *p != ',' && *p != ';')
+        {
+            p++;
         }
 
-        if (lastPossibleResult == POSSIBLE_RESULT_POSSIBLE)
+        if (p < end)
         {
-            sum += game;
+            p++;
         }
 
-        game++;
+        p = skip_spaces(p, end);
     }
 
-    printf("02a %ld %lf\n", sum, (double)(clock() - start) / CLOCKS_PER_SEC);
+    return true;
+}
+
+Exception solve(const char* input, size_t length, long long* result)
+{
+    long long sum = 0;
+    struct Stream reader;
+    struct StringView line;
 
-    return 0;
+    stream(&reader, input, length);
+
+    while (stream_next_line(&reader, &line))
+    {
+        struct Game current;
+
+        if (!game(&current, &line))
+        {
+            return EXCEPTION_FORMAT;
+        }
+
+        if (current.red <= RED_MAX &&
+            current.green <= GREEN_MAX &&
+            current.blue <= BLUE_MAX)
+        {
+            sum += current.id;
+        }
+    }
+
+    *result = sum;
+
+    return EXCEPTION_NONE;
+}
+
+int main(void)
+{
+    return solver_main_sharded("02a", solve, SHARD_LINE);
 }
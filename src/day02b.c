@@ -2,80 +2,146 @@
 
 // Cube Conundrum Part 2
 
-#include <stdio.h>
-#include <stdlib.h>
+#include <ctype.h>
+#include <stdbool.h>
 #include <string.h>
-#include <time.h>
-#define BUFFER_SIZE 256
-#define DELIMITERS ";, "
-#define EXCEPTION_FORMAT "Error: Format.\n"
+#include "../lib/solver.h"
+#include "../lib/stream.h"
+#include "../lib/number.h"
 
-typedef char* String;
+// A game, with the greatest number of cubes of each color shown at once.
 
-int main(void)
+struct Game
 {
-    char buffer[BUFFER_SIZE];
-    long sum = 0;
-    clock_t start = clock();
+    long long id;
+    long long red;
+    long long green;
+    long long blue;
+};
+
+typedef struct Game* Game;
 
-    while (fgets(buffer, sizeof buffer, stdin))
+static const char* skip_spaces(const char* p, const char* end)
+{
+    while (p < end && *p == ' ')
     {
-        char* start = strchr(buffer, ':');
+        p++;
+    }
+
+    return p;
+}
+
+// Reads a line of the form `Game 1: 3 blue, 4 red; 1 red, 2 green` in one
+// pass. Only the first letter of each color is examined. Returns false if the
+// line is malformed.
+
+static bool game(Game instance, StringView line)
+{
+    const char* end = line->end;
+    const char* colon = memchr(line->begin, ':', end - line->begin);
+
+    if (!colon)
+    {
+        return false;
+    }
+
+    const char* p = line->begin;
 
-        if (!start || !strtok(start, DELIMITERS))
+    while (p < colon && !isdigit(*p))
+    {
+        p++;
+    }
+
+    if (number_parse_decimal(p, colon, &instance->id) == p)
+    {
+        return false;
+    }
+
+    instance->red = 0;
+    instance->green = 0;
+    instance->blue = 0;
+    p = skip_spaces(colon + 1, end);
+
+    while (p < end)
+    {
+        long long count;
+        long long* max;
+        const char* next = number_parse_decimal(p, end, &count);
+
+        if (next == p)
         {
-            fprintf(stderr, EXCEPTION_FORMAT);
+            return false;
+        }
+
+        p = skip_spaces(next, end);
 
-            return 1;
+        if (p == end)
+        {
+            return false;
         }
 
-        String token;
-        int r = 0;
-        int g = 0;
-        int b = 0;
-        int lastNumber = 0;
+        switch (*p)
+        {
+            case 'r':
+                max = &instance->red;
+                break;
+            case 'g':
+                max = &instance->green;
+                break;
+            case 'b':
+                max = &instance->blue;
+                break;
+            default:
+                return false;
+        }
+
+        if (count > *max)
+        {
+            *max = count;
+        }
+
+        while (p < end && *p != ',' && *p != ';')
+        {
+            p++;
+        }
+
+        if (p < end)
+        {
+            p++;
+        }
+
+        p = skip_spaces(p, end);
+    }
+
+    return true;
+}
+
+Exception solve(const char* input, size_t length, long long* result)
+{
+    long long sum = 0;
+    struct Stream reader;
+    struct StringView line;
+
+    stream(&reader, input, length);
 
-        while ((token = strtok(NULL, DELIMITERS)))
+    while (stream_next_line(&reader, &line))
+    {
+        struct Game current;
+
+        if (!game(&current, &line))
         {
-            if (!lastNumber)
-            {
-                lastNumber = atoi(token);
-
-                continue;
-            }
-
-            switch (token[0])
-            {
-                case 'r':
-                    if (lastNumber > r)
-                    {
-                        r = lastNumber;
-                    }
-                    break;
-                case 'g':
-                    if (lastNumber > g)
-                    {
-                        g = lastNumber;
-                    }
-                    break;
-                case 'b':
-                    if (lastNumber > b)
-                    {
-                        b = lastNumber;
-                    }
-                    break;
-                default:
-                    fprintf(stderr, EXCEPTION_FORMAT);
-                    return 1;
-            }
-
-            lastNumber = 0;
+            return EXCEPTION_FORMAT;
         }
 
-        sum += r * g * b;
+        sum += current.red * current.green * current.blue;
     }
 
-    printf("02b %ld %lf\n", sum, (double)(clock() - start) / CLOCKS_PER_SEC);
+    *result = sum;
+
+    return EXCEPTION_NONE;
+}
 
-    return 0;
+int main(void)
+{
+    return solver_main_sharded("02b", solve, SHARD_LINE);
 }
@@ -4,129 +4,241 @@
 
 #include <ctype.h>
 #include <stdbool.h>
-#include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
-#include <time.h>
-#define DIMENSION 141
+#include "../lib/solver.h"
+#include "../lib/stream.h"
+#include "../lib/number.h"
+#define WINDOW_ROWS 3
+#define WORD_BITS 64
 
-struct View
+typedef unsigned long long Word;
+
+// Three consecutive rows of the schematic, with one bit per column marking the
+// symbols and the digits of each row. Rows are processed in the middle of the
+// window, so only three rows are held at a time, however tall the schematic.
+
+struct Window
 {
-    char* a;
-    char* b;
-    int index;
-    int offset;
+    const char* rows[WINDOW_ROWS];
+    Word* symbols[WINDOW_ROWS];
+    Word* digits[WINDOW_ROWS];
+    Word* near;
+    Word* buffer;
+    int columns;
+    int words;
 };
 
-typedef char* String;
-typedef struct View* View;
-typedef bool (*Validator)(struct View* view);
+typedef struct Window* Window;
 
-static bool check(char value)
+static int trailing_zeros(Word value)
 {
-    return value != '.' && value != '\n' && value;
+#if defined(__GNUC__)
+    return __builtin_ctzll(value);
+#else
+    int result = 0;
+
+    while (!(value & 1))
+    {
+        value >>= 1;
+        result++;
+    }
+
+    return result;
+#endif
 }
 
-static bool realize_x(View view)
+bool window(Window instance, int columns)
 {
-    if (view->index < DIMENSION && check(view->a[view->index]))
+    int words = (columns / WORD_BITS) + 1;
+    Word* buffer = calloc(((2 * WINDOW_ROWS) + 1) * words, sizeof * buffer);
+
+    if (!buffer)
     {
-        return true;
+        return false;
     }
 
-    if (view->offset - 1 >= 0 && check(view->a[view->offset - 1]))
+    for (int i = 0; i < WINDOW_ROWS; i++)
     {
-        return true;
+        instance->rows[i] = NULL;
+        instance->symbols[i] = buffer + (2 * i * words);
+        instance->digits[i] = buffer + (((2 * i) + 1) * words);
     }
 
-    return false;
+    instance->near = buffer + (2 * WINDOW_ROWS * words);
+    instance->buffer = buffer;
+    instance->columns = columns;
+    instance->words = words;
+
+    return true;
 }
 
-static bool realize_y(View view)
+// Shifts the window down by one row, which becomes the last row. If `row` is
+// NULL, the last row is empty.
+
+void window_push(Window instance, const char* row)
 {
-    for (int i = view->offset - 1; i <= view->index; i++)
+    Word* symbols = instance->symbols[0];
+    Word* digits = instance->digits[0];
+
+    for (int i = 1; i < WINDOW_ROWS; i++)
+    {
+        instance->rows[i - 1] = instance->rows[i];
+        instance->symbols[i - 1] = instance->symbols[i];
+        instance->digits[i - 1] = instance->digits[i];
+    }
+
+    instance->rows[WINDOW_ROWS - 1] = row;
+    instance->symbols[WINDOW_ROWS - 1] = symbols;
+    instance->digits[WINDOW_ROWS - 1] = digits;
+
+    memset(symbols, 0, instance->words * sizeof * symbols);
+    memset(digits, 0, instance->words * sizeof * digits);
+
+    if (!row)
+    {
+        return;
+    }
+
+    for (int j = 0; j < instance->columns; j++)
     {
-        if (check(view->b[i]))
+        Word bit = (Word)1 << (j % WORD_BITS);
+
+        if (isdigit(row[j]))
+        {
+            digits[j / WORD_BITS] |= bit;
+        }
+        else if (row[j] != '.')
         {
-            return true;
+            symbols[j / WORD_BITS] |= bit;
         }
     }
-
-    return false;
 }
 
-static bool realize_xy(View view)
-{
-    return realize_x(view) || realize_y(view);
-}
+// Returns the sum of the numbers in the middle row that are adjacent to a
+// symbol. The symbols of all three rows are combined and dilated by one column
+// in each direction; a number is adjacent to a symbol if and only if one of
+// its digits lies under the dilated mask.
 
-static void aggregate(String a, String b, long* sum, Validator validator)
+long long window_sum(Window instance)
 {
-    int number = 0;
-    struct View view =
+    const char* row = instance->rows[1];
+    Word* near = instance->near;
+    Word* digits = instance->digits[1];
+
+    if (!row)
+    {
+        return 0;
+    }
+
+    for (int k = 0; k < instance->words; k++)
     {
-        .a = a,
-        .b = b,
-        .offset = -1
-    };
+        near[k] =
+            instance->symbols[0][k] |
+            instance->symbols[1][k] |
+            instance->symbols[2][k];
+    }
+
+    long long result = 0;
+    int next = 0;
+    Word carry = 0;
 
-    while (view.index < DIMENSION && a[view.index])
+    for (int k = 0; k < instance->words; k++)
     {
-        if (isdigit(a[view.index]))
+        Word current = near[k];
+        Word hits = current | (current << 1) | (current >> 1) | carry;
+
+        carry = current >> (WORD_BITS - 1);
+
+        if (k + 1 < instance->words)
         {
-            if (view.offset == -1)
+            hits |= near[k + 1] << (WORD_BITS - 1);
+        }
+
+        hits &= digits[k];
+
+        while (hits)
+        {
+            int j = (k * WORD_BITS) + trailing_zeros(hits);
+
+            hits &= hits - 1;
+
+            if (j < next)
             {
-                view.offset = view.index;
+                continue;
             }
 
-            number = (number * 10) + (a[view.index] - '0');
-            view.index++;
+            while (j > 0 && isdigit(row[j - 1]))
+            {
+                j--;
+            }
 
-            continue;
-        }
+            long long number;
 
-        if (number && validator(&view))
-        {
-            *sum += number;
+            next = number_parse_decimal(
+                row + j,
+                row + instance->columns,
+                &number) - row;
+            result += number;
         }
-
-        number = 0; 
-        view.offset = -1;
-        view.index++;
     }
 
-    view.index = DIMENSION - 1;
+    return result;
+}
 
-    if (number && validator(&view))
-    {
-        *sum += number;
-    }
+void finalize_window(Window instance)
+{
+    free(instance->buffer);
 }
 
-int main(void)
+Exception solve(const char* input, size_t length, long long* result)
 {
-    char hi[DIMENSION + 1] = { 0 };
-    clock_t start = clock();
+    struct Stream reader;
+    struct StringView line;
 
-    if (!fgets(hi, sizeof hi, stdin))
+    stream(&reader, input, length);
+
+    if (!stream_next_line(&reader, &line))
     {
-        fprintf(stderr, "Error: Format.\n");
+        return EXCEPTION_FORMAT;
+    }
 
-        return 1;
+    struct Window rows;
+
+    if (!window(&rows, line.end - line.begin))
+    {
+        return EXCEPTION_OUT_OF_MEMORY;
     }
 
-    long sum = 0;
-    char lo[DIMENSION + 1] = { 0 };
+    long long sum = 0;
 
-    while (fgets(lo, sizeof lo, stdin))
+    do
     {
-        aggregate(hi, lo, &sum, realize_xy);
-        aggregate(lo, hi, &sum, realize_y);
-        memcpy(hi, lo, sizeof hi);
+        if (line.end - line.begin != rows.columns)
+        {
+            finalize_window(&rows);
+
+            return EXCEPTION_FORMAT;
+        }
+
+        window_push(&rows, line.begin);
+
+        sum += window_sum(&rows);
     }
+    while (stream_next_line(&reader, &line));
+
+    window_push(&rows, NULL);
+
+    sum += window_sum(&rows);
+
+    finalize_window(&rows);
 
-    aggregate(lo, hi, &sum, realize_x);
-    printf("03a %ld %lf\n", sum, (double)(clock() - start) / CLOCKS_PER_SEC);
+    *result = sum;
 
-    return 0;
+    return EXCEPTION_NONE;
+}
+
+int main(void)
+{
+    return solver_main("03a", solve);
 }
@@ -2,240 +2,297 @@
 
 // Gear Ratios Part 2
 
-#include <ctype.h>
 #include <stdbool.h>
-#include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
-#include <time.h>
-#define CASES 8
-#define DIMENSION 141
+#include "../lib/solver.h"
+#include "../lib/stream.h"
+#include "../lib/number.h"
+#if defined(__GNUC__) && defined(__BYTE_ORDER__) && \
+    __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+#define WINDOW_SWAR
+#endif
+#define WINDOW_ROWS 3
+#define WORD_BITS 64
+
+typedef unsigned long long Word;
+
+// Three consecutive rows of the schematic, with one bit per column marking the
+// digits of each row. A run of set bits is a number, labeled by the column
+// where it starts. Gears are found in the middle row, so only three rows are
+// held at a time, however tall the schematic.
 
 struct Window
 {
-    char* hi;
-    char* mid;
-    char* lo;
-    int index;
+    const char* rows[WINDOW_ROWS];
+    Word* digits[WINDOW_ROWS];
+    Word* buffer;
+    int columns;
+    int words;
 };
 
-typedef char* String;
-typedef int (*Case)(struct Window*);
 typedef struct Window* Window;
 
-static int scan_left(String value, int index)
+static int highest_bit(Word value)
 {
-    if (isdigit(value[index]))
+#if defined(__GNUC__)
+    return (WORD_BITS - 1) - __builtin_clzll(value);
+#else
+    int result = 0;
+
+    while (value >>= 1)
     {
-        return 0;
+        result++;
     }
 
-    int number = 0;
-    int place = 1;
-
-    for (int j = index - 1; j >= 0; j--)
-    {
-        char current = value[j];
+    return result;
+#endif
+}
 
-        if (!isdigit(current))
-        {
-            break;
-        }
+#ifdef WINDOW_SWAR
+// Returns a mask of the digits among eight characters, one bit per character.
+// Each byte has its high bit cleared, so adding 0x50 or 0x46 sets the high bit
+// without a carry if and only if the byte is at least '0' or ':'. The product
+// gathers the high bits into the top byte.
 
-        number += (current - '0') * place;
-        place *= 10;
-    }
+static Word digit_bits(Word bytes)
+{
+    Word low = bytes & 0x7f7f7f7f7f7f7f7full;
+    Word flags = (low + 0x5050505050505050ull) &
+        ~(low + 0x4646464646464646ull) &
+        ~bytes &
+        0x8080808080808080ull;
 
-    return number;
+    return ((flags >> 7) * 0x0102040810204080ull) >> 56;
 }
+#endif
 
-static int scan_right(String value, int index)
+bool window(Window instance, int columns)
 {
-    if (isdigit(value[index]))
+    int words = (columns / WORD_BITS) + 1;
+    Word* buffer = calloc(WINDOW_ROWS * words, sizeof * buffer);
+
+    if (!buffer)
     {
-        return 0;
+        return false;
     }
 
-    int number = 0;
-
-    for (int j = index + 1; j < DIMENSION; j++)
+    for (int i = 0; i < WINDOW_ROWS; i++)
     {
-        if (!isdigit(value[j]))
-        {
-            break;
-        }
-
-        number = (number * 10) + (value[j] - '0');
+        instance->rows[i] = NULL;
+        instance->digits[i] = buffer + (i * words);
     }
 
-    return number;
+    instance->buffer = buffer;
+    instance->columns = columns;
+    instance->words = words;
+
+    return true;
 }
 
-static int scan_center(String value, int index)
+// Shifts the window down by one row, which becomes the last row, and marks its
+// digits. If `row` is NULL, the last row is empty.
+
+void window_push(Window instance, const char* row)
 {
-    char current = value[index];
+    Word* digits = instance->digits[0];
 
-    if (!isdigit(current))
+    for (int i = 1; i < WINDOW_ROWS; i++)
     {
-        return 0;
+        instance->rows[i - 1] = instance->rows[i];
+        instance->digits[i - 1] = instance->digits[i];
     }
 
-    bool hasLeft = index - 1 >= 0 && isdigit(value[index - 1]);
-    bool hasRight = index + 1 < DIMENSION && isdigit(value[index + 1]);
+    instance->rows[WINDOW_ROWS - 1] = row;
+    instance->digits[WINDOW_ROWS - 1] = digits;
 
-    if (hasLeft && hasRight)
+    memset(digits, 0, instance->words * sizeof * digits);
+
+    if (!row)
     {
-        return scan_right(value, index - 2);
+        return;
     }
 
-    if (hasLeft)
+    int j = 0;
+
+#ifdef WINDOW_SWAR
+    for (; j + 8 <= instance->columns; j += 8)
     {
-        return scan_left(value, index + 1);
+        Word bytes;
+
+        memcpy(&bytes, row + j, sizeof bytes);
+
+        digits[j / WORD_BITS] |= digit_bits(bytes) << (j % WORD_BITS);
     }
+#endif
 
-    if (hasRight)
+    for (; j < instance->columns; j++)
     {
-        return scan_right(value, index - 1);
+        if ((unsigned char)(row[j] - '0') < 10)
+        {
+            digits[j / WORD_BITS] |= (Word)1 << (j % WORD_BITS);
+        }
     }
-
-    return current - '0';
 }
 
-int window_hi_left(Window instance)
+static bool window_is_digit(Window instance, int i, int j)
 {
-    return scan_left(instance->hi, instance->index);
+    return (instance->digits[i][j / WORD_BITS] >> (j % WORD_BITS)) & 1;
 }
 
-int window_hi_center(Window instance)
-{
-    return scan_center(instance->hi, instance->index);
-}
+// Returns the label of the number through column `j` of row `i`: the column
+// after the nearest non-digit to its left.
 
-int window_hi_right(Window instance)
+static int window_label(Window instance, int i, int j)
 {
-    return scan_right(instance->hi, instance->index);
-}
+    const Word* digits = instance->digits[i];
+    int k = j / WORD_BITS;
+    Word gaps = ~digits[k] & (((Word)1 << (j % WORD_BITS)) - 1);
 
-int window_mid_left(Window instance)
-{
-    return scan_left(instance->mid, instance->index);
-}
+    while (!gaps && k > 0)
+    {
+        k--;
+        gaps = ~digits[k];
+    }
 
-int window_mid_right(Window instance)
-{
-    return scan_right(instance->mid, instance->index);
-}
+    if (!gaps)
+    {
+        return 0;
+    }
 
-int window_lo_left(Window instance)
-{
-    return scan_left(instance->lo, instance->index);
+    return (k * WORD_BITS) + highest_bit(gaps) + 1;
 }
 
-int window_lo_center(Window instance)
-{
-    return scan_center(instance->lo, instance->index);
-}
+// Returns the gear ratio of the gear at column `j` of the middle row, or zero
+// unless exactly two numbers are adjacent to it. Adjacent digits in a row share
+// a label, so each number is counted once.
 
-int window_lo_right(Window instance)
+static long long window_ratio(Window instance, int j)
 {
-    return scan_right(instance->lo, instance->index);
-}
+    int count = 0;
+    long long result = 1;
+    int first = j - 1;
+    int last = j + 1;
 
-static void aggregate(String hi, String mid, String lo, Case cases[], long* sum)
-{
-    for (int i = 0; i < DIMENSION && mid[i]; i++)
+    if (first < 0)
     {
-        if (mid[i] != '*')
-        {
-            continue;
-        }
+        first = 0;
+    }
 
-        int count = 0;
-        int numbers[CASES] = { 0 };
-        struct Window window =
-        {
-            .hi = hi,
-            .mid = mid,
-            .lo = lo,
-            .index = i
-        };
+    if (last >= instance->columns)
+    {
+        last = instance->columns - 1;
+    }
 
-        for (int j = 0; j < CASES; j++)
+    for (int i = 0; i < WINDOW_ROWS; i++)
+    {
+        for (int k = first; k <= last; k++)
         {
-            int number = cases[j](&window);
-
-            if (number)
+            if (!window_is_digit(instance, i, k) ||
+                (k > first && window_is_digit(instance, i, k - 1)))
             {
-                count++;
+                continue;
             }
 
+            count++;
+
             if (count > 2)
             {
-                break;
+                return 0;
             }
 
-            numbers[j] = number;
-        }
+            long long number;
 
-        if (count != 2)
-        {
-            continue;
+            number_parse_decimal(
+                instance->rows[i] + window_label(instance, i, k),
+                instance->rows[i] + instance->columns,
+                &number);
+
+            result *= number;
         }
+    }
 
-        long product = 1;
+    if (count != 2)
+    {
+        return 0;
+    }
 
-        for (int j = 0; j < CASES; j++)
-        {
-            int number = numbers[j];
+    return result;
+}
 
-            if (number)
-            {
-                product *= number;
-            }
-        }
+long long window_sum(Window instance)
+{
+    long long result = 0;
+    const char* row = instance->rows[1];
+
+    if (!row)
+    {
+        return 0;
+    }
+
+    const char* end = row + instance->columns;
 
-        *sum += product;
+    for (const char* p = row; (p = memchr(p, '*', end - p)); p++)
+    {
+        result += window_ratio(instance, p - row);
     }
+
+    return result;
 }
 
-int main(void)
+void finalize_window(Window instance)
 {
-    char hi[DIMENSION + 1] = { 0 };
-    char mid[DIMENSION + 1] = { 0 };
-    char lo[DIMENSION + 1] = { 0 };
-    clock_t start = clock();
+    free(instance->buffer);
+}
 
-    if (!fgets(mid, sizeof mid, stdin) || !fgets(lo, sizeof lo, stdin))
-    {
-        fprintf(stderr, "Error: Format.\n");
+Exception solve(const char* input, size_t length, long long* result)
+{
+    struct Stream reader;
+    struct StringView line;
 
-        return 1;
+    stream(&reader, input, length);
+
+    if (!stream_next_line(&reader, &line))
+    {
+        return EXCEPTION_FORMAT;
     }
 
-    long sum = 0;
-    Case cases[CASES] =
+    struct Window rows;
+
+    if (!window(&rows, line.end - line.begin))
     {
-        window_hi_left,
-        window_hi_center,
-        window_hi_right,
-        window_mid_left,
-        window_mid_right,
-        window_lo_left,
-        window_lo_center,
-        window_lo_right
-    };
+        return EXCEPTION_OUT_OF_MEMORY;
+    }
+
+    long long sum = 0;
 
     do
     {
-        aggregate(hi, mid, lo, cases, &sum);
-        memcpy(hi, mid, sizeof hi);
-        memcpy(mid, lo, sizeof mid);
+        if (line.end - line.begin != rows.columns)
+        {
+            finalize_window(&rows);
+
+            return EXCEPTION_FORMAT;
+        }
+
+        window_push(&rows, line.begin);
+
+        sum += window_sum(&rows);
     }
-    while (fgets(lo, sizeof lo, stdin));
+    while (stream_next_line(&reader, &line));
+
+    window_push(&rows, NULL);
+
+    sum += window_sum(&rows);
 
-    memset(lo, 0, sizeof lo);
-    aggregate(hi, mid, lo, cases, &sum);
-    printf("03b %ld %lf\n", sum, (double)(clock() - start) / CLOCKS_PER_SEC);
+    finalize_window(&rows);
 
-    return 0;
+    *result = sum;
+
+    return EXCEPTION_NONE;
+}
+
+int main(void)
+{
+    return solver_main("03b", solve);
 }
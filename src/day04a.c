@@ -2,15 +2,11 @@
 
 // Scratchcards Part 1
 
-#include <ctype.h>
 #include <stdbool.h>
-#include <stdio.h>
-#include <stdlib.h>
 #include <string.h>
-#include <time.h>
-#define BUFFER_SIZE 128
+#include "../lib/solver.h"
+#include "../lib/stream.h"
 #define DECIMAL_SET_CAPACITY 99
-#define EXCEPTION_FORMAT "Error: Format.\n"
 
 struct DecimalSet
 {
@@ -41,48 +37,40 @@ bool decimal_set_contains(DecimalSet instance, char tens, char ones)
     return instance->set[decimal_set_index(tens, ones)];
 }
 
-int main(void)
+Exception solve(const char* input, size_t length, long long* result)
 {
     long sum = 0;
-    char buffer[BUFFER_SIZE];
-    clock_t start = clock();
+    struct Stream reader;
+    struct StringView line;
+
+    stream(&reader, input, length);
 
-    while (fgets(buffer, sizeof buffer, stdin))
+    while (stream_next_line(&reader, &line))
     {
-        char* begin = strchr(buffer, ':');
+        const char* begin = memchr(line.begin, ':', line.end - line.begin);
 
         if (!begin)
         {
-            fprintf(stderr, EXCEPTION_FORMAT);
-
-            return 1;
+            return EXCEPTION_FORMAT;
         }
 
-        char first;
-        char second;
         long score = 0;
-        char* mid = strchr(buffer, '|');
+        const char* mid = memchr(line.begin, '|', line.end - line.begin);
         struct DecimalSet winningNumbers = { 0 };
 
         if (!mid)
         {
-            fprintf(stderr, EXCEPTION_FORMAT);
-
-            return 1;
+            return EXCEPTION_FORMAT;
         }
 
-        for (char* p = begin + 2;
-            p < mid && (first = p[0]) && (second = p[1]);
-            p += 3)
+        for (const char* p = begin + 2; p + 1 < mid; p += 3)
         {
-            decimal_set_add(&winningNumbers, first, second);
+            decimal_set_add(&winningNumbers, p[0], p[1]);
         }
 
-        for (char* p = mid + 2;
-            (first = p[0]) && (second = p[1]);
-            p += 3)
+        for (const char* p = mid + 2; p + 1 < line.end; p += 3)
         {
-            if (!decimal_set_contains(&winningNumbers, first, second))
+            if (!decimal_set_contains(&winningNumbers, p[0], p[1]))
             {
                 continue;
             }
@@ -100,7 +88,12 @@ int main(void)
         sum += score;
     }
 
-    printf("04a %ld %lf\n", sum, (double)(clock() - start) / CLOCKS_PER_SEC);
+    *result = sum;
 
-    return 0;
+    return EXCEPTION_NONE;
+}
+
+int main(void)
+{
+    return solver_main_sharded("04a", solve, SHARD_LINE);
 }
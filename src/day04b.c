@@ -2,14 +2,11 @@
 
 // Scratchcards Part 2
 
-#include <ctype.h>
 #include <stdbool.h>
-#include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
-#include <time.h>
-#define BUFFER_SIZE 128
-#define CARDS_CAPACITY 256
+#include "../lib/solver.h"
+#include "../lib/stream.h"
 #define DECIMAL_SET_CAPACITY 99
 
 struct DecimalSet
@@ -17,7 +14,14 @@ struct DecimalSet
     bool set[DECIMAL_SET_CAPACITY];
 };
 
+struct CardList
+{
+    long* items;
+    int capacity;
+};
+
 typedef struct DecimalSet* DecimalSet;
+typedef struct CardList* CardList;
 
 static int decimal_set_index(char tens, char ones)
 {
@@ -41,55 +45,104 @@ bool decimal_set_contains(DecimalSet instance, char tens, char ones)
     return instance->set[decimal_set_index(tens, ones)];
 }
 
-int main(void)
+void card_list(CardList instance)
 {
-    int card = 0;
-    char buffer[BUFFER_SIZE];
-    long cards[CARDS_CAPACITY] = { 0 };
-    clock_t start = clock();
+    instance->items = NULL;
+    instance->capacity = 0;
+}
 
-    for (int i = 0; i < CARDS_CAPACITY; i++)
+bool card_list_reserve(CardList instance, int capacity)
+{
+    if (capacity <= instance->capacity)
     {
-        cards[i] = 1;
+        return true;
     }
 
-    while (fgets(buffer, sizeof buffer, stdin))
+    int newCapacity = instance->capacity * 2;
+
+    if (newCapacity < capacity)
     {
-        char* begin = strchr(buffer, ':');
+        newCapacity = capacity;
+    }
+
+    long* newItems = realloc(instance->items, newCapacity * sizeof * newItems);
+
+    if (!newItems)
+    {
+        return false;
+    }
+
+    for (int i = instance->capacity; i < newCapacity; i++)
+    {
+        newItems[i] = 1;
+    }
+
+    instance->items = newItems;
+    instance->capacity = newCapacity;
+
+    return true;
+}
+
+void finalize_card_list(CardList instance)
+{
+    free(instance->items);
+}
+
+Exception solve(const char* input, size_t length, long long* result)
+{
+    int card = 0;
+    struct CardList cards;
+    struct Stream reader;
+    struct StringView line;
+
+    stream(&reader, input, length);
+    card_list(&cards);
+
+    while (stream_next_line(&reader, &line))
+    {
+        const char* begin = memchr(line.begin, ':', line.end - line.begin);
 
         if (!begin)
         {
-            fprintf(stderr, "Error: Format.\n");
+            finalize_card_list(&cards);
 
-            return 1;
+            return EXCEPTION_FORMAT;
         }
 
-        char first;
-        char second;
         int matches = 0;
-        char* next = strchr(buffer, '|');
+        const char* next = memchr(line.begin, '|', line.end - line.begin);
         struct DecimalSet winningNumbers = { 0 };
 
-        for (char* p = begin + 2; 
-             p < next && (first = p[0]) && (second = p[1]);
-             p += 3)
+        if (!next)
+        {
+            finalize_card_list(&cards);
+
+            return EXCEPTION_FORMAT;
+        }
+
+        for (const char* p = begin + 2; p + 1 < next; p += 3)
         {
-            decimal_set_add(&winningNumbers, first, second);
+            decimal_set_add(&winningNumbers, p[0], p[1]);
         }
 
-        for (char* p = next + 2;
-             (first = p[0]) && (second = p[1]);
-             p += 3)
+        for (const char* p = next + 2; p + 1 < line.end; p += 3)
         {
-            if (decimal_set_contains(&winningNumbers, first, second))
+            if (decimal_set_contains(&winningNumbers, p[0], p[1]))
             {
                 matches++;
             }
         }
 
+        if (!card_list_reserve(&cards, card + matches + 1))
+        {
+            finalize_card_list(&cards);
+
+            return EXCEPTION_OUT_OF_MEMORY;
+        }
+
         for (int i = 1; i <= matches; i++)
         {
-            cards[card + i] += cards[card];
+            cards.items[card + i] += cards.items[card];
         }
 
         card++;
@@ -99,10 +152,17 @@ int main(void)
 
     for (int i = 0; i < card; i++)
     {
-        sum += cards[i];
+        sum += cards.items[i];
     }
 
-    printf("04b %ld %lf\n", sum, (double)(clock() - start) / CLOCKS_PER_SEC);
+    finalize_card_list(&cards);
 
-    return 0;
+    *result = sum;
+
+    return EXCEPTION_NONE;
+}
+
+int main(void)
+{
+    return solver_main("04b", solve);
 }
@@ -3,15 +3,14 @@
 // If You Give A Seed A Fertilizer Part 1
 
 #include <limits.h>
-#include <stdio.h>
 #include <stdbool.h>
 #include <stdlib.h>
 #include <string.h>
-#include <time.h>
-#define BUFFER_SIZE 256
+#include "../lib/solver.h"
+#include "../lib/stream.h"
+#include "../lib/cache.h"
+#define CACHE_NAME "05a"
 #define DELIMITERS " "
-#define FUNCTION_RANGES_CAPACITY 64
-#define LIST_CAPACITY 32
 
 struct Range
 {
@@ -22,18 +21,19 @@ struct Range
 
 struct Function
 {
-    struct Range ranges[FUNCTION_RANGES_CAPACITY];
+    struct Range* ranges;
     int count;
+    int capacity;
 };
 
 struct List
 {
-    long long items[LIST_CAPACITY];
+    long long* items;
     int count;
+    int capacity;
 };
 
 typedef const void* Object;
-typedef char* String;
 typedef struct Range* Range;
 typedef struct Function* Function;
 typedef struct List* List;
@@ -73,11 +73,35 @@ int range_compare(Object left, Object right)
 
 void function(Function instance)
 {
+    instance->ranges = NULL;
     instance->count = 0;
+    instance->capacity = 0;
 }
 
 Range function_new_range(Function instance)
 {
+    if (instance->count == instance->capacity)
+    {
+        int newCapacity = instance->capacity * 2;
+
+        if (!newCapacity)
+        {
+            newCapacity = 8;
+        }
+
+        Range newRanges = realloc(
+            instance->ranges,
+            newCapacity * sizeof * newRanges);
+
+        if (!newRanges)
+        {
+            return NULL;
+        }
+
+        instance->ranges = newRanges;
+        instance->capacity = newCapacity;
+    }
+
     Range result = instance->ranges + instance->count;
 
     instance->count++;
@@ -94,15 +118,56 @@ void function_sort_ranges(Function instance)
         range_compare);
 }
 
+void function_clear(Function instance)
+{
+    instance->count = 0;
+}
+
+void finalize_function(Function instance)
+{
+    free(instance->ranges);
+}
+
 void list(List instance)
 {
+    instance->items = NULL;
     instance->count = 0;
+    instance->capacity = 0;
 }
 
-void list_add(List instance, long long item)
+bool list_add(List instance, long long item)
 {
+    if (instance->count == instance->capacity)
+    {
+        int newCapacity = instance->capacity * 2;
+
+        if (!newCapacity)
+        {
+            newCapacity = 8;
+        }
+
+        long long* newItems = realloc(
+            instance->items,
+            newCapacity * sizeof * newItems);
+
+        if (!newItems)
+        {
+            return false;
+        }
+
+        instance->items = newItems;
+        instance->capacity = newCapacity;
+    }
+
     instance->items[instance->count] = item;
     instance->count++;
+
+    return true;
+}
+
+void finalize_list(List instance)
+{
+    free(instance->items);
 }
 
 static Range search(Function function, long long value)
@@ -133,6 +198,8 @@ static Range search(Function function, long long value)
     return hi;
 }
 
+// Maps every seed through a function whose ranges are sorted by source offset.
+
 static void realize(Function f, List seeds)
 {
     if (f->count == 0)
@@ -140,12 +207,16 @@ static void realize(Function f, List seeds)
         return;
     }
 
-    function_sort_ranges(f);
-
     for (long long* p = seeds->items; p < seeds->items + seeds->count; p++)
     {
         long long input = *p;
         Range range = search(f, input);
+
+        if (range < f->ranges)
+        {
+            continue;
+        }
+
         long long offset = range->sourceOffset;
 
         if (input >= offset && input < offset + range->length)
@@ -153,84 +224,262 @@ static void realize(Function f, List seeds)
             *p = input - offset + range->destinationOffset;
         }
     }
+}
+
+// Appends the count and the ranges of a sorted function to the compiled input.
+
+static bool compile(List compiled, Function f)
+{
+    if (!list_add(compiled, f->count))
+    {
+        return false;
+    }
+
+    for (Range range = f->ranges; range < f->ranges + f->count; range++)
+    {
+        if (!list_add(compiled, range->destinationOffset) ||
+            !list_add(compiled, range->sourceOffset) ||
+            !list_add(compiled, range->length))
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+// Sorts a function that has been read, appends it to the compiled input unless
+// `compiled` is NULL, maps the seeds through it, and clears it for the next
+// function. Returns false if the compiled input cannot grow.
+
+static bool finish(Function f, List seeds, List compiled)
+{
+    if (f->count == 0)
+    {
+        return true;
+    }
 
-    function(f);
+    function_sort_ranges(f);
+
+    bool result = !compiled || compile(compiled, f);
+
+    realize(f, seeds);
+    function_clear(f);
+
+    return result;
 }
 
-static bool read(Function function, char buffer[])
+static Exception read_range(Function function, StringView line)
 {
-    String token = strtok(buffer, DELIMITERS);
+    struct StringView token;
 
-    if (!token)
+    if (!string_view_next_token(line, DELIMITERS, &token))
     {
-        return false;
+        return EXCEPTION_FORMAT;
     }
 
     Range range = function_new_range(function);
 
-    range->destinationOffset = atoll(token);
-    token = strtok(NULL, DELIMITERS);
+    if (!range)
+    {
+        return EXCEPTION_OUT_OF_MEMORY;
+    }
 
-    if (!token)
+    range->destinationOffset = string_view_to_long(&token);
+
+    if (!string_view_next_token(line, DELIMITERS, &token))
     {
-        return false;
+        return EXCEPTION_FORMAT;
     }
 
-    range->sourceOffset = atoll(token);
-    token = strtok(NULL, DELIMITERS);
+    range->sourceOffset = string_view_to_long(&token);
 
-    if (!token)
+    if (!string_view_next_token(line, DELIMITERS, &token))
     {
-        return false;
+        return EXCEPTION_FORMAT;
     }
 
-    range->length = atoll(token);
+    range->length = string_view_to_long(&token);
 
-    return true;
+    return EXCEPTION_NONE;
 }
 
-int main(void)
+static Exception read(const char* input, size_t length, List seeds)
 {
-    char buffer[BUFFER_SIZE];
-    clock_t start = clock();
+    struct Stream reader;
+    struct StringView line;
+    struct StringView token;
 
-    if (!fgets(buffer, sizeof buffer, stdin) || !strtok(buffer, DELIMITERS))
-    {
-        fprintf(stderr, "Error: Format.\n");
+    stream(&reader, input, length);
 
-        return 1;
+    if (!stream_next_line(&reader, &line) ||
+        !string_view_next_token(&line, DELIMITERS, &token))
+    {
+        return EXCEPTION_FORMAT;
     }
 
-    String token;
-    struct List seeds;
+    struct List compiled;
     struct Function current;
+    List target = NULL;
+    Exception exception = EXCEPTION_NONE;
 
-    list(&seeds);
+    list(&compiled);
     function(&current);
 
-    while ((token = strtok(NULL, DELIMITERS)))
+    while (!exception && string_view_next_token(&line, DELIMITERS, &token))
     {
-        list_add(&seeds, atoll(token));
+        if (!list_add(seeds, string_view_to_long(&token)))
+        {
+            exception = EXCEPTION_OUT_OF_MEMORY;
+        }
     }
 
-    while (fgets(buffer, sizeof buffer, stdin))
+    // The compiled input is the seeds followed by each function, sorted. It
+    // is abandoned if memory runs out, since the cache is optional.
+
+    if (!exception && cache_enabled() && list_add(&compiled, seeds->count))
     {
-        if (buffer[0] == '\n')
+        target = &compiled;
+
+        for (int i = 0; target && i < seeds->count; i++)
+        {
+            if (!list_add(target, seeds->items[i]))
+            {
+                target = NULL;
+            }
+        }
+    }
+
+    while (!exception && stream_next_line(&reader, &line))
+    {
+        if (line.begin == line.end)
         {
             continue;
         }
 
-        if (strchr(buffer, ':'))
+        if (memchr(line.begin, ':', line.end - line.begin))
+        {
+            if (!finish(&current, seeds, target))
+            {
+                target = NULL;
+            }
+
+            continue;
+        }
+
+        exception = read_range(&current, &line);
+    }
+
+    if (!exception && !finish(&current, seeds, target))
+    {
+        target = NULL;
+    }
+
+    if (!exception && target)
+    {
+        cache_store(
+            CACHE_NAME,
+            input,
+            length,
+            compiled.items,
+            compiled.count * sizeof * compiled.items);
+    }
+
+    finalize_list(&compiled);
+    finalize_function(&current);
+
+    return exception;
+}
+
+static Exception load(Cache cache, List seeds)
+{
+    const long long* p = cache->data;
+    const long long* end = p + cache->size / sizeof * p;
+
+    if (cache->size % sizeof * p || p == end || *p < 0 || *p > end - p - 1)
+    {
+        return EXCEPTION_FORMAT;
+    }
+
+    const long long* seedsEnd = p + 1 + *p;
+
+    for (p++; p < seedsEnd; p++)
+    {
+        if (!list_add(seeds, *p))
+        {
+            return EXCEPTION_OUT_OF_MEMORY;
+        }
+    }
+
+    struct Function current;
+    Exception exception = EXCEPTION_NONE;
+
+    function(&current);
+
+    while (!exception && p < end)
+    {
+        long long count = *p;
+
+        p++;
+
+        if (count < 0 || count > (end - p) / 3)
         {
-            realize(&current, &seeds);
+            exception = EXCEPTION_FORMAT;
 
             continue;
         }
 
-        read(&current, buffer);
+        for (long long i = 0; !exception && i < count; i++)
+        {
+            Range range = function_new_range(&current);
+
+            if (!range)
+            {
+                exception = EXCEPTION_OUT_OF_MEMORY;
+
+                continue;
+            }
+
+            range->destinationOffset = p[0];
+            range->sourceOffset = p[1];
+            range->length = p[2];
+            p += 3;
+        }
+
+        realize(&current, seeds);
+        function_clear(&current);
+    }
+
+    finalize_function(&current);
+
+    return exception;
+}
+
+Exception solve(const char* input, size_t length, long long* result)
+{
+    Exception exception;
+    struct Cache cache;
+    struct List seeds;
+
+    list(&seeds);
+
+    if (cache_load(&cache, CACHE_NAME, input, length))
+    {
+        exception = load(&cache, &seeds);
+
+        finalize_cache(&cache);
+    }
+    else
+    {
+        exception = read(input, length, &seeds);
     }
 
-    realize(&current, &seeds);
+    if (exception)
+    {
+        finalize_list(&seeds);
+
+        return exception;
+    }
 
     long long min = LLONG_MAX;
     
@@ -244,5 +493,14 @@ int main(void)
         }
     }
 
-    printf("05a %lld %lf\n", min, (double)(clock() - start) / CLOCKS_PER_SEC);
+    finalize_list(&seeds);
+
+    *result = min;
+
+    return EXCEPTION_NONE;
+}
+
+int main(void)
+{
+    return solver_main("05a", solve);
 }
@@ -8,16 +8,12 @@
 // Compile with:                                    -fno-strict-overflow -fwrapv
 
 #include <limits.h> 
-#include <stdio.h>
 #include <stdbool.h>
 #include <stdlib.h>
 #include <string.h>
-#include <time.h>
-#define BUFFER_SIZE 256
+#include "../lib/solver.h"
+#include "../lib/stream.h"
 #define DELIMITERS " "
-#define EXCEPTION_FORMAT "Error: Format.\n"
-#define FUNCTION_RANGES_CAPACITY 512
-#define INTERVAL_LIST_CAPACITY 32
 
 struct Range
 {
@@ -28,8 +24,9 @@ struct Range
 
 struct Function
 {
-    struct Range ranges[FUNCTION_RANGES_CAPACITY];
+    struct Range* ranges;
     int count;
+    int capacity;
 };
 
 struct Interval
@@ -40,14 +37,13 @@ struct Interval
 
 struct IntervalList
 {
-    struct Interval items[INTERVAL_LIST_CAPACITY];
+    struct Interval* items;
     int count;
+    int capacity;
 };
 
 typedef const void* Object;
-typedef char* String;
 typedef struct Range* Range;
-typedef struct Range* RangeArray;
 typedef struct Function* Function;
 typedef struct Interval* Interval;
 typedef struct IntervalList* IntervalList;
@@ -123,11 +119,35 @@ long long math_max(long long a, long long b)
 
 void function(Function instance)
 {
+    instance->ranges = NULL;
     instance->count = 0;
+    instance->capacity = 0;
 }
 
 Range function_new_range(Function instance)
 {
+    if (instance->count == instance->capacity)
+    {
+        int newCapacity = instance->capacity * 2;
+
+        if (!newCapacity)
+        {
+            newCapacity = 8;
+        }
+
+        Range newRanges = realloc(
+            instance->ranges,
+            newCapacity * sizeof * newRanges);
+
+        if (!newRanges)
+        {
+            return NULL;
+        }
+
+        instance->ranges = newRanges;
+        instance->capacity = newCapacity;
+    }
+
     Range result = instance->ranges + instance->count;
 
     instance->count++;
@@ -135,10 +155,18 @@ Range function_new_range(Function instance)
     return result;
 }
 
-void function_add_range(Function instance, Range item)
+bool function_add_range(Function instance, Range item)
 {
-    instance->ranges[instance->count] = *item;
-    instance->count++;
+    Range result = function_new_range(instance);
+
+    if (!result)
+    {
+        return false;
+    }
+
+    *result = *item;
+
+    return true;
 }
 
 void function_sort_ranges(Function instance)
@@ -150,15 +178,12 @@ void function_sort_ranges(Function instance)
         range_compare);
 }
 
-void function_get_ranges(Function instance, RangeArray results)
+void finalize_function(Function instance)
 {
-    memcpy(
-        results,
-        instance->ranges, 
-        instance->count * sizeof * instance->ranges);
+    free(instance->ranges);
 }
 
-void function_fill_ranges(Function instance)
+bool function_fill_ranges(Function instance)
 {
     int count = instance->count;
 
@@ -166,29 +191,48 @@ void function_fill_ranges(Function instance)
     {
         Range infinity = function_new_range(instance);
 
+        if (!infinity)
+        {
+            return false;
+        }
+
         infinity->sourceOffset = 0;
         infinity->destinationOffset = 0;
         infinity->length = LLONG_MAX;
 
-        return;
+        return true;
     }
 
-    struct Range view[FUNCTION_RANGES_CAPACITY];
+    struct Function view = *instance;
 
-    function_sort_ranges(instance);
-    function_get_ranges(instance, view);
+    function_sort_ranges(&view);
     function(instance);
 
-    Range first = view;
-    Range last = view + count - 1;
+    Range identity;
+    Range first = view.ranges;
+    Range last = view.ranges + count - 1;
     long long min = first->sourceOffset;
 
     if (min)
     {
-        range_identity(LLONG_MIN, min, function_new_range(instance));
+        identity = function_new_range(instance);
+
+        if (!identity)
+        {
+            finalize_function(&view);
+
+            return false;
+        }
+
+        range_identity(LLONG_MIN, min, identity);
     }
 
-    function_add_range(instance, first);
+    if (!function_add_range(instance, first))
+    {
+        finalize_function(&view);
+
+        return false;
+    }
 
     for (Range current = first + 1; current <= last; current++)
     {
@@ -200,32 +244,56 @@ void function_fill_ranges(Function instance)
 
         if (difference > 1)
         {
+            identity = function_new_range(instance);
+
+            if (!identity)
+            {
+                finalize_function(&view);
+
+                return false;
+            }
+
             range_identity(
                 previousMax + 1,
                 currentMin + current->length,
-                function_new_range(instance));
+                identity);
         }
 
-        function_add_range(instance, current);
+        if (!function_add_range(instance, current))
+        {
+            finalize_function(&view);
+
+            return false;
+        }
     }
 
     long long lastMax = last->sourceOffset + last->length;
 
+    finalize_function(&view);
+
     if (lastMax < LLONG_MAX)
     {
-        range_identity(lastMax + 1, LLONG_MAX, function_new_range(instance));
+        identity = function_new_range(instance);
+
+        if (!identity)
+        {
+            return false;
+        }
+
+        range_identity(lastMax + 1, LLONG_MAX, identity);
     }
+
+    return true;
 }
 
-void function_compose(Function instance, Function other)
+bool function_compose(Function instance, Function other)
 {
-    struct Range view[FUNCTION_RANGES_CAPACITY];
-    Range last = view + instance->count - 1;
+    struct Function view = *instance;
+    Range last = view.ranges + view.count - 1;
 
-    function_get_ranges(instance, view);
     function(instance);
 
-    for (Range a = view; a <= last; a++)
+    for (Range a = view.ranges; a <= last; a++)
     {
         for (Range b = other->ranges; b < other->ranges + other->count; b++)
         {
@@ -241,159 +309,233 @@ void function_compose(Function instance, Function other)
                 continue;
             }
 
+            Range composite = function_new_range(instance);
+
+            if (!composite)
+            {
+                finalize_function(&view);
+
+                return false;
+            }
+
             range_from_interval(
                 math_max(aMin, bMin),
                 math_min(aMax, bMax),
                 a->destinationOffset - a->sourceOffset +
                 b->destinationOffset - b->sourceOffset,
-                function_new_range(instance));
+                composite);
         }
     }
+
+    finalize_function(&view);
+
+    return true;
 }
 
 void interval_list(IntervalList instance)
 {
+    instance->items = NULL;
     instance->count = 0;
+    instance->capacity = 0;
 }
 
-void interval_list_add(IntervalList instance, Interval item)
+bool interval_list_add(IntervalList instance, Interval item)
 {
+    if (instance->count == instance->capacity)
+    {
+        int newCapacity = instance->capacity * 2;
+
+        if (!newCapacity)
+        {
+            newCapacity = 8;
+        }
+
+        Interval newItems = realloc(
+            instance->items,
+            newCapacity * sizeof * newItems);
+
+        if (!newItems)
+        {
+            return false;
+        }
+
+        instance->items = newItems;
+        instance->capacity = newCapacity;
+    }
+
     instance->items[instance->count] = *item;
     instance->count++;
+
+    return true;
 }
 
-static bool read(Function function, char buffer[])
+void finalize_interval_list(IntervalList instance)
 {
-    String token = strtok(buffer, DELIMITERS);
+    free(instance->items);
+}
 
-    if (!token)
+static Exception read(Function function, StringView line)
+{
+    struct StringView token;
+
+    if (!string_view_next_token(line, DELIMITERS, &token))
     {
-        return false;
+        return EXCEPTION_FORMAT;
     }
 
     Range range = function_new_range(function);
 
-    range->destinationOffset = atoll(token);
-    token = strtok(NULL, DELIMITERS);
+    if (!range)
+    {
+        return EXCEPTION_OUT_OF_MEMORY;
+    }
 
-    if (!token)
+    range->destinationOffset = string_view_to_long(&token);
+
+    if (!string_view_next_token(line, DELIMITERS, &token))
     {
-        return false;
+        return EXCEPTION_FORMAT;
     }
 
-    range->sourceOffset = atoll(token);
-    token = strtok(NULL, DELIMITERS);
+    range->sourceOffset = string_view_to_long(&token);
 
-    if (!token)
+    if (!string_view_next_token(line, DELIMITERS, &token))
     {
-        return false;
+        return EXCEPTION_FORMAT;
     }
 
-    range->length = atoll(token);
+    range->length = string_view_to_long(&token);
 
-    return true;
+    return EXCEPTION_NONE;
 }
 
-int main(void)
+static Exception realize(Function composite, Function current)
 {
-    char buffer[BUFFER_SIZE];
-    clock_t start = clock();
+    solver_phase("fill");
 
-    if (!fgets(buffer, sizeof buffer, stdin) || !strtok(buffer, DELIMITERS))
+    if (!function_fill_ranges(current))
     {
-        fprintf(stderr, EXCEPTION_FORMAT);
+        return EXCEPTION_OUT_OF_MEMORY;
+    }
 
-        return 1;
+    if (!composite->count)
+    {
+        finalize_function(composite);
+
+        *composite = *current;
+
+        function(current);
+
+        return EXCEPTION_NONE;
+    }
+
+    solver_phase("compose");
+
+    bool composed = function_compose(composite, current);
+
+    finalize_function(current);
+    function(current);
+
+    if (!composed)
+    {
+        return EXCEPTION_OUT_OF_MEMORY;
+    }
+
+    return EXCEPTION_NONE;
+}
+
+Exception solve(const char* input, size_t length, long long* result)
+{
+    struct Stream reader;
+    struct StringView line;
+    struct StringView token;
+
+    stream(&reader, input, length);
+
+    if (!stream_next_line(&reader, &line) ||
+        !string_view_next_token(&line, DELIMITERS, &token))
+    {
+        return EXCEPTION_FORMAT;
     }
 
-    String token;
     struct IntervalList seeds;
+    struct Function current;
+    struct Function composite;
+    Exception exception = EXCEPTION_NONE;
 
     interval_list(&seeds);
+    function(&current);
+    function(&composite);
 
-    while ((token = strtok(NULL, DELIMITERS)))
+    while (!exception && string_view_next_token(&line, DELIMITERS, &token))
     {
-        long long offset = atoll(token);
+        long long offset = string_view_to_long(&token);
 
-        token = strtok(NULL, DELIMITERS);
-
-        if (!token)
+        if (!string_view_next_token(&line, DELIMITERS, &token))
         {
-            fprintf(stderr, EXCEPTION_FORMAT);
+            exception = EXCEPTION_FORMAT;
 
-            return 1;
+            break;
         }
 
         struct Interval interval =
         {
             .min = offset,
-            .max = offset + atoll(token)
+            .max = offset + string_view_to_long(&token)
         };
 
-        interval_list_add(&seeds, &interval);
+        if (!interval_list_add(&seeds, &interval))
+        {
+            exception = EXCEPTION_OUT_OF_MEMORY;
+        }
     }
 
-    struct Function current;
-    struct Function composite;
-
-    function(&current);
-    function(&composite);
-
-    while (fgets(buffer, sizeof buffer, stdin))
+    while (!exception && stream_next_line(&reader, &line))
     {
-        if (buffer[0] == '\n')
+        if (line.begin == line.end)
         {
             continue;
         }
 
-        if (strchr(buffer, ':'))
+        if (memchr(line.begin, ':', line.end - line.begin))
         {
-            if (!current.count)
+            if (current.count)
             {
-                continue;
-            }
-
-            function_fill_ranges(&current);
-
-            if (!composite.count)
-            {
-                composite = current;
-
-                function(&current);
+                exception = realize(&composite, &current);
 
-                continue;
+                solver_phase("parse");
             }
 
-            function_compose(&composite, &current);
-            function(&current);
-
             continue;
         }
 
-        if (!read(&current, buffer))
-        {
-            fprintf(stderr, EXCEPTION_FORMAT);
-
-            return 1;
-        }
+        exception = read(&current, &line);
     }
 
-    if (!composite.count)
+    if (!exception && !composite.count)
     {
-        fprintf(stderr, EXCEPTION_FORMAT);
+        exception = EXCEPTION_FORMAT;
+    }
 
-        return 1;
+    if (!exception && current.count)
+    {
+        exception = realize(&composite, &current);
     }
 
-    if (current.count)
+    finalize_function(&current);
+
+    if (exception)
     {
-        function_fill_ranges(&current);
-        function_compose(&composite, &current);
-        function(&current);
+        finalize_interval_list(&seeds);
+        finalize_function(&composite);
+
+        return exception;
     }
 
     long long min = LLONG_MAX;
 
+    solver_phase("query");
+
     for (Interval seed = seeds.items; seed < seeds.items + seeds.count; seed++)
     {
         long long seedMin = seed->min;
@@ -420,6 +562,16 @@ int main(void)
             }
         }
     }
-    
-    printf("05b %lld %lf\n", min, (double)(clock() - start) / CLOCKS_PER_SEC);
+
+    finalize_interval_list(&seeds);
+    finalize_function(&composite);
+
+    *result = min;
+
+    return EXCEPTION_NONE;
+}
+
+int main(void)
+{
+    return solver_main("05b", solve);
 }
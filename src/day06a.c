@@ -3,79 +3,51 @@
 // Wait For It Part 1
 
 #include <math.h>
-#include <stdio.h>
-#include <stdlib.h>
-#include <string.h>
-#include <time.h>
-#define BUFFER_SIZE 64
+#include "../lib/solver.h"
+#include "../lib/stream.h"
 #define DELIMITERS " "
-#define EXCEPTION_FORMAT "Error: Format.\n"
-#define POINTS_CAPACITY 4
 
-struct Point
+Exception solve(const char* input, size_t length, long long* result)
 {
-    int time;
-    int distance;
-};
+    struct StringView token;
+    struct StringView times;
+    struct StringView distances;
+    struct Stream reader;
 
-typedef char* String;
+    stream(&reader, input, length);
 
-int main(void)
-{
-    String token;
-    char buffer[BUFFER_SIZE];
-    clock_t start = clock();
-
-    if (!fgets(buffer, sizeof buffer, stdin) || !strtok(buffer, DELIMITERS))
-    {
-        fprintf(stderr, EXCEPTION_FORMAT);
-
-        return 1;
-    }
-
-    int pointCount = 0;
-    struct Point points[POINTS_CAPACITY];
-
-    while ((token = strtok(NULL, DELIMITERS)))
+    if (!stream_next_line(&reader, &times) ||
+        !string_view_next_token(&times, DELIMITERS, &token) ||
+        !stream_next_line(&reader, &distances) ||
+        !string_view_next_token(&distances, DELIMITERS, &token))
     {
-        points[pointCount].time = atoi(token);
-        pointCount++;
+        return EXCEPTION_FORMAT;
     }
 
-    if (!fgets(buffer, sizeof buffer, stdin) || !strtok(buffer, DELIMITERS))
-    {
-        fprintf(stderr, EXCEPTION_FORMAT);
-
-        return 1;
-    }
+    long product = 1;
 
-    for (int i = 0; i < pointCount; i++)
+    while (string_view_next_token(&times, DELIMITERS, &token))
     {
-        token = strtok(NULL, DELIMITERS);
+        int t = string_view_to_long(&token);
 
-        if (!token)
+        if (!string_view_next_token(&distances, DELIMITERS, &token))
         {
-            fprintf(stderr, EXCEPTION_FORMAT);
-
-            return 1;
+            return EXCEPTION_FORMAT;
         }
 
-        points[i].distance = atoi(token);
-    }
-
-    long result = 1;
-
-    for (int i = 0; i < pointCount; i++)
-    {
-        int t = points[i].time;
-        int dx = points[i].distance;
+        int dx = string_view_to_long(&token);
 
-        result *= ceil((t + sqrt(t * t - 4 * dx)) / 2)
+        product *= ceil((t + sqrt(t * t - 4 * dx)) / 2)
             - floor((t - sqrt(t * t - 4 * dx)) / 2)
             - 1;
     }
 
-    printf("06a %ld %lf\n", result, (double)(clock() - start) / CLOCKS_PER_SEC);
+    *result = product;
+
+    return EXCEPTION_NONE;
+}
 
-    return 0;
+int main(void)
+{
+    return solver_main("06a", solve);
 }
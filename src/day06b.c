@@ -5,22 +5,21 @@
 #include <math.h>
 #include <ctype.h>
 #include <stdbool.h>
-#include <stdio.h>
-#include <time.h>
-#define BUFFER_SIZE 64
+#include "../lib/solver.h"
+#include "../lib/stream.h"
 
-static bool read(FILE* stream, long long* result)
+static bool read(Stream reader, long long* result)
 {
-    char buffer[BUFFER_SIZE];
+    struct StringView line;
 
-    if (!fgets(buffer, sizeof buffer, stream))
+    if (!stream_next_line(reader, &line))
     {
         return false;
     }
 
     long long number = 0;
 
-    for (char* p = buffer; *p; p++)
+    for (const char* p = line.begin; p < line.end; p++)
     {
         if (!isdigit(*p))
         {
@@ -35,24 +34,27 @@ static bool read(FILE* stream, long long* result)
     return true;
 }
 
-int main(void)
+Exception solve(const char* input, size_t length, long long* result)
 {
     long long t;
     long long dx;
-    clock_t start = clock();
+    struct Stream reader;
 
-    if (!read(stdin, &t) || !read(stdin, &dx))
-    {
-        fprintf(stderr, "Error: Format.\n");
+    stream(&reader, input, length);
 
-        return 1;
+    if (!read(&reader, &t) || !read(&reader, &dx))
+    {
+        return EXCEPTION_FORMAT;
     }
 
-    long long result = ceil((t + sqrt(t * t - 4 * dx)) / 2)
+    *result = ceil((t + sqrt(t * t - 4 * dx)) / 2)
         - floor((t - sqrt(t * t - 4 * dx)) / 2)
         - 1;
 
-    printf("06b %lld %lf\n", result, (double)(clock() - start) / CLOCKS_PER_SEC);
+    return EXCEPTION_NONE;
+}
 
-    return 0;
+int main(void)
+{
+    return solver_main("06b", solve);
 }
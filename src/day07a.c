@@ -3,15 +3,11 @@
 // Camel Cards Part 1
 
 #include <stdbool.h>
-#include <stdio.h>
 #include <stdlib.h>
-#include <string.h>
-#include <time.h>
-#define BUFFER_SIZE 16
+#include "../lib/solver.h"
+#include "../lib/stream.h"
 #define DELIMITERS " "
-#define EXCEPTION_FORMAT "Error: Format.\n"
 #define HAND_SIZE 5
-#define PLAYER_LIST_CAPACITY 1024
 
 enum Card
 {
@@ -59,8 +55,9 @@ struct Player
 
 struct PlayerList
 {
-    struct Player items[PLAYER_LIST_CAPACITY];
+    struct Player* items;
     int count;
+    int capacity;
 };
 
 typedef const void* Object;
@@ -175,11 +172,35 @@ int player_compare(Object left, Object right)
 
 void player_list(PlayerList instance)
 {
+    instance->items = NULL;
     instance->count = 0;
+    instance->capacity = 0;
 }
 
 Player player_list_new_player(PlayerList instance)
 {
+    if (instance->count == instance->capacity)
+    {
+        int newCapacity = instance->capacity * 2;
+
+        if (!newCapacity)
+        {
+            newCapacity = 64;
+        }
+
+        Player newItems = realloc(
+            instance->items,
+            newCapacity * sizeof * newItems);
+
+        if (!newItems)
+        {
+            return NULL;
+        }
+
+        instance->items = newItems;
+        instance->capacity = newCapacity;
+    }
+
     Player result = instance->items + instance->count;
 
     instance->count++;
@@ -189,6 +210,11 @@ Player player_list_new_player(PlayerList instance)
 
 void player_list_sort(PlayerList instance)
 {
+    if (!instance->count)
+    {
+        return;
+    }
+
     qsort(
         instance->items,
         instance->count,
@@ -196,37 +222,51 @@ void player_list_sort(PlayerList instance)
         player_compare);
 }
 
-int main(void)
+void finalize_player_list(PlayerList instance)
+{
+    free(instance->items);
+}
+
+Exception solve(const char* input, size_t length, long long* result)
 {
     struct PlayerList players;
-    char buffer[BUFFER_SIZE];
-    clock_t start = clock();
+    struct Stream reader;
+    struct StringView line;
 
+    stream(&reader, input, length);
     player_list(&players);
 
-    while (fgets(buffer, sizeof buffer, stdin))
+    while (stream_next_line(&reader, &line))
     {
-        String token = strtok(buffer, DELIMITERS);
+        struct StringView token;
 
-        if (!token)
+        if (!string_view_next_token(&line, DELIMITERS, &token) ||
+            token.end - token.begin < HAND_SIZE)
         {
-            fprintf(stderr, EXCEPTION_FORMAT);
+            finalize_player_list(&players);
 
-            return 1;
+            return EXCEPTION_FORMAT;
         }
 
         struct Hand hand = { 0 };
         Player player = player_list_new_player(&players);
 
+        if (!player)
+        {
+            finalize_player_list(&players);
+
+            return EXCEPTION_OUT_OF_MEMORY;
+        }
+
         for (int i = 0; i < HAND_SIZE; i++)
         {
-            Card drawn = card(token[i]);
+            Card drawn = card(token.begin[i]);
 
             if (drawn == CARD_NONE)
             {
-                fprintf(stderr, EXCEPTION_FORMAT);
+                finalize_player_list(&players);
 
-                return 1;
+                return EXCEPTION_FORMAT;
             }
 
             hand_add(&hand, drawn);
@@ -236,17 +276,16 @@ int main(void)
 
         HandType handType = hand_get_type(&hand);
 
-        token = strtok(NULL, DELIMITERS);
-
-        if (!token || handType == HAND_TYPE_NONE)
+        if (!string_view_next_token(&line, DELIMITERS, &token) ||
+            handType == HAND_TYPE_NONE)
         {
-            fprintf(stderr, EXCEPTION_FORMAT);
+            finalize_player_list(&players);
 
-            return 1;
+            return EXCEPTION_FORMAT;
         }
 
         player->handType = handType;
-        player->bid = atoi(token);
+        player->bid = string_view_to_long(&token);
     }
 
     player_list_sort(&players);
@@ -258,7 +297,14 @@ int main(void)
         sum += (players.count - i) * players.items[i].bid;
     }
 
-    printf("07a %ld %lf\n", sum, (double)(clock() - start) / CLOCKS_PER_SEC);
+    finalize_player_list(&players);
 
-    return 0;
+    *result = sum;
+
+    return EXCEPTION_NONE;
+}
+
+int main(void)
+{
+    return solver_main("07a", solve);
 }
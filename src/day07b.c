@@ -3,14 +3,10 @@
 // Camel Cards Part 2
 
 #include <stdbool.h>
-#include <stdio.h>
 #include <stdlib.h>
-#include <string.h>
-#include <time.h>
-#define BUFFER_SIZE 16
+#include "../lib/solver.h"
+#include "../lib/stream.h"
 #define DELIMITERS " "
-#define EXCEPTION_FORMAT "Error: Format.\n"
-#define B_PLAYER_LIST_CAPACITY 1024
 #define HAND_SIZE 5
 
 enum BCard
@@ -58,8 +54,9 @@ struct BPlayer
 
 struct BPlayerList
 {
-    struct BPlayer items[B_PLAYER_LIST_CAPACITY];
+    struct BPlayer* items;
     int count;
+    int capacity;
 };
 
 typedef const void* Object;
@@ -188,11 +185,35 @@ int b_player_compare(Object left, Object right)
 
 void b_player_list(BPlayerList instance)
 {
+    instance->items = NULL;
     instance->count = 0;
+    instance->capacity = 0;
 }
 
 BPlayer b_player_list_new_player(BPlayerList instance)
 {
+    if (instance->count == instance->capacity)
+    {
+        int newCapacity = instance->capacity * 2;
+
+        if (!newCapacity)
+        {
+            newCapacity = 64;
+        }
+
+        BPlayer newItems = realloc(
+            instance->items,
+            newCapacity * sizeof * newItems);
+
+        if (!newItems)
+        {
+            return NULL;
+        }
+
+        instance->items = newItems;
+        instance->capacity = newCapacity;
+    }
+
     BPlayer result = instance->items + instance->count;
 
     instance->count++;
@@ -202,6 +223,11 @@ BPlayer b_player_list_new_player(BPlayerList instance)
 
 void b_player_list_sort(BPlayerList instance)
 {
+    if (!instance->count)
+    {
+        return;
+    }
+
     qsort(
         instance->items,
         instance->count,
@@ -209,37 +235,51 @@ void b_player_list_sort(BPlayerList instance)
         b_player_compare);
 }
 
-int main(void)
+void finalize_b_player_list(BPlayerList instance)
+{
+    free(instance->items);
+}
+
+Exception solve(const char* input, size_t length, long long* result)
 {
     struct BPlayerList players;
-    char buffer[BUFFER_SIZE];
-    clock_t start = clock();
+    struct Stream reader;
+    struct StringView line;
 
+    stream(&reader, input, length);
     b_player_list(&players);
 
-    while (fgets(buffer, sizeof buffer, stdin))
+    while (stream_next_line(&reader, &line))
     {
-        String token = strtok(buffer, DELIMITERS);
+        struct StringView token;
 
-        if (!token)
+        if (!string_view_next_token(&line, DELIMITERS, &token) ||
+            token.end - token.begin < HAND_SIZE)
         {
-            fprintf(stderr, EXCEPTION_FORMAT);
+            finalize_b_player_list(&players);
 
-            return 1;
+            return EXCEPTION_FORMAT;
         }
 
         struct BHand current = { 0 };
         BPlayer player = b_player_list_new_player(&players);
 
+        if (!player)
+        {
+            finalize_b_player_list(&players);
+
+            return EXCEPTION_OUT_OF_MEMORY;
+        }
+
         for (int i = 0; i < HAND_SIZE; i++)
         {
-            BCard drawn = b_card(token[i]);
+            BCard drawn = b_card(token.begin[i]);
 
             if (drawn == B_CARD_NONE)
             {
-                fprintf(stderr, EXCEPTION_FORMAT);
+                finalize_b_player_list(&players);
 
-                return 1;
+                return EXCEPTION_FORMAT;
             }
 
             b_hand_add(&current, drawn);
@@ -249,17 +289,16 @@ int main(void)
 
         HandType handType = b_hand_get_type(&current);
 
-        token = strtok(NULL, DELIMITERS);
-
-        if (!token || handType == HAND_TYPE_NONE)
+        if (!string_view_next_token(&line, DELIMITERS, &token) ||
+            handType == HAND_TYPE_NONE)
         {
-            fprintf(stderr, EXCEPTION_FORMAT);
+            finalize_b_player_list(&players);
 
-            return 1;
+            return EXCEPTION_FORMAT;
         }
 
         player->handType = handType;
-        player->bid = atoi(token);
+        player->bid = string_view_to_long(&token);
     }
 
     b_player_list_sort(&players);
@@ -271,7 +310,14 @@ int main(void)
         sum += (players.count - i) * players.items[i].bid;
     }
 
-    printf("07b %ld %lf\n", sum, (double)(clock() - start) / CLOCKS_PER_SEC);
+    finalize_b_player_list(&players);
 
-    return 0;
+    *result = sum;
+
+    return EXCEPTION_NONE;
+}
+
+int main(void)
+{
+    return solver_main("07b", solve);
 }
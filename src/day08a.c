@@ -3,12 +3,10 @@
 // Haunted Wasteland Part 1
 
 #include <stdbool.h>
-#include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
-#include <time.h>
-#define BUFFER_SIZE 32
-#define DIRECTIONS_CAPACITY 512
+#include "../lib/solver.h"
+#include "../lib/stream.h"
 #define VERTEX_OFFSET -13330
 #define VERTEX_LAST 33325
 #define VERTEX_NONE 33326
@@ -33,7 +31,7 @@ void graph_add(Graph instance, long vertex, long left, long right)
     instance->vertices[vertex].right = right;
 }
 
-static bool parse(char buffer[], char window[], long* result)
+static bool parse(const char* buffer, char window[], long* result)
 {
     memcpy(window, buffer, 3);
 
@@ -51,23 +49,24 @@ static bool parse(char buffer[], char window[], long* result)
     return true;
 }
 
-static bool read(FILE* stream, Graph graph)
+static bool read(Stream reader, Graph graph)
 {
-    char buffer[BUFFER_SIZE];
+    struct StringView line;
 
-    if (!fgets(buffer, sizeof buffer, stream))
+    if (!stream_next_line(reader, &line))
     {
         return false;
     }
 
-    while (fgets(buffer, sizeof buffer, stream))
+    while (stream_next_line(reader, &line))
     {
+        const char* buffer = line.begin;
         char window[4];
         long vertex;
         long left;
         long right;
 
-        if (strlen(buffer) < 16 ||
+        if (line.end - line.begin < 15 ||
             !parse(buffer, window, &vertex) ||
             !parse(buffer + 7, window, &left) ||
             !parse(buffer + 12, window, &right))
@@ -81,13 +80,18 @@ static bool read(FILE* stream, Graph graph)
     return true;
 }
 
-static int scan(Graph instance, long start, String directions)
+static int scan(Graph instance, long start, StringView directions)
 {
     int result = 0;
-    char* direction = directions;
+    const char* direction = directions->begin;
 
     while (start != VERTEX_LAST)
     {
+        if (direction == directions->end)
+        {
+            direction = directions->begin;
+        }
+
         switch (*direction)
         {
             case 'L':
@@ -103,7 +107,7 @@ static int scan(Graph instance, long start, String directions)
                 break;
                 
             default:
-                direction = directions;
+                direction++;
                 break;
         }
     }
@@ -111,31 +115,36 @@ static int scan(Graph instance, long start, String directions)
     return result;
 }
 
-int main(void)
+Exception solve(const char* input, size_t length, long long* result)
 {
     Graph graph = malloc(sizeof * graph);
 
     if (!graph)
     {
-        fprintf(stderr, "Error: Out of memory.\n");
-
-        return 1;
+        return EXCEPTION_OUT_OF_MEMORY;
     }
 
-    char directions[DIRECTIONS_CAPACITY];
-    clock_t start = clock();
+    struct Stream reader;
+    struct StringView directions;
 
-    if (!fgets(directions, sizeof directions, stdin) || !read(stdin, graph))
+    stream(&reader, input, length);
+
+    if (!stream_next_line(&reader, &directions) ||
+        !read(&reader, graph))
     {
-        fprintf(stderr, "Error: Format.\n");
+        free(graph);
 
-        return 1;
+        return EXCEPTION_FORMAT;
     }
 
-    int result = scan(graph, 0, directions);
+    *result = scan(graph, 0, &directions);
 
-    printf("08a %d %lf\n", result, (double)(clock() - start) / CLOCKS_PER_SEC);
     free(graph);
 
-    return 0;
+    return EXCEPTION_NONE;
+}
+
+int main(void)
+{
+    return solver_main("08a", solve);
 }
@@ -3,12 +3,10 @@
 // Haunted Wasteland Part 2
 
 #include <stdbool.h>
-#include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
-#include <time.h>
-#define BUFFER_SIZE 32
-#define DIRECTIONS_CAPACITY 512
+#include "../lib/solver.h"
+#include "../lib/stream.h"
 #define LIST_CAPACITY 1296
 #define VERTEX_OFFSET -1342
 #define VERTEX_LAST 45313
@@ -64,13 +62,20 @@ void vertex_list(VertexList instance)
     instance->count = 0;
 }
 
-void vertex_list_add(VertexList instance, long item)
+bool vertex_list_add(VertexList instance, long item)
 {
+    if (instance->count == LIST_CAPACITY)
+    {
+        return false;
+    }
+
     instance->items[instance->count] = item;
     instance->count++;
+
+    return true;
 }
 
-static bool parse(char buffer[], char window[], long* result)
+static bool parse(const char* buffer, char window[], long* result)
 {
     memcpy(window, buffer, 3);
 
@@ -88,23 +93,24 @@ static bool parse(char buffer[], char window[], long* result)
     return true;
 }
 
-static bool read(FILE* stream, Graph graph, VertexList starts)
+static bool read(Stream reader, Graph graph, VertexList starts)
 {
-    char buffer[BUFFER_SIZE];
+    struct StringView line;
 
-    if (!fgets(buffer, sizeof buffer, stream))
+    if (!stream_next_line(reader, &line))
     {
         return false;
     }
 
-    while (fgets(buffer, sizeof buffer, stream))
+    while (stream_next_line(reader, &line))
     {
+        const char* buffer = line.begin;
         char window[4];
         long vertex;
         long left;
         long right;
 
-        if (strlen(buffer) < 16 ||
+        if (line.end - line.begin < 15 ||
             !parse(buffer, window, &vertex) ||
             !parse(buffer + 7, window, &left) ||
             !parse(buffer + 12, window, &right))
@@ -112,9 +118,9 @@ static bool read(FILE* stream, Graph graph, VertexList starts)
             return false;
         }
 
-        if (buffer[2] == 'A')
+        if (buffer[2] == 'A' && !vertex_list_add(starts, vertex))
         {
-            vertex_list_add(starts, vertex);
+            return false;
         }
 
         graph_add(graph, vertex, left, right);
@@ -123,13 +129,18 @@ static bool read(FILE* stream, Graph graph, VertexList starts)
     return true;
 }
 
-static int scan(Graph instance, long start, String directions)
+static int scan(Graph instance, long start, StringView directions)
 {
     int result = 0;
-    String direction = directions;
+    const char* direction = directions->begin;
 
     while (start % 36 != 25)
     {
+        if (direction == directions->end)
+        {
+            direction = directions->begin;
+        }
+
         switch (*direction)
         {
             case 'L':
@@ -145,7 +156,7 @@ static int scan(Graph instance, long start, String directions)
                 break;
 
             default:
-                direction = directions;
+                direction++;
                 break;
         }
     }
@@ -153,40 +164,45 @@ static int scan(Graph instance, long start, String directions)
     return result;
 }
 
-int main(void)
+Exception solve(const char* input, size_t length, long long* result)
 {
     Graph graph = malloc(sizeof * graph);
 
     if (!graph)
     {
-        fprintf(stderr, "Error: Out of memory.\n");
-
-        return 1;
+        return EXCEPTION_OUT_OF_MEMORY;
     }
 
+    struct Stream reader;
     struct VertexList starts;
-    char directions[DIRECTIONS_CAPACITY];
-    clock_t start = clock();
+    struct StringView directions;
 
+    stream(&reader, input, length);
     vertex_list(&starts);
 
-    if (!fgets(directions, sizeof directions, stdin) ||
-        !read(stdin, graph, &starts))
+    if (!stream_next_line(&reader, &directions) ||
+        !read(&reader, graph, &starts))
     {
-        fprintf(stderr, "Error: Format.\n");
+        free(graph);
 
-        return 1;
+        return EXCEPTION_FORMAT;
     }
 
-    long long lcm = scan(graph, starts.items[0], directions);
+    long long lcm = scan(graph, starts.items[0], &directions);
 
     for (long* p = starts.items + 1; p < starts.items + starts.count; p++)
     {
-        lcm = math_lcm(lcm, scan(graph, *p, directions));
+        lcm = math_lcm(lcm, scan(graph, *p, &directions));
     }
 
-    printf("08b %lld %lf\n", lcm, (double)(clock() - start) / CLOCKS_PER_SEC);
+    *result = lcm;
+
     free(graph);
 
-    return 0;
+    return EXCEPTION_NONE;
+}
+
+int main(void)
+{
+    return solver_main("08b", solve);
 }
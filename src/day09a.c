@@ -3,34 +3,69 @@
 // Mirage Maintenance Part 1
 
 #include <math.h>
-#include <stdio.h>
+#include <stdbool.h>
 #include <stdlib.h>
 #include <string.h>
-#include <time.h>
-#define BUFFER_SIZE 128
+#include "../lib/solver.h"
+#include "../lib/stream.h"
 #define DELIMITERS " "
-#define TERMS_CAPACITY 32
 
 struct Series
 {
-    long terms[TERMS_CAPACITY];
+    long* terms;
     int count;
+    int capacity;
 };
 
-typedef char* String;
 typedef struct Series* Series;
 
 void series(Series instance)
 {
+    instance->terms = NULL;
     instance->count = 0;
+    instance->capacity = 0;
 }
 
-void series_add(Series instance, long term)
+bool series_add(Series instance, long term)
 {
     int n = instance->count;
 
+    if (n == instance->capacity)
+    {
+        int newCapacity = n * 2;
+
+        if (!newCapacity)
+        {
+            newCapacity = 32;
+        }
+
+        long* newTerms = realloc(
+            instance->terms,
+            newCapacity * sizeof * newTerms);
+
+        if (!newTerms)
+        {
+            return false;
+        }
+
+        instance->terms = newTerms;
+        instance->capacity = newCapacity;
+    }
+
     instance->terms[n] = term;
     instance->count = n + 1;
+
+    return true;
+}
+
+void series_clear(Series instance)
+{
+    instance->count = 0;
+}
+
+void finalize_series(Series instance)
+{
+    free(instance->terms);
 }
 
 long series_lagrange_extrapolate(Series instance, int k)
@@ -63,37 +98,51 @@ long series_lagrange_next(Series instance)
     return series_lagrange_extrapolate(instance, instance->count);
 }
 
-int main(void)
+Exception solve(const char* input, size_t length, long long* result)
 {
     long sum = 0;
-    char buffer[BUFFER_SIZE];
-    clock_t start = clock();
+    struct Stream reader;
+    struct Series terms;
+    struct StringView line;
+
+    stream(&reader, input, length);
+    series(&terms);
 
-    while (fgets(buffer, sizeof buffer, stdin))
+    while (stream_next_line(&reader, &line))
     {
-        String token = strtok(buffer, DELIMITERS);
+        struct StringView token;
 
-        if (!token)
+        if (!string_view_next_token(&line, DELIMITERS, &token))
         {
-            fprintf(stderr, "Error: Format.\n");
+            finalize_series(&terms);
 
-            return 1;
+            return EXCEPTION_FORMAT;
         }
 
-        struct Series terms;
-
-        series(&terms);
+        series_clear(&terms);
 
         do
         {
-            series_add(&terms, atol(token));
+            if (!series_add(&terms, string_view_to_long(&token)))
+            {
+                finalize_series(&terms);
+
+                return EXCEPTION_OUT_OF_MEMORY;
+            }
         }
-        while ((token = strtok(NULL, DELIMITERS)));
+        while (string_view_next_token(&line, DELIMITERS, &token));
 
         sum += series_lagrange_next(&terms);
     }
 
-    printf("09a %ld %lf\n", sum, (double)(clock() - start) / CLOCKS_PER_SEC);
+    finalize_series(&terms);
 
-    return 0;
+    *result = sum;
+
+    return EXCEPTION_NONE;
+}
+
+int main(void)
+{
+    return solver_main_sharded("09a", solve, SHARD_LINE);
 }
@@ -3,11 +3,10 @@
 // Pipe Maze Part 1
 
 #include <stdbool.h>
-#include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
-#include <time.h>
-#define DIMENSION 141
-#define EXCEPTION_FORMAT "Error: Format.\n"
+#include "../lib/solver.h"
+#include "../lib/stream.h"
 
 struct Coordinate
 {
@@ -20,7 +19,8 @@ struct Matrix
     struct Coordinate origin;
     int rows;
     int columns;
-    char items[(DIMENSION - 1) * (DIMENSION - 1)];
+    int capacity;
+    char* items;
 };
 
 typedef char* Row;
@@ -39,10 +39,17 @@ void matrix(Matrix instance, int n)
 
     instance->rows = 0;
     instance->columns = n;
+    instance->capacity = 0;
+    instance->items = NULL;
 }
 
 char matrix_get(Matrix instance, int i, int j)
 {
+    if (i < 0 || i >= instance->rows || j < 0 || j >= instance->columns)
+    {
+        return '\0';
+    }
+
     return instance->items[(instance->columns * i) + j];
 }
 
@@ -53,16 +60,45 @@ void matrix_set(Matrix instance, int i, int j, char value)
     instance->items[index] = value;
 }
 
-void matrix_add_row(Matrix instance, char values[])
+bool matrix_add_row(Matrix instance, const char values[])
 {
     int m = instance->rows;
 
+    if (m == instance->capacity)
+    {
+        int newCapacity = m * 2;
+
+        if (!newCapacity)
+        {
+            newCapacity = instance->columns;
+        }
+
+        char* newItems = realloc(
+            instance->items,
+            (size_t)newCapacity * instance->columns);
+
+        if (!newItems)
+        {
+            return false;
+        }
+
+        instance->items = newItems;
+        instance->capacity = newCapacity;
+    }
+
     instance->rows = m + 1;
 
     memcpy(
         instance->items + (instance->columns * m),
         values,
         instance->columns);
+
+    return true;
+}
+
+void finalize_matrix(Matrix instance)
+{
+    free(instance->items);
 }
 
 static bool scan_hi(Matrix matrix, Coordinate previous, int i, int j)
@@ -169,25 +205,23 @@ static bool scan(Matrix matrix, Coordinate previous, int i, int j)
     }
 }
 
-int main(void)
+Exception solve(const char* input, size_t length, long long* result)
 {
-    char buffer[DIMENSION + 1];
-    clock_t start = clock();
+    struct Stream reader;
+    struct StringView line;
 
-    if (!fgets(buffer, sizeof buffer, stdin))
-    {
-        fprintf(stderr, EXCEPTION_FORMAT);
+    stream(&reader, input, length);
 
-        return 1;
+    if (!stream_next_line(&reader, &line))
+    {
+        return EXCEPTION_FORMAT;
     }
 
-    int n = strlen(buffer) - 1;
+    int n = line.end - line.begin;
 
     if (n < 1)
     {
-        fprintf(stderr, EXCEPTION_FORMAT);
-
-        return 1;
+        return EXCEPTION_FORMAT;
     }
 
     struct Matrix a;
@@ -196,38 +230,44 @@ int main(void)
 
     do
     {
-        matrix_add_row(&a, buffer);
+        if (line.end - line.begin != n)
+        {
+            finalize_matrix(&a);
 
-        char* token = strchr(buffer, 'S');
+            return EXCEPTION_FORMAT;
+        }
 
-        if (token)
+        if (!matrix_add_row(&a, line.begin))
         {
-            a.origin.i = a.rows - 1;
-            a.origin.j = token - buffer;
+            finalize_matrix(&a);
+
+            return EXCEPTION_OUT_OF_MEMORY;
         }
-    }
-    while (fgets(buffer, n + 2, stdin));
 
-    if (a.origin.i < 0 || a.origin.j < 0)
-    {
-        fprintf(stderr, EXCEPTION_FORMAT);
+        const char* token = memchr(line.begin, 'S', n);
 
-        return 1;
+        if (token)
+        {
+            a.origin.i = a.rows - 1;
+            a.origin.j = token - line.begin;
+        }
     }
+    while (stream_next_line(&reader, &line));
 
     struct Coordinate current = a.origin;
     struct Coordinate previous;
 
     coordinate_empty(&previous);
 
-    if (!scan_hi(&a, &previous, a.origin.i, a.origin.j) &&
+    if (a.origin.i < 0 || a.origin.j < 0 ||
+        (!scan_hi(&a, &previous, a.origin.i, a.origin.j) &&
         !scan_lo(&a, &previous, a.origin.i, a.origin.j) &&
         !scan_left(&a, &previous, a.origin.i, a.origin.j) &&
-        !scan_right(&a, &previous, a.origin.i, a.origin.j))
+        !scan_right(&a, &previous, a.origin.i, a.origin.j)))
     {
-        fprintf(stderr, EXCEPTION_FORMAT);
+        finalize_matrix(&a);
 
-        return 1;
+        return EXCEPTION_FORMAT;
     }
 
     int total = 1;
@@ -245,9 +285,16 @@ int main(void)
         matrix_set(&a, current.i, current.j, 0);
     }
 
+    finalize_matrix(&a);
+
     total /= 2;
 
-    printf("10a %d %lf\n", total, (double)(clock() - start) / CLOCKS_PER_SEC);
+    *result = total;
 
-    return 0;
+    return EXCEPTION_NONE;
+}
+
+int main(void)
+{
+    return solver_main("10a", solve);
 }
@@ -2,11 +2,65 @@
 
 // Cosmic Expansion Part 2
 
-#include <stdio.h>
-#include <time.h>
-#define DIMENSION 141
+#include <stdbool.h>
+#include <stdlib.h>
+#include "../lib/solver.h"
+#include "../lib/stream.h"
 #define SCALE 1000000
 
+struct Histogram
+{
+    long long* items;
+    int capacity;
+};
+
+typedef struct Histogram* Histogram;
+
+void histogram(Histogram instance)
+{
+    instance->items = NULL;
+    instance->capacity = 0;
+}
+
+bool histogram_reserve(Histogram instance, int capacity)
+{
+    if (capacity <= instance->capacity)
+    {
+        return true;
+    }
+
+    int newCapacity = instance->capacity * 2;
+
+    if (newCapacity < capacity)
+    {
+        newCapacity = capacity;
+    }
+
+    long long* newItems = realloc(
+        instance->items,
+        newCapacity * sizeof * newItems);
+
+    if (!newItems)
+    {
+        return false;
+    }
+
+    for (int i = instance->capacity; i < newCapacity; i++)
+    {
+        newItems[i] = 0;
+    }
+
+    instance->items = newItems;
+    instance->capacity = newCapacity;
+
+    return true;
+}
+
+void finalize_histogram(Histogram instance)
+{
+    free(instance->items);
+}
+
 static long long scan(long long vector[], int max, int galaxies)
 {
     int i = 1;
@@ -35,47 +89,55 @@ static long long scan(long long vector[], int max, int galaxies)
     return result;
 }
 
-int main(void)
+Exception solve(const char* input, size_t length, long long* result)
 {
     int n = 0;
     int galaxies = 0;
-    int minI = DIMENSION;
-    int minJ = DIMENSION;
+    int minI = -1;
     int maxI = 0;
     int maxJ = 0;
-    long long x[DIMENSION] = { 0 };
-    long long y[DIMENSION] = { 0 };
-    char buffer[DIMENSION + 1];
-    clock_t start = clock();
+    struct Histogram x;
+    struct Histogram y;
+    struct Stream reader;
+    struct StringView line;
 
-    while (fgets(buffer, sizeof buffer, stdin))
+    stream(&reader, input, length);
+    histogram(&x);
+    histogram(&y);
+
+    while (stream_next_line(&reader, &line))
     {
-        char current;
+        int columns = line.end - line.begin;
+
+        if (!histogram_reserve(&x, columns + 1) ||
+            !histogram_reserve(&y, n + 1))
+        {
+            finalize_histogram(&x);
+            finalize_histogram(&y);
+
+            return EXCEPTION_OUT_OF_MEMORY;
+        }
 
-        for (int j = 0; (current = buffer[j]); j++)
+        for (int j = 0; j < columns; j++)
         {
-            if (buffer[j] == '#')
+            if (line.begin[j] == '#')
             {
-                y[n]++;
-                x[j]++;
+                y.items[n]++;
+                x.items[j]++;
                 galaxies++;
             }
+        }
 
-            if (j > maxJ)
-            {
-                maxJ = j;
-            }
-            else if (j < minJ)
-            {
-                minJ = j;
-            }
+        if (columns > maxJ)
+        {
+            maxJ = columns;
         }
 
-        if (y[n])
+        if (y.items[n])
         {
             maxI = n;
 
-            if (n < minI)
+            if (minI < 0)
             {
                 minI = n;
             }
@@ -84,9 +146,32 @@ int main(void)
         n++;
     }
 
-    long long result =
-        scan(y + minI, maxI - minI, galaxies) +
-        scan(x + minJ, maxJ - minJ, galaxies);
+    if (!n)
+    {
+        finalize_histogram(&x);
+        finalize_histogram(&y);
+
+        *result = 0;
+
+        return EXCEPTION_NONE;
+    }
+
+    if (minI < 0)
+    {
+        minI = 0;
+    }
 
-    printf("11b %lld %lf\n", result, (double)(clock() - start) / CLOCKS_PER_SEC);
+    *result =
+        scan(y.items + minI, maxI - minI, galaxies) +
+        scan(x.items, maxJ, galaxies);
+
+    finalize_histogram(&x);
+    finalize_histogram(&y);
+
+    return EXCEPTION_NONE;
+}
+
+int main(void)
+{
+    return solver_main("11b", solve);
 }
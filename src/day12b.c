@@ -2,15 +2,14 @@
 
 // Hot Springs Part 2
 
-#include <stdio.h>
+#include <stdbool.h>
 #include <stdlib.h>
 #include <string.h>
-#include <time.h>
-#define BUFFER_SIZE 64
+#include "../lib/solver.h"
+#include "../lib/stream.h"
 #define DELIMITERS ","
 #define KEY_EMPTY -1
-#define LONG_PATTERN_BUFFER_CAPACITY 256
-#define SHORT_PATTERN_BUFFER_CAPACITY 32
+#define PATTERN_INITIAL_CAPACITY 32
 
 struct DictionaryEntry
 {
@@ -22,16 +21,17 @@ struct DictionaryEntry
 struct Dictionary
 {
     struct DictionaryEntry* first;
-    struct DictionaryEntry buckets[LONG_PATTERN_BUFFER_CAPACITY];
+    struct DictionaryEntry* buckets;
+    int capacity;
 };
 
 struct Pattern
 {
     char* symbols;
     int length;
+    int capacity;
 };
 
-typedef char* String;
 typedef struct DictionaryEntry* DictionaryEntry;
 typedef struct Dictionary* Dictionary;
 typedef struct Pattern* Pattern;
@@ -39,13 +39,50 @@ typedef struct Pattern* Pattern;
 void dictionary(Dictionary instance)
 {
     instance->first = NULL;
+    instance->buckets = NULL;
+    instance->capacity = 0;
+}
 
-    for (int i = 0; i < LONG_PATTERN_BUFFER_CAPACITY; i++)
+void dictionary_clear(Dictionary instance)
+{
+    for (DictionaryEntry entry = instance->first; entry; entry = entry->next)
     {
-        instance->buckets[i].key = KEY_EMPTY;
-        instance->buckets[i].value = 0;
-        instance->buckets[i].next = NULL;
+        entry->key = KEY_EMPTY;
+        entry->value = 0;
     }
+
+    instance->first = NULL;
+}
+
+bool dictionary_reset(Dictionary instance, int capacity)
+{
+    dictionary_clear(instance);
+
+    if (capacity <= instance->capacity)
+    {
+        return true;
+    }
+
+    DictionaryEntry newBuckets = realloc(
+        instance->buckets,
+        capacity * sizeof * newBuckets);
+
+    if (!newBuckets)
+    {
+        return false;
+    }
+
+    for (int i = instance->capacity; i < capacity; i++)
+    {
+        newBuckets[i].key = KEY_EMPTY;
+        newBuckets[i].value = 0;
+        newBuckets[i].next = NULL;
+    }
+
+    instance->buckets = newBuckets;
+    instance->capacity = capacity;
+
+    return true;
 }
 
 void dictionary_increment(Dictionary instance, int key, long long change)
@@ -64,7 +101,7 @@ void dictionary_increment(Dictionary instance, int key, long long change)
 
 void dictionary_copy(Dictionary destination, Dictionary source)
 {
-    dictionary(destination);
+    dictionary_clear(destination);
 
     for (DictionaryEntry entry = source->first; entry; entry = entry->next)
     {
@@ -72,33 +109,92 @@ void dictionary_copy(Dictionary destination, Dictionary source)
     }
 }
 
-void pattern(Pattern instance, char* symbols)
+void finalize_dictionary(Dictionary instance)
 {
+    free(instance->buckets);
+}
+
+void pattern(Pattern instance)
+{
+    instance->symbols = NULL;
     instance->length = 0;
-    instance->symbols = symbols;
+    instance->capacity = 0;
+}
+
+bool pattern_reserve(Pattern instance, int capacity)
+{
+    if (capacity <= instance->capacity)
+    {
+        return true;
+    }
+
+    int newCapacity = instance->capacity * 2;
+
+    if (newCapacity < PATTERN_INITIAL_CAPACITY)
+    {
+        newCapacity = PATTERN_INITIAL_CAPACITY;
+    }
+
+    if (newCapacity < capacity)
+    {
+        newCapacity = capacity;
+    }
+
+    char* newSymbols = realloc(instance->symbols, newCapacity);
+
+    if (!newSymbols)
+    {
+        return false;
+    }
+
+    instance->symbols = newSymbols;
+    instance->capacity = newCapacity;
+
+    return true;
 }
 
-void pattern_append(Pattern instance, char symbol)
+bool pattern_append(Pattern instance, char symbol)
 {
+    if (!pattern_reserve(instance, instance->length + 1))
+    {
+        return false;
+    }
+
     instance->symbols[instance->length] = symbol;
     instance->length++;
+
+    return true;
 }
 
-void pattern_append_many(Pattern instance, char symbol, int count)
+bool pattern_append_many(Pattern instance, char symbol, int count)
 {
+    if (!pattern_reserve(instance, instance->length + count))
+    {
+        return false;
+    }
+
     memset(instance->symbols + instance->length, symbol, count);
 
     instance->length += count;
+
+    return true;
 }
 
-void pattern_concat(Pattern instance, Pattern other)
+bool pattern_concat(Pattern instance, Pattern other)
 {
+    if (!pattern_reserve(instance, instance->length + other->length))
+    {
+        return false;
+    }
+
     memcpy(
         instance->symbols + instance->length,
         other->symbols,
         other->length);
 
     instance->length += other->length;
+
+    return true;
 }
 
 void pattern_set(Pattern instance, int index, char value)
@@ -106,15 +202,34 @@ void pattern_set(Pattern instance, int index, char value)
     instance->symbols[index] = value;
 }
 
-static void read(char symbol, Pattern pattern, Dictionary current)
+void pattern_clear(Pattern instance)
 {
-    struct Dictionary view;
+    instance->length = 0;
+}
+
+void finalize_pattern(Pattern instance)
+{
+    free(instance->symbols);
+}
 
-    dictionary_copy(&view, current);
-    dictionary(current);
+// Advances every state of the automaton past `symbol`. Returns the number of
+// states that were advanced.
 
-    for (DictionaryEntry entry = view.first; entry; entry = entry->next)
+static int read(
+    char symbol,
+    Pattern pattern,
+    Dictionary current,
+    Dictionary view)
+{
+    int result = 0;
+
+    dictionary_copy(view, current);
+    dictionary_clear(current);
+
+    for (DictionaryEntry entry = view->first; entry; entry = entry->next)
     {
+        result++;
+
         switch (symbol)
         {
             case '?':
@@ -151,78 +266,149 @@ static void read(char symbol, Pattern pattern, Dictionary current)
                 break;
         }
     }
+
+    return result;
 }
 
-static void scan(Pattern text, Pattern pattern, Dictionary current)
+static long long scan(
+    StringView text,
+    Pattern pattern,
+    Dictionary current,
+    Dictionary view)
 {
-    for (char* p = text->symbols; p < text->symbols + text->length; p++)
+    long long result = 0;
+
+    for (const char* p = text->begin; p < text->end; p++)
     {
-        read(*p, pattern, current);
+        result += read(*p, pattern, current, view);
     }
+
+    return result;
 }
 
-int main(void)
+Exception solve(const char* input, size_t length, long long* result)
 {
     long long total = 0;
-    char buffer[BUFFER_SIZE];
-    clock_t start = clock();
+    long long entries = 0;
+    Exception exception = EXCEPTION_NONE;
+    struct Stream reader;
+    struct StringView line;
+    struct Dictionary current;
+    struct Dictionary view;
+    struct Pattern longPattern;
+    struct Pattern shortPattern;
 
-    while (fgets(buffer, sizeof buffer, stdin))
+    stream(&reader, input, length);
+    dictionary(&current);
+    dictionary(&view);
+    pattern(&longPattern);
+    pattern(&shortPattern);
+
+    while (!exception && stream_next_line(&reader, &line))
     {
-        char* mid = strchr(buffer, ' ');
+        const char* mid = memchr(line.begin, ' ', line.end - line.begin);
 
         if (!mid)
         {
-            fprintf(stderr, "Error: Format.\n");
+            exception = EXCEPTION_FORMAT;
 
-            return 1;
+            continue;
         }
 
-        char patternBuffer[LONG_PATTERN_BUFFER_CAPACITY];
-        char shortPatternBuffer[SHORT_PATTERN_BUFFER_CAPACITY];
-        struct Dictionary current;
-        struct Pattern text =
+        struct StringView text =
         {
-            .symbols = buffer,
-            .length = mid - buffer
+            .begin = line.begin,
+            .end = mid
         };
-        struct Pattern longPattern;
-        struct Pattern shortPattern;
+        struct StringView token;
+
+        pattern_clear(&longPattern);
+        pattern_clear(&shortPattern);
 
-        pattern(&longPattern, patternBuffer);
-        pattern(&shortPattern, shortPatternBuffer);
-        pattern_append(&longPattern, '.');
+        if (!pattern_append(&longPattern, '.'))
+        {
+            exception = EXCEPTION_OUT_OF_MEMORY;
+
+            continue;
+        }
+
+        line.begin = mid + 1;
+
+        while (!exception && string_view_next_token(&line, DELIMITERS, &token))
+        {
+            int count = string_view_to_long(&token);
+
+            if (count < 0)
+            {
+                exception = EXCEPTION_FORMAT;
+            }
+            else if (!pattern_append_many(&shortPattern, '#', count) ||
+                !pattern_append(&shortPattern, '.'))
+            {
+                exception = EXCEPTION_OUT_OF_MEMORY;
+            }
+        }
+
+        for (int i = 0; !exception && i < 5; i++)
+        {
+            if (!pattern_concat(&longPattern, &shortPattern))
+            {
+                exception = EXCEPTION_OUT_OF_MEMORY;
+            }
+        }
 
-        for (String token = strtok(mid, DELIMITERS);
-            token;
-            token = strtok(NULL, DELIMITERS))
+        if (exception)
         {
-            pattern_append_many(&shortPattern, '#', atoi(token));
-            pattern_append(&shortPattern, '.');
+            continue;
         }
 
-        for (int i = 0; i < 5; i++)
+        if (longPattern.length < 2)
         {
-            pattern_concat(&longPattern, &shortPattern);
+            exception = EXCEPTION_FORMAT;
+
+            continue;
+        }
+
+        if (!dictionary_reset(&current, longPattern.length) ||
+            !dictionary_reset(&view, longPattern.length))
+        {
+            exception = EXCEPTION_OUT_OF_MEMORY;
+
+            continue;
         }
 
-        dictionary(&current);
         dictionary_increment(&current, 0, 1);
 
         for (int i = 0; i < 4; i++)
         {
-            scan(&text, &longPattern, &current);
-            read('?', &longPattern, &current);
+            entries += scan(&text, &longPattern, &current, &view);
+            entries += read('?', &longPattern, &current, &view);
         }
 
-        scan(&text, &longPattern, &current);
+        entries += scan(&text, &longPattern, &current, &view);
 
         total +=
             current.buckets[longPattern.length - 1].value +
             current.buckets[longPattern.length - 2].value;
     }
 
-    printf("12b %lld %lf\n", total, (double)(clock() - start) / CLOCKS_PER_SEC);
+    solver_work("entries", entries);
+    finalize_dictionary(&current);
+    finalize_dictionary(&view);
+    finalize_pattern(&longPattern);
+    finalize_pattern(&shortPattern);
+
+    if (exception)
+    {
+        return exception;
+    }
 
-    return 0;
+    *result = total;
+
+    return EXCEPTION_NONE;
+}
+
+int main(void)
+{
+    return solver_main_sharded("12b", solve, SHARD_LINE);
 }
@@ -3,17 +3,17 @@
 // Point of Incidence Part 2
 
 #include <stdbool.h>
-#include <stdio.h>
 #include <string.h>
-#include <time.h>
-#define DIMENSION 32
+#include "../lib/solver.h"
+#include "../lib/stream.h"
+#define DIMENSION 65
 
-typedef unsigned long BitVector;
-typedef unsigned long* BitMatrix;
+typedef unsigned long long BitVector;
+typedef unsigned long long* BitMatrix;
 
 void bit_matrix_clear(BitMatrix instance)
 {
-    memset(instance, 0, DIMENSION * sizeof(unsigned long));
+    memset(instance, 0, DIMENSION * sizeof(BitVector));
 }
 
 static bool mid(BitMatrix matrix, int index)
@@ -60,18 +60,22 @@ static int realize_xy(BitMatrix x, BitMatrix y)
     return realize(x);
 }
 
-int main(void)
+Exception solve(const char* input, size_t length, long long* result)
 {
     int i = 0;
     int total = 0;
     BitVector x[DIMENSION] = { 0 };
     BitVector y[DIMENSION] = { 0 };
-    char buffer[DIMENSION + 2];
-    clock_t start = clock();
+    struct Stream reader;
+    struct StringView line;
+
+    stream(&reader, input, length);
 
-    while (fgets(buffer, sizeof buffer, stdin))
+    while (stream_next_line(&reader, &line))
     {
-        if (buffer[0] == '\n')
+        int n = line.end - line.begin;
+
+        if (!n)
         {
             i = 0;
             total += realize_xy(x, y);
@@ -81,11 +85,15 @@ int main(void)
             continue;
         }
 
-        int j = 0;
+        if (i == DIMENSION - 1 || n >= DIMENSION)
+        {
+            return EXCEPTION_FORMAT;
+        }
+
 
-        while (buffer[j])
+        for (int j = 0; j < n; j++)
         {
-            switch (buffer[j])
+            switch (line.begin[j])
             {
                 case '#':
                     y[i] = (y[i] << 1) | 1;
@@ -97,8 +105,6 @@ int main(void)
                     x[j] <<= 1;
                     break;
             }
-
-            j++;
         }
 
         i++;
@@ -106,7 +112,12 @@ int main(void)
 
     total += realize_xy(x, y);
 
-    printf("13a %d %lf\n", total, (double)(clock() - start) / CLOCKS_PER_SEC);
+    *result = total;
 
-    return 0;
+    return EXCEPTION_NONE;
+}
+
+int main(void)
+{
+    return solver_main_sharded("13a", solve, SHARD_BLOCK);
 }
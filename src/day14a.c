@@ -3,17 +3,17 @@
 // The Floor Will Be Lava Part 1
 
 #include <stdbool.h>
-#include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
-#include <time.h>
-#define DIMENSION 101
-#define EXCEPTION_FORMAT "Error: Format.\n"
+#include "../lib/solver.h"
+#include "../lib/stream.h"
 
 struct Matrix
 {
     int rows;
     int columns;
-    char items[(DIMENSION - 1) * (DIMENSION - 1)];
+    int capacity;
+    char* items;
 };
 
 typedef char* Row;
@@ -23,6 +23,8 @@ void matrix(Matrix instance, int columns)
 {
     instance->rows = 0;
     instance->columns = columns;
+    instance->capacity = 0;
+    instance->items = NULL;
 }
 
 char matrix_get(Matrix instance, int i, int j)
@@ -35,16 +37,45 @@ void matrix_set(Matrix instance, int i, int j, char value)
     instance->items[(instance->columns * i) + j] = value;
 }
 
-void matrix_add_row(Matrix instance, char values[])
+bool matrix_add_row(Matrix instance, const char values[])
 {
     int m = instance->rows;
 
+    if (m == instance->capacity)
+    {
+        int newCapacity = m * 2;
+
+        if (!newCapacity)
+        {
+            newCapacity = instance->columns;
+        }
+
+        char* newItems = realloc(
+            instance->items,
+            (size_t)newCapacity * instance->columns);
+
+        if (!newItems)
+        {
+            return false;
+        }
+
+        instance->items = newItems;
+        instance->capacity = newCapacity;
+    }
+
     instance->rows = m + 1;
 
     memcpy(
         instance->items + (instance->columns * m),
         values,
         instance->columns);
+
+    return true;
+}
+
+void finalize_matrix(Matrix instance)
+{
+    free(instance->items);
 }
 
 static long scan(Matrix matrix)
@@ -85,25 +116,23 @@ static void roll_hi(Matrix matrix)
     }
 }
 
-int main(void)
+Exception solve(const char* input, size_t length, long long* result)
 {
-    char buffer[DIMENSION + 1];
-    clock_t start = clock();
+    struct Stream reader;
+    struct StringView line;
 
-    if (!fgets(buffer, sizeof buffer, stdin))
-    {
-        fprintf(stderr, EXCEPTION_FORMAT);
+    stream(&reader, input, length);
 
-        return 1;
+    if (!stream_next_line(&reader, &line))
+    {
+        return EXCEPTION_FORMAT;
     }
 
-    int n = strlen(buffer) - 1;
+    int n = line.end - line.begin;
 
     if (n < 1)
     {
-        fprintf(stderr, EXCEPTION_FORMAT);
-
-        return 1;
+        return EXCEPTION_FORMAT;
     }
 
     struct Matrix a;
@@ -112,15 +141,34 @@ int main(void)
 
     do
     {
-        matrix_add_row(&a, buffer);
+        if (line.end - line.begin != n)
+        {
+            finalize_matrix(&a);
+
+            return EXCEPTION_FORMAT;
+        }
+
+        if (!matrix_add_row(&a, line.begin))
+        {
+            finalize_matrix(&a);
+
+            return EXCEPTION_OUT_OF_MEMORY;
+        }
     }
-    while (fgets(buffer, n + 2, stdin));
+    while (stream_next_line(&reader, &line));
 
     roll_hi(&a);
 
     long total = scan(&a);
 
-    printf("14a %ld %lf\n", total, (double)(clock() - start) / CLOCKS_PER_SEC);
+    finalize_matrix(&a);
 
-    return 0;
+    *result = total;
+
+    return EXCEPTION_NONE;
+}
+
+int main(void)
+{
+    return solver_main("14a", solve);
 }
@@ -3,56 +3,31 @@
 // Parabolic Reflector Dish Part 2
 
 #include <stdbool.h>
-#include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
-#include <time.h>
-#define DICTIONARY_BUCKETS 193
-#define DIMENSION 101
-#define EXCEPTION_FORMAT "Error: Format.\n"
+#include "../lib/solver.h"
+#include "../lib/stream.h"
+#include "../lib/hash_table.h"
+#include "../lib/trace.h"
 #define ITERATIONS 1000000000
 
-enum
-{
-    KEY_SIZE = (DIMENSION - 1) * (DIMENSION - 1)
-};
-
-struct DictionaryEntry
-{
-    struct DictionaryEntry* nextEntry;
-    long value;
-    char key[KEY_SIZE];
-};
-
-struct DictionaryBucket
-{
-    struct DictionaryEntry* firstEntry;
-    struct DictionaryBucket* nextBucket;
-};
-
-struct Dictionary
-{
-    struct DictionaryBucket* firstBucket;
-    struct DictionaryBucket buckets[DICTIONARY_BUCKETS];
-};
-
 struct Matrix
 {
     int rows;
     int columns;
-    char items[KEY_SIZE];
+    int capacity;
+    char* items;
 };
 
 typedef char* Row;
-typedef struct DictionaryEntry* DictionaryEntry;
-typedef struct DictionaryBucket* DictionaryBucket;
-typedef struct Dictionary* Dictionary;
 typedef struct Matrix* Matrix;
 
 void matrix(Matrix instance, int columns)
 {
     instance->rows = 0;
     instance->columns = columns;
+    instance->capacity = 0;
+    instance->items = NULL;
 }
 
 char matrix_get(Matrix instance, int i, int j)
@@ -65,95 +40,45 @@ void matrix_set(Matrix instance, int i, int j, char value)
     instance->items[(instance->columns * i) + j] = value;
 }
 
-void matrix_add_row(Matrix instance, char values[])
+bool matrix_add_row(Matrix instance, const char values[])
 {
     int m = instance->rows;
 
-    instance->rows = m + 1;
-
-    memcpy(
-        instance->items + (instance->columns * m),
-        values,
-        instance->columns);
-}
-
-void matrix_to_char_array(Matrix instance, char result[])
-{
-    memcpy(result, instance->items, instance->rows * instance->columns);
-}
-
-bool dictionary_replace(
-    Dictionary instance,
-    char key[],
-    long* existingValue,
-    long newValue)
-{
-    DictionaryEntry* p;
-    unsigned int hash = 7;
-
-    for (int i = 0; i < KEY_SIZE; i++)
+    if (m == instance->capacity)
     {
-        hash = (hash * 31) + key[i];
-    }
-
-    hash %= DICTIONARY_BUCKETS;
+        int newCapacity = m * 2;
 
-    for (p = &instance->buckets[hash].firstEntry; *p; p = &(*p)->nextEntry)
-    {
-        if (memcmp(key, (*p)->key, KEY_SIZE) == 0)
+        if (!newCapacity)
         {
-            *existingValue = (*p)->value;
-            (*p)->value = newValue;
-
-            return true;
+            newCapacity = instance->columns;
         }
-    }
 
-    DictionaryEntry entry = malloc(sizeof * entry);
+        char* newItems = realloc(
+            instance->items,
+            (size_t)newCapacity * instance->columns);
 
-    if (!entry)
-    {
-        return false;
-    }
-
-    if (!instance->buckets[hash].firstEntry)
-    {
-        DictionaryBucket first = instance->firstBucket;
+        if (!newItems)
+        {
+            return false;
+        }
 
-        instance->buckets[hash].nextBucket = first;
-        instance->firstBucket = instance->buckets + hash;
+        instance->items = newItems;
+        instance->capacity = newCapacity;
     }
 
-    memcpy(entry->key, key, KEY_SIZE);
+    instance->rows = m + 1;
 
-    entry->value = newValue;
-    entry->nextEntry = NULL;
-    *p = entry;
+    memcpy(
+        instance->items + (instance->columns * m),
+        values,
+        instance->columns);
 
     return true;
 }
 
-void dictionary_clear(Dictionary instance)
+void finalize_matrix(Matrix instance)
 {
-    for (DictionaryBucket bucket = instance->firstBucket;
-        bucket;
-        bucket = bucket->nextBucket)
-    {
-        DictionaryEntry entry = bucket->firstEntry;
-
-        while (entry)
-        {
-            DictionaryEntry nextEntry = entry->nextEntry;
-
-            free(entry);
-
-            entry = nextEntry;
-        }
-
-        bucket->firstEntry = NULL;
-    }
-
-    instance->firstBucket = NULL;
+    free(instance->items);
 }
 
 static long scan(Matrix matrix)
@@ -266,24 +191,30 @@ static void roll(Matrix matrix)
     roll_right(matrix);
 }
 
-static bool roll_many(Matrix matrix, Dictionary cache)
+static bool roll_many(Matrix matrix, HashTable cache)
 {
     long i = 0;
 
     while (i < ITERATIONS)
     {
-        long previous = -1;
-        char key[KEY_SIZE];
+        bool added;
 
+        trace_begin("cycle");
         roll(matrix);
-        matrix_to_char_array(matrix, key);
+        trace_end("cycle");
+
+        long* value = hash_table_add(cache, matrix->items, &added);
 
-        if (!dictionary_replace(cache, key, &previous, i))
+        if (!value)
         {
             return false;
         }
 
-        if (previous != -1)
+        long previous = *value;
+
+        *value = i;
+
+        if (!added)
         {
             i = ITERATIONS - ((ITERATIONS - previous) % (i - previous)) + 1;
 
@@ -295,7 +226,9 @@ static bool roll_many(Matrix matrix, Dictionary cache)
 
     while (i < ITERATIONS)
     {
+        trace_begin("cycle");
         roll(matrix);
+        trace_end("cycle");
 
         i++;
     }
@@ -303,49 +236,69 @@ static bool roll_many(Matrix matrix, Dictionary cache)
     return true;
 }
 
-int main(void)
+Exception solve(const char* input, size_t length, long long* result)
 {
-    char buffer[DIMENSION + 1];
-    clock_t start = clock();
+    struct Stream reader;
+    struct StringView line;
 
-    if (!fgets(buffer, sizeof buffer, stdin))
-    {
-        fprintf(stderr, EXCEPTION_FORMAT);
+    stream(&reader, input, length);
 
-        return 1;
+    if (!stream_next_line(&reader, &line))
+    {
+        return EXCEPTION_FORMAT;
     }
 
-    int n = strlen(buffer) - 1;
+    int n = line.end - line.begin;
 
     if (n < 1)
     {
-        fprintf(stderr, EXCEPTION_FORMAT);
-
-        return 1;
+        return EXCEPTION_FORMAT;
     }
 
     struct Matrix a;
-    struct Dictionary cache = { 0 };
+    struct HashTable cache;
 
     matrix(&a, n);
 
     do
     {
-        matrix_add_row(&a, buffer);
+        if (line.end - line.begin != n)
+        {
+            finalize_matrix(&a);
+
+            return EXCEPTION_FORMAT;
+        }
+
+        if (!matrix_add_row(&a, line.begin))
+        {
+            finalize_matrix(&a);
+
+            return EXCEPTION_OUT_OF_MEMORY;
+        }
     }
-    while (fgets(buffer, n + 2, stdin));
+    while (stream_next_line(&reader, &line));
+
+    hash_table(&cache, a.rows * a.columns, sizeof(long), NULL, NULL);
 
     if (!roll_many(&a, &cache))
     {
-        fprintf(stderr, "Error: Out of memory.\n");
+        finalize_hash_table(&cache);
+        finalize_matrix(&a);
 
-        return 1;
+        return EXCEPTION_OUT_OF_MEMORY;
     }
 
     long total = scan(&a);
 
-    printf("14b %ld %lf\n", total, (double)(clock() - start) / CLOCKS_PER_SEC);
-    dictionary_clear(&cache);
+    finalize_hash_table(&cache);
+    finalize_matrix(&a);
+
+    *result = total;
 
-    return 0;
+    return EXCEPTION_NONE;
+}
+
+int main(void)
+{
+    return solver_main("14b", solve);
 }
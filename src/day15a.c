@@ -3,16 +3,19 @@
 // Lens Library Part 1
 
 #include <stdio.h>
-#include <time.h>
+#include "../lib/solver.h"
+#include "../lib/stream.h"
 
-int main(void)
+Exception solve(const char* input, size_t length, long long* result)
 {
     long sum = 0;
     int hash = 0;
     char current;
-    clock_t start = clock();
+    struct Stream reader;
+
+    stream(&reader, input, length);
 
-    while ((current = getc(stdin)) != EOF)
+    while ((current = stream_get_char(&reader)) != EOF)
     {
         switch (current)
         {
@@ -28,7 +31,12 @@ int main(void)
 
     sum += hash;
 
-    printf("15a %ld %lf\n", sum, (double)(clock() - start) / CLOCKS_PER_SEC);
+    *result = sum;
+
+    return EXCEPTION_NONE;
+}
 
-    return 0;
+int main(void)
+{
+    return solver_main("15a", solve);
 }
@@ -7,201 +7,141 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
-#include <time.h>
-#define EXCEPTION_OUT_OF_MEMORY "Error: Out of memory.\n"
-#define ORDERED_DICTIONARY_BUCKETS 256
-#define STRING_CAPACITY 8
+#include "../lib/solver.h"
+#include "../lib/stream.h"
+#include "../lib/hash_table.h"
+#define BOXES 256
 
 struct String
 {
     int length;
-    char buffer[STRING_CAPACITY];
+    const char* buffer;
 };
 
-struct OrderedDictionaryEntry
+struct Lens
 {
-    struct OrderedDictionaryEntry* nextEntry;
-    int value;
-    struct String key;
-};
-
-struct OrderedDictionaryBucket
-{
-    struct OrderedDictionaryEntry* firstEntry;
-    struct OrderedDictionaryBucket* nextBucket;
-    struct OrderedDictionaryBucket* previousBucket;
-};
-
-struct OrderedDictionary
-{
-    struct OrderedDictionaryBucket* firstBucket;
-    struct OrderedDictionaryBucket buckets[ORDERED_DICTIONARY_BUCKETS];
+    int box;
+    int focalLength;
+    long order;
 };
 
+typedef const void* Object;
 typedef struct String* String;
-typedef struct OrderedDictionaryEntry* OrderedDictionaryEntry;
-typedef struct OrderedDictionaryBucket* OrderedDictionaryBucket;
-typedef struct OrderedDictionary* OrderedDictionary;
+typedef struct Lens* Lens;
 
 void string(String instance)
 {
     instance->length = 0;
+    instance->buffer = NULL;
 }
 
-void string_append(String instance, char value)
+void string_append(String instance, const char* value)
 {
-    instance->buffer[instance->length] = value;
+    if (!instance->length)
+    {
+        instance->buffer = value;
+    }
+
     instance->length++;
 }
 
 void string_copy(String destination, String source)
 {
     destination->length = source->length;
-
-    memcpy(destination->buffer, source->buffer, source->length);
+    destination->buffer = source->buffer;
 }
 
-bool string_equals(String instance, String other)
+static unsigned int lens_table_hash_key(Object key, size_t size)
 {
-    if (instance->length != other->length)
-    {
-        return false;
-    }
+    const struct String* instance = key;
 
-    return memcmp(instance->buffer, other->buffer, instance->length) == 0;
+    (void)size;
+
+    return hash_table_hash_bytes(instance->buffer, instance->length);
 }
 
-bool ordered_dictionary_set(
-    OrderedDictionary instance,
-    String key,
-    int hash,
-    int value)
+static bool lens_table_key_equals(Object left, Object right, size_t size)
 {
-    OrderedDictionaryEntry* p;
-
-    for (p = &instance->buckets[hash].firstEntry; *p; p = &(*p)->nextEntry)
-    {
-        if (string_equals(key, &(*p)->key))
-        {
-            (*p)->value = value;
-
-            return true;
-        }
-    }
+    const struct String* leftString = left;
+    const struct String* rightString = right;
 
-    OrderedDictionaryEntry entry = malloc(sizeof * entry);
+    (void)size;
 
-    if (!entry)
+    if (leftString->length != rightString->length)
     {
         return false;
     }
 
-    if (!instance->buckets[hash].firstEntry)
-    {
-        OrderedDictionaryBucket first = instance->firstBucket;
+    return memcmp(
+        leftString->buffer,
+        rightString->buffer,
+        leftString->length) == 0;
+}
 
-        instance->buckets[hash].nextBucket = first;
-        instance->firstBucket = instance->buckets + hash;
+static int lens_compare(Object left, Object right)
+{
+    const struct Lens* leftLens = left;
+    const struct Lens* rightLens = right;
 
-        if (first)
-        {
-            first->previousBucket = instance->buckets + hash;
-        }
+    if (leftLens->box != rightLens->box)
+    {
+        return leftLens->box - rightLens->box;
     }
 
-    string_copy(&entry->key, key);
-
-    entry->value = value;
-    entry->nextEntry = NULL;
-    *p = entry;
+    if (leftLens->order < rightLens->order)
+    {
+        return -1;
+    }
 
-    return true;
+    return leftLens->order > rightLens->order;
 }
 
-void ordered_dictionary_remove(OrderedDictionary instance, String key, int hash)
+bool lens_table_set(
+    HashTable instance,
+    String key,
+    int box,
+    int focalLength,
+    long order)
 {
-    OrderedDictionaryEntry previous = NULL;
+    bool added;
+    Lens lens = hash_table_add(instance, key, &added);
 
-    for (OrderedDictionaryEntry current = instance->buckets[hash].firstEntry;
-        current;
-        current = current->nextEntry)
+    if (!lens)
     {
-        if (string_equals(key, &current->key))
-        {
-            if (previous)
-            {
-                previous->nextEntry = current->nextEntry;
-            }
-            else if (current->nextEntry)
-            {
-                instance->buckets[hash].firstEntry = current->nextEntry;
-            }
-            else
-            {
-                if (instance->firstBucket == instance->buckets + hash)
-                {
-                    instance->firstBucket = instance->buckets[hash].nextBucket;
-                }
-
-                if (instance->buckets[hash].nextBucket)
-                {
-                    instance->buckets[hash].nextBucket->previousBucket =
-                        instance->buckets[hash].previousBucket;
-                }
-
-                if (instance->buckets[hash].previousBucket)
-                {
-                    instance->buckets[hash].previousBucket->nextBucket =
-                        instance->buckets[hash].nextBucket;
-                }
-
-                instance->buckets[hash].firstEntry = NULL;
-            }
-
-            free(current);
-
-            break;
-        }
-
-        previous = current;
+        return false;
     }
-}
 
-void ordered_dictionary_clear(OrderedDictionary instance)
-{
-    for (OrderedDictionaryBucket bucket = instance->firstBucket;
-        bucket;
-        bucket = bucket->nextBucket)
+    if (added)
     {
-        OrderedDictionaryEntry entry = bucket->firstEntry;
-
-        while (entry)
-        {
-            OrderedDictionaryEntry nextEntry = entry->nextEntry;
-
-            free(entry);
-
-            entry = nextEntry;
-        }
-
-        bucket->firstEntry = NULL;
+        lens->box = box;
+        lens->order = order;
     }
 
-    instance->firstBucket = NULL;
+    lens->focalLength = focalLength;
+
+    return true;
 }
 
-int main(void)
+Exception solve(const char* input, size_t length, long long* result)
 {
     int hash = 0;
     int value = 0;
+    long order = 0;
     char current;
     struct String key;
-    struct OrderedDictionary dictionary = { 0 };
-    clock_t start = clock();
+    struct HashTable lenses;
+    struct Stream reader;
 
+    stream(&reader, input, length);
     string(&key);
-
-    while ((current = getc(stdin)) != EOF)
+    hash_table(
+        &lenses,
+        sizeof key,
+        sizeof(struct Lens),
+        lens_table_hash_key,
+        lens_table_key_equals);
+
+    while ((current = stream_get_char(&reader)) != EOF)
     {
         if (isdigit(current))
         {
@@ -218,7 +158,7 @@ int main(void)
 
             case '-':
             {
-                ordered_dictionary_remove(&dictionary, &key, hash);
+                hash_table_remove(&lenses, &key);
             }
             continue;
 
@@ -226,56 +166,83 @@ int main(void)
             {
                 if (value)
                 {
-                    if (!ordered_dictionary_set(&dictionary, &key, hash, value))
+                    if (!lens_table_set(&lenses, &key, hash, value, order))
                     {
-                        fprintf(stderr, EXCEPTION_OUT_OF_MEMORY);
+                        finalize_hash_table(&lenses);
 
-                        return 1;
+                        return EXCEPTION_OUT_OF_MEMORY;
                     }
                 }
 
                 hash = 0;
                 value = 0;
+                order++;
 
                 string(&key);
             }
             continue;
         }
 
-        hash = ((hash + current) * 17) % ORDERED_DICTIONARY_BUCKETS;
+        hash = ((hash + current) * 17) % BOXES;
 
-        string_append(&key, current);
+        string_append(&key, reader.current - 1);
     }
 
     if (value)
     {
-        if (!ordered_dictionary_set(&dictionary, &key, hash, value))
+        if (!lens_table_set(&lenses, &key, hash, value, order))
         {
-            fprintf(stderr, EXCEPTION_OUT_OF_MEMORY);
+            finalize_hash_table(&lenses);
 
-            return 1;
+            return EXCEPTION_OUT_OF_MEMORY;
         }
     }
 
-    long sum = 0;
+    Lens sorted = malloc(lenses.count * sizeof * sorted);
 
-    for (OrderedDictionaryBucket bucket = dictionary.firstBucket;
-        bucket;
-        bucket = bucket->nextBucket)
+    if (lenses.count && !sorted)
     {
-        int slot = 1;
+        finalize_hash_table(&lenses);
+
+        return EXCEPTION_OUT_OF_MEMORY;
+    }
+
+    int n = 0;
+    struct HashTableIterator iterator;
+
+    hash_table_begin(&lenses, &iterator);
+
+    while (hash_table_next(&lenses, &iterator))
+    {
+        sorted[n] = *(Lens)iterator.value;
+        n++;
+    }
 
-        for (OrderedDictionaryEntry entry = bucket->firstEntry;
-            entry;
-            entry = entry->nextEntry)
+    qsort(sorted, n, sizeof * sorted, lens_compare);
+
+    int slot = 0;
+    long sum = 0;
+
+    for (int i = 0; i < n; i++)
+    {
+        if (i && sorted[i].box != sorted[i - 1].box)
         {
-            sum += (bucket - dictionary.buckets + 1) * slot * entry->value;
-            slot++;
+            slot = 0;
         }
+
+        slot++;
+        sum += (sorted[i].box + 1) * slot * sorted[i].focalLength;
     }
 
-    printf("15b %ld %lf\n", sum, (double)(clock() - start) / CLOCKS_PER_SEC);
-    ordered_dictionary_clear(&dictionary);
+    free(sorted);
+    finalize_hash_table(&lenses);
 
-    return 0;
+    *result = sum;
+
+    return EXCEPTION_NONE;
+}
+
+int main(void)
+{
+    return solver_main("15b", solve);
 }
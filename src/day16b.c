@@ -3,12 +3,12 @@
 // The Floor Will Be Lava Part 2
 
 #include <stdbool.h>
-#include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
-#include <time.h>
-#define COORDINATE_STACK_CAPACITY 128
-#define DIMENSION 128
-#define EXCEPTION_FORMAT "Error: Format.\n"
+#include "../lib/solver.h"
+#include "../lib/stream.h"
+#include "../lib/trace.h"
+#define COORDINATE_STACK_INITIAL_CAPACITY 128
 
 enum Direction
 {
@@ -29,15 +29,17 @@ struct Coordinate
 struct CoordinateStack
 {
     int count;
-    struct Coordinate items[COORDINATE_STACK_CAPACITY];
+    int capacity;
+    struct Coordinate* items;
 };
 
 struct Table
 {
     int rows;
     int columns;
-    char matrix[DIMENSION * DIMENSION];
-    bool set[DIMENSION * DIMENSION][DIRECTION_NONE];
+    int capacity;
+    char* matrix;
+    bool (*set)[DIRECTION_NONE];
 };
 
 typedef enum Direction Direction;
@@ -49,12 +51,38 @@ typedef struct Table* Table;
 void coordinate_stack(CoordinateStack instance)
 {
     instance->count = 0;
+    instance->capacity = 0;
+    instance->items = NULL;
 }
 
-void coordinate_stack_push(CoordinateStack instance, Coordinate item)
+bool coordinate_stack_push(CoordinateStack instance, Coordinate item)
 {
+    if (instance->count == instance->capacity)
+    {
+        int newCapacity = instance->capacity * 2;
+
+        if (!newCapacity)
+        {
+            newCapacity = COORDINATE_STACK_INITIAL_CAPACITY;
+        }
+
+        Coordinate newItems = realloc(
+            instance->items,
+            newCapacity * sizeof * newItems);
+
+        if (!newItems)
+        {
+            return false;
+        }
+
+        instance->items = newItems;
+        instance->capacity = newCapacity;
+    }
+
     instance->items[instance->count] = *item;
     instance->count++;
+
+    return true;
 }
 
 bool coordinate_stack_try_pop(CoordinateStack instance, Coordinate result)
@@ -70,10 +98,18 @@ bool coordinate_stack_try_pop(CoordinateStack instance, Coordinate result)
     return true;
 }
 
+void finalize_coordinate_stack(CoordinateStack instance)
+{
+    free(instance->items);
+}
+
 void table(Table instance, int columns)
 {
     instance->rows = 0;
     instance->columns = columns;
+    instance->capacity = 0;
+    instance->matrix = NULL;
+    instance->set = NULL;
 }
 
 char table_matrix_get(Table instance, Coordinate coordinate)
@@ -83,16 +119,60 @@ char table_matrix_get(Table instance, Coordinate coordinate)
     return instance->matrix[index];
 }
 
-void table_matrix_add_row(Table instance, char values[])
+bool table_matrix_add_row(Table instance, const char values[])
 {
     int m = instance->rows;
 
+    if (m == instance->capacity)
+    {
+        int newCapacity = m * 2;
+
+        if (!newCapacity)
+        {
+            newCapacity = instance->columns;
+        }
+
+        size_t size = (size_t)newCapacity * instance->columns;
+        char* newMatrix = realloc(instance->matrix, size);
+
+        if (!newMatrix)
+        {
+            return false;
+        }
+
+        instance->matrix = newMatrix;
+
+        bool (*newSet)[DIRECTION_NONE] = realloc(
+            instance->set,
+            size * sizeof * newSet);
+
+        if (!newSet)
+        {
+            return false;
+        }
+
+        instance->set = newSet;
+        instance->capacity = newCapacity;
+    }
+
     instance->rows = m + 1;
 
     memcpy(
         instance->matrix + (instance->columns * m),
         values,
         instance->columns);
+    memset(
+        instance->set + (instance->columns * m),
+        false,
+        instance->columns * sizeof * instance->set);
+
+    return true;
+}
+
+void finalize_table(Table instance)
+{
+    free(instance->matrix);
+    free(instance->set);
 }
 
 bool table_set_add(Table instance, Coordinate coordinate)
@@ -129,7 +209,11 @@ static int scan(
     table_set_clear(table);
     table_set_add(table, &current);
     coordinate_stack(&stack);
-    coordinate_stack_push(&stack, &current);
+
+    if (!coordinate_stack_push(&stack, &current))
+    {
+        return -1;
+    }
 
     while (coordinate_stack_try_pop(&stack, &current))
     {
@@ -160,7 +244,12 @@ static int scan(
                     .direction = DIRECTION_LEFT
                 };
 
-                coordinate_stack_push(&stack, &next);
+                if (!coordinate_stack_push(&stack, &next))
+                {
+                    finalize_coordinate_stack(&stack);
+
+                    return -1;
+                }
             }
             break;
 
@@ -181,7 +270,12 @@ static int scan(
                     .direction = DIRECTION_LO
                 };
 
-                coordinate_stack_push(&stack, &next);
+                if (!coordinate_stack_push(&stack, &next))
+                {
+                    finalize_coordinate_stack(&stack);
+
+                    return -1;
+                }
             }
             break;
         }
@@ -214,9 +308,16 @@ static int scan(
             continue;
         }
 
-        coordinate_stack_push(&stack, &current);
+        if (!coordinate_stack_push(&stack, &current))
+        {
+            finalize_coordinate_stack(&stack);
+
+            return -1;
+        }
     }
 
+    finalize_coordinate_stack(&stack);
+
     int result = 0;
 
     for (int k = 0; k < table->rows * table->columns; k++)
@@ -235,61 +336,97 @@ static int scan(
     return result;
 }
 
-static void scan_vertical(
+static bool scan_vertical(
     Table table,
     Coordinate current,
     DirectionDictionary hiRight,
     DirectionDictionary loRight,
     int* max)
 {
+    long long energized = 0;
+
+    trace_begin("scan_vertical");
+
     for (current->i = 0; current->i < table->rows; current->i++)
     {
         int total = scan(table, current, hiRight, loRight);
 
+        if (total < 0)
+        {
+            trace_end("scan_vertical");
+
+            return false;
+        }
+
         if (total > *max)
         {
             *max = total;
         }
+
+        energized += total;
     }
+
+    trace_end("scan_vertical");
+    solver_work("entries", table->rows);
+    solver_work("energized", energized);
+
+    return true;
 }
 
-static void scan_horizontal(
+static bool scan_horizontal(
     Table table,
     Coordinate current,
     DirectionDictionary hiRight,
     DirectionDictionary loRight,
     int* max)
 {
+    long long energized = 0;
+
+    trace_begin("scan_horizontal");
+
     for (current->j = 0; current->j < table->columns; current->j++)
     {
         int total = scan(table, current, hiRight, loRight);
 
+        if (total < 0)
+        {
+            trace_end("scan_horizontal");
+
+            return false;
+        }
+
         if (total > *max)
         {
             *max = total;
         }
+
+        energized += total;
     }
+
+    trace_end("scan_horizontal");
+    solver_work("entries", table->columns);
+    solver_work("energized", energized);
+
+    return true;
 }
 
-int main(void)
+Exception solve(const char* input, size_t length, long long* result)
 {
-    char buffer[DIMENSION + 2];
-    clock_t start = clock();
+    struct Stream reader;
+    struct StringView line;
 
-    if (!fgets(buffer, sizeof buffer, stdin))
-    {
-        fprintf(stderr, EXCEPTION_FORMAT);
+    stream(&reader, input, length);
 
-        return 1;
+    if (!stream_next_line(&reader, &line))
+    {
+        return EXCEPTION_FORMAT;
     }
 
-    int n = strlen(buffer) - 1;
+    int n = line.end - line.begin;
 
     if (n < 1)
     {
-        fprintf(stderr, EXCEPTION_FORMAT);
-
-        return 1;
+        return EXCEPTION_FORMAT;
     }
 
     struct Table data;
@@ -299,9 +436,21 @@ int main(void)
 
     do
     {
-        table_matrix_add_row(&data, buffer);
+        if (line.end - line.begin != n)
+        {
+            finalize_table(&data);
+
+            return EXCEPTION_FORMAT;
+        }
+
+        if (!table_matrix_add_row(&data, line.begin))
+        {
+            finalize_table(&data);
+
+            return EXCEPTION_OUT_OF_MEMORY;
+        }
     }
-    while (fgets(buffer, n + 2, stdin));
+    while (stream_next_line(&reader, &line));
 
     int max = 0;
     Direction hiRight[DIRECTION_NONE];
@@ -318,23 +467,34 @@ int main(void)
     current.i = data.rows - 1;
     current.direction = DIRECTION_HI;
 
-    scan_horizontal(&data, &current, hiRight, loRight, &max);
+    bool scanned = scan_horizontal(&data, &current, hiRight, loRight, &max);
 
     current.i = 0;
     current.direction = DIRECTION_LO;
-
-    scan_horizontal(&data, &current, hiRight, loRight, &max);
-
+    scanned = scanned &&
+        scan_horizontal(&data, &current, hiRight, loRight, &max);
     current.j = data.columns - 1;
     current.direction = DIRECTION_LEFT;
-
-    scan_vertical(&data, &current, hiRight, loRight, &max);
-
+    scanned = scanned &&
+        scan_vertical(&data, &current, hiRight, loRight, &max);
     current.j = 0;
     current.direction = DIRECTION_RIGHT;
+    scanned = scanned &&
+        scan_vertical(&data, &current, hiRight, loRight, &max);
 
-    scan_vertical(&data, &current, hiRight, loRight, &max);
-    printf("16b %d %lf\n", max, (double)(clock() - start) / CLOCKS_PER_SEC);
+    finalize_table(&data);
+
+    if (!scanned)
+    {
+        return EXCEPTION_OUT_OF_MEMORY;
+    }
 
-    return 0;
+    *result = max;
+
+    return EXCEPTION_NONE;
+}
+
+int main(void)
+{
+    return solver_main("16b", solve);
 }
@@ -4,14 +4,12 @@
 
 #include <limits.h>
 #include <stdbool.h>
-#include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
-#include <time.h>
-#define COORDINATE_QUEUE_CAPACITY 32768
-#define DIMENSION 256
-#define EXCEPTION_FORMAT "Error: Format.\n"
-#define EXCEPTION_OUT_OF_MEMORY "Error: Out of memory.\n"
+#include "../lib/solver.h"
+#include "../lib/stream.h"
+#include "../lib/queue.h"
+#include "../lib/workspace.h"
 #define STEP_MIN 4
 #define STEP_MAX 11
 
@@ -34,13 +32,6 @@ struct Coordinate
     enum Direction direction;
 };
 
-struct CoordinateQueue
-{
-    struct Coordinate items[COORDINATE_QUEUE_CAPACITY];
-    int first;
-    int last;
-};
-
 struct State
 {
     int priority;
@@ -52,16 +43,25 @@ struct State
 
 struct StateMatrix
 {
-    struct State items[DIMENSION * DIMENSION];
+    struct State* items;
+    size_t capacity;
     int rows;
     int columns;
 };
 
+// The structures of a search, kept in a workspace between inputs.
+
+struct Search
+{
+    struct StateMatrix matrix;
+    struct Queue frontier;
+};
+
 typedef enum Direction Direction;
 typedef struct Coordinate* Coordinate;
-typedef struct CoordinateQueue* CoordinateQueue;
 typedef struct State* State;
 typedef struct StateMatrix* StateMatrix;
+typedef struct Search* Search;
 
 int math_min(int a, int b)
 {
@@ -73,70 +73,88 @@ int math_min(int a, int b)
     return b;
 }
 
-void coordinate_queue(CoordinateQueue instance)
+void state(State instance, int priority)
 {
-    instance->first = -1;
-    instance->last = -1;
+    instance->priority = priority;
+    instance->hi = LOCAL_MAX;
+    instance->lo = LOCAL_MAX;
+    instance->left = LOCAL_MAX;
+    instance->right = LOCAL_MAX;
 }
 
-void coordinate_queue_enqueue(CoordinateQueue instance, Coordinate item)
+void state_matrix(StateMatrix instance)
 {
-    if (instance->first == -1)
-    {
-        instance->first = 0;
-        instance->last = 0;
-    }
-    else if (instance->first && instance->last == COORDINATE_QUEUE_CAPACITY - 1)
-    {
-        instance->last = 0;
-    }
-    else
-    {
-        instance->last++;
-    }
+    instance->items = NULL;
+    instance->capacity = 0;
+    instance->rows = 0;
+    instance->columns = 0;
+}
 
-    instance->items[instance->last] = *item;
+// Removes every row, keeping the storage, and sets the number of columns.
+
+void state_matrix_clear(StateMatrix instance, int columns)
+{
+    instance->rows = 0;
+    instance->columns = columns;
 }
 
-bool coordinate_queue_try_dequeue(CoordinateQueue instance, Coordinate result)
+bool state_matrix_add_row(StateMatrix instance)
 {
-    if (instance->first == -1)
+    size_t count = (size_t)(instance->rows + 1) * instance->columns;
+
+    if (count > instance->capacity)
     {
-        return false;
-    }
+        size_t newCapacity = instance->capacity * 2;
 
-    *result = instance->items[instance->first];
+        // The first rows are expected to form a square grid.
 
-    if (instance->first == instance->last)
-    {
-        instance->first = -1;
-        instance->last = -1;
-    }
-    else if (instance->first == COORDINATE_QUEUE_CAPACITY - 1)
-    {
-        instance->first = 0;
-    }
-    else
-    {
-        instance->first++;
+        if (newCapacity < (size_t)instance->columns * instance->columns)
+        {
+            newCapacity = (size_t)instance->columns * instance->columns;
+        }
+
+        if (newCapacity < count)
+        {
+            newCapacity = count;
+        }
+
+        State newItems = realloc(
+            instance->items,
+            newCapacity * sizeof * newItems);
+
+        if (!newItems)
+        {
+            return false;
+        }
+
+        instance->items = newItems;
+        instance->capacity = newCapacity;
     }
 
+    instance->rows++;
+
     return true;
 }
 
-void state(State instance, int priority)
+void finalize_state_matrix(StateMatrix instance)
 {
-    instance->priority = priority;
-    instance->hi = LOCAL_MAX;
-    instance->lo = LOCAL_MAX;
-    instance->left = LOCAL_MAX;
-    instance->right = LOCAL_MAX;
+    free(instance->items);
 }
 
-void state_matrix(StateMatrix instance, int columns)
+static void search(void* instance)
 {
-    instance->rows = 0;
-    instance->columns = columns;
+    Search search = instance;
+
+    state_matrix(&search->matrix);
+    queue(&search->frontier, sizeof(struct Coordinate));
+}
+
+static void finalize_search(void* instance)
+{
+    Search search = instance;
+
+    finalize_state_matrix(&search->matrix);
+    finalize_queue(&search->frontier);
 }
 
 State state_matrix_get(StateMatrix instance, int i, int j)
@@ -144,11 +162,31 @@ State state_matrix_get(StateMatrix instance, int i, int j)
     return instance->items + (i * instance->columns) + j;
 }
 
-static void scan_hi(
+// Returns the number of directions from which each state has been reached,
+// summed over all states.
+
+long long state_matrix_reached(StateMatrix instance)
+{
+    long long result = 0;
+    State end = instance->items + (instance->rows * instance->columns);
+
+    for (State p = instance->items; p < end; p++)
+    {
+        result +=
+            (p->hi != LOCAL_MAX) +
+            (p->lo != LOCAL_MAX) +
+            (p->left != LOCAL_MAX) +
+            (p->right != LOCAL_MAX);
+    }
+
+    return result;
+}
+
+static bool scan_hi(
     StateMatrix matrix,
     Coordinate current,
     int priority,
-    CoordinateQueue queue)
+    Queue queue)
 {
     struct Coordinate coordinate;
 
@@ -161,7 +199,7 @@ static void scan_hi(
 
         if (coordinate.i < 0)
         {
-            return;
+            return true;
         }
 
         State state = state_matrix_get(matrix, coordinate.i, coordinate.j);
@@ -175,15 +213,24 @@ static void scan_hi(
 
         state->lo = priority;
 
-        coordinate_queue_enqueue(queue, &coordinate);
+        Coordinate next = queue_enqueue(queue);
+
+        if (!next)
+        {
+            return false;
+        }
+
+        *next = coordinate;
     }
+
+    return true;
 }
 
-static void scan_lo(
+static bool scan_lo(
     StateMatrix matrix,
     Coordinate current,
     int priority,
-    CoordinateQueue queue)
+    Queue queue)
 {
     struct Coordinate coordinate;
 
@@ -196,7 +243,7 @@ static void scan_lo(
 
         if (coordinate.i >= matrix->rows)
         {
-            return;
+            return true;
         }
 
         State state = state_matrix_get(matrix, coordinate.i, coordinate.j);
@@ -210,15 +257,24 @@ static void scan_lo(
 
         state->hi = priority;
 
-        coordinate_queue_enqueue(queue, &coordinate);
+        Coordinate next = queue_enqueue(queue);
+
+        if (!next)
+        {
+            return false;
+        }
+
+        *next = coordinate;
     }
+
+    return true;
 }
 
-static void scan_left(
+static bool scan_left(
     StateMatrix matrix,
     Coordinate current,
     int priority,
-    CoordinateQueue queue)
+    Queue queue)
 {
     struct Coordinate coordinate;
 
@@ -231,7 +287,7 @@ static void scan_left(
 
         if (coordinate.j < 0)
         {
-            return;
+            return true;
         }
 
         State state = state_matrix_get(matrix, coordinate.i, coordinate.j);
@@ -245,15 +301,24 @@ static void scan_left(
 
         state->right = priority;
 
-        coordinate_queue_enqueue(queue, &coordinate);
+        Coordinate next = queue_enqueue(queue);
+
+        if (!next)
+        {
+            return false;
+        }
+
+        *next = coordinate;
     }
+
+    return true;
 }
 
-static void scan_right(
+static bool scan_right(
     StateMatrix matrix,
     Coordinate current,
     int priority,
-    CoordinateQueue queue)
+    Queue queue)
 {
     struct Coordinate coordinate;
 
@@ -266,7 +331,7 @@ static void scan_right(
 
         if (coordinate.j >= matrix->columns)
         {
-            return;
+            return true;
         }
 
         State state = state_matrix_get(matrix, coordinate.i, coordinate.j);
@@ -280,70 +345,75 @@ static void scan_right(
 
         state->left = priority;
 
-        coordinate_queue_enqueue(queue, &coordinate);
+        Coordinate next = queue_enqueue(queue);
+
+        if (!next)
+        {
+            return false;
+        }
+
+        *next = coordinate;
     }
+
+    return true;
 }
 
-int main(void)
+Exception solve(const char* input, size_t length, long long* result)
 {
-    StateMatrix matrix = malloc(sizeof * matrix);
+    struct Stream reader;
+    struct StringView line;
 
-    if (!matrix)
-    {
-        fprintf(stderr, EXCEPTION_OUT_OF_MEMORY);
-
-        return 1;
-    }
-
-    CoordinateQueue queue = malloc(sizeof * queue);
+    stream(&reader, input, length);
 
-    if (!queue)
+    if (!stream_next_line(&reader, &line))
     {
-        fprintf(stderr, EXCEPTION_OUT_OF_MEMORY);
-
-        return 1;
+        return EXCEPTION_FORMAT;
     }
 
-    char buffer[DIMENSION + 2];
-    clock_t start = clock();
+    int n = line.end - line.begin;
 
-    if (!fgets(buffer, sizeof buffer, stdin))
+    if (n < 1)
     {
-        fprintf(stderr, EXCEPTION_FORMAT);
-
-        return 1;
+        return EXCEPTION_FORMAT;
     }
 
-    int n = strlen(buffer) - 1;
+    Search workspace = workspace_get(
+        "17b",
+        sizeof * workspace,
+        search,
+        finalize_search);
 
-    if (n < 1)
+    if (!workspace)
     {
-        fprintf(stderr, EXCEPTION_FORMAT);
-
-        return 1;
+        return EXCEPTION_OUT_OF_MEMORY;
     }
 
-    state_matrix(matrix, n);
+    StateMatrix matrix = &workspace->matrix;
+    Queue frontier = &workspace->frontier;
+
+    state_matrix_clear(matrix, n);
+    queue_clear(frontier);
 
     do
     {
-        matrix->rows++;
-
-        for (int j = 0; j < n; j++)
+        if (line.end - line.begin != n)
         {
-            if (!buffer[j])
-            {
-                fprintf(stderr, EXCEPTION_FORMAT);
+            return EXCEPTION_FORMAT;
+        }
 
-                return 1;
-            }
+        if (!state_matrix_add_row(matrix))
+        {
+            return EXCEPTION_OUT_OF_MEMORY;
+        }
 
+        for (int j = 0; j < n; j++)
+        {
             State newState = state_matrix_get(matrix, matrix->rows - 1, j);
 
-            state(newState, buffer[j] - '0');
+            state(newState, line.begin[j] - '0');
         }
     }
-    while (fgets(buffer, n + 2, stdin));
+    while (stream_next_line(&reader, &line));
 
     State initialState = state_matrix_get(matrix, 0, 0);
 
@@ -352,29 +422,40 @@ int main(void)
     initialState->left = 0;
     initialState->right = 0;
 
+    long long dequeues = 0;
+    Coordinate next;
     struct Coordinate current = { 0 };
+    bool enqueued = queue_enqueue_many(frontier, &current, 1);
 
-    coordinate_queue(queue);
-    coordinate_queue_enqueue(queue, &current);
-
-    while (coordinate_queue_try_dequeue(queue, &current))
+    while (enqueued && (next = queue_dequeue(frontier)))
     {
+        current = *next;
+        dequeues++;
+
         if (current.direction != DIRECTION_VERTICAL)
         {
-            State currentState = state_matrix_get(matrix, current.i, current.j);
+            State currentState = state_matrix_get(
+                matrix,
+                current.i,
+                current.j);
             int priority = math_min(currentState->left, currentState->right);
 
-            scan_hi(matrix, &current, priority, queue);
-            scan_lo(matrix, &current, priority, queue);
+            enqueued =
+                scan_hi(matrix, &current, priority, frontier) &&
+                scan_lo(matrix, &current, priority, frontier);
         }
 
-        if (current.direction != DIRECTION_HORIZONTAL)
+        if (enqueued && current.direction != DIRECTION_HORIZONTAL)
         {
-            State currentState = state_matrix_get(matrix, current.i, current.j);
+            State currentState = state_matrix_get(
+                matrix,
+                current.i,
+                current.j);
             int priority = math_min(currentState->hi, currentState->lo);
 
-            scan_left(matrix, &current, priority, queue);
-            scan_right(matrix, &current, priority, queue);
+            enqueued =
+                scan_left(matrix, &current, priority, frontier) &&
+                scan_right(matrix, &current, priority, frontier);
         }
     }
 
@@ -387,7 +468,28 @@ int main(void)
     min = math_min(min, finalState->left);
     min = math_min(min, finalState->right);
 
-    printf("17b %d %lf\n", min, (double)(clock() - start) / CLOCKS_PER_SEC);
-    free(matrix);
-    free(queue);
+    // Every relaxation enqueues a coordinate, but the origin is enqueued
+    // without one. A relaxation that does not reach one of the four
+    // directions of a state for the first time improves a distance that was
+    // already enqueued.
+
+    long long relaxations = dequeues - 1;
+
+    solver_work("relaxations", relaxations);
+    solver_work(
+        "reenqueues",
+        relaxations - (state_matrix_reached(matrix) - 4));
+    if (!enqueued)
+    {
+        return EXCEPTION_OUT_OF_MEMORY;
+    }
+
+    *result = min;
+
+    return EXCEPTION_NONE;
+}
+
+int main(void)
+{
+    return solver_main("17b", solve);
 }
@@ -2,78 +2,74 @@
 
 // Lavaduct Lagoon Part 1
 
-#include <stdio.h>
-#include <stdlib.h>
-#include <string.h>
-#include <time.h>
-#define BUFFER_SIZE 16
+#include "../lib/solver.h"
+#include "../lib/stream.h"
 #define DELIMITERS " "
-#define EXCEPTION_FORMAT "Error: Format.\n"
 
-typedef char* String;
-
-long math_pick_theorem_a(long b, long i)
+long long math_pick_theorem_a(long long b, long long i)
 {
     return i + (b / 2) - 1;
 }
 
-int main(void)
+Exception solve(const char* input, size_t length, long long* result)
 {
-    int b = 0;
-    int i = 0;
-    int x = 0;
-    char buffer[BUFFER_SIZE];
-    clock_t start = clock();
+    long long b = 0;
+    long long i = 0;
+    long long x = 0;
+    struct Stream reader;
+    struct StringView line;
+
+    stream(&reader, input, length);
 
-    while (fgets(buffer, sizeof buffer, stdin))
+    while (stream_next_line(&reader, &line))
     {
         char direction;
-        String token = strtok(buffer, DELIMITERS);
+        struct StringView token;
 
-        if (!token)
+        if (!string_view_next_token(&line, DELIMITERS, &token))
         {
-            fprintf(stderr, EXCEPTION_FORMAT);
-
-            return 1;
+            return EXCEPTION_FORMAT;
         }
 
-        direction = token[0];
-        token = strtok(NULL, DELIMITERS);
+        direction = token.begin[0];
 
-        if (!token)
+        if (!string_view_next_token(&line, DELIMITERS, &token))
         {
-            fprintf(stderr, EXCEPTION_FORMAT);
-
-            return 1;
+            return EXCEPTION_FORMAT;
         }
 
-        int length = atoi(token);
+        long long distance = string_view_to_long(&token);
 
         switch (direction)
         {
             case 'U':
-                i += x * length;
+                i += x * distance;
                 break;
 
             case 'D':
-                i -= x * length;
+                i -= x * distance;
                 break;
 
             case 'L':
-                x += length;
+                x += distance;
                 break;
 
             case 'R':
-                x -= length;
+                x -= distance;
                 break;
         }
 
-        b += length;
+        b += distance;
     }
 
-    long area = math_pick_theorem_a(b, i) + 2;
+    long long area = math_pick_theorem_a(b, i) + 2;
 
-    printf("18a %ld %lf\n", area, (double)(clock() - start) / CLOCKS_PER_SEC);
+    *result = area;
 
-    return 0;
+    return EXCEPTION_NONE;
+}
+
+int main(void)
+{
+    return solver_main("18a", solve);
 }
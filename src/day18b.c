@@ -2,64 +2,71 @@
 
 // Lavaduct Lagoon Part 2
 
-#include <stdio.h>
-#include <stdlib.h>
 #include <string.h>
-#include <time.h>
-#define BUFFER_SIZE 16
+#include "../lib/number.h"
+#include "../lib/solver.h"
+#include "../lib/stream.h"
 
 long long math_pick_theorem_a(long long b, long long i)
 {
     return i + (b / 2) - 1;
 }
 
-int main(void)
+Exception solve(const char* input, size_t length, long long* result)
 {
     long long b = 0;
     long long i = 0;
     long long x = 0;
-    char buffer[BUFFER_SIZE];
-    clock_t start = clock();
+    struct Stream reader;
+    struct StringView line;
+
+    stream(&reader, input, length);
 
-    while (fgets(buffer, sizeof buffer, stdin))
+    while (stream_next_line(&reader, &line))
     {
-        char* token = strchr(buffer, '#');
+        const char* token = memchr(line.begin, '#', line.end - line.begin);
 
         if (!token)
         {
-            fprintf(stderr, "Error: Format.\n");
-
-            return 1;
+            return EXCEPTION_FORMAT;
         }
 
-        long n = strtol(token + 1, NULL, 16);
-        int length = n >> 4;
+        long long n;
+
+        number_parse_hexadecimal(token + 1, line.end, &n);
+
+        int distance = n >> 4;
 
         switch (n & 0xf)
         {
             case 0:
-                x -= length;
+                x -= distance;
                 break;
 
             case 1:
-                i -= x * length;
+                i -= x * distance;
                 break;
 
             case 2:
-                x += length;
+                x += distance;
                 break;
 
             case 3:
-                i += x * length;
+                i += x * distance;
                 break;
         }
 
-        b += length;
+        b += distance;
     }
 
     long long area = math_pick_theorem_a(b, i) + 2;
 
-    printf("18b %lld %lf\n", area, (double)(clock() - start) / CLOCKS_PER_SEC);
+    *result = area;
 
-    return 0;
+    return EXCEPTION_NONE;
+}
+
+int main(void)
+{
+    return solver_main("18b", solve);
 }
@@ -4,15 +4,18 @@
 
 #include <ctype.h>
 #include <stdbool.h>
-#include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
-#include <time.h>
-#define BUFFER_SIZE 64
+#include "../lib/solver.h"
+#include "../lib/stream.h"
+#include "../lib/arena.h"
+#include "../lib/cache.h"
+#include "../lib/hash_table.h"
+#include "../lib/shard.h"
+#define ARENA_BLOCK_SIZE 65536
+#define CACHE_NAME "19"
 #define DELIMITERS ","
-#define EXCEPTION_FORMAT "Error: Format.\n"
-#define FUNCTION_DICTIONARY_BUCKETS 1543
-#define FUNCTION_RANGES_CAPACITY 8
+#define FUNCTION_INITIAL_CAPACITY 8
 #define KEY_SIZE 3
 
 enum Property
@@ -35,26 +38,16 @@ struct Range
 struct Function
 {
     int count;
-    struct Range ranges[FUNCTION_RANGES_CAPACITY];
+    int capacity;
+    struct Range* ranges;
 };
 
-struct FunctionDictionaryEntry
-{
-    struct FunctionDictionaryEntry* nextEntry;
-    struct Function value;
-    char key[KEY_SIZE];
-};
-
-struct FunctionDictionaryBucket
-{
-    struct FunctionDictionaryEntry* firstEntry;
-    struct FunctionDictionaryBucket* nextBucket;
-};
+// A workflow in the cache: its name, followed by `count` rules.
 
-struct FunctionDictionary
+struct FunctionRecord
 {
-    struct FunctionDictionaryBucket* firstBucket;
-    struct FunctionDictionaryBucket buckets[FUNCTION_DICTIONARY_BUCKETS];
+    char key[KEY_SIZE];
+    int count;
 };
 
 struct Tokenizer
@@ -68,9 +61,6 @@ typedef char* String;
 typedef enum Property Property;
 typedef struct Range* Range;
 typedef struct Function* Function;
-typedef struct FunctionDictionaryEntry* FunctionDictionaryEntry;
-typedef struct FunctionDictionaryBucket* FunctionDictionaryBucket;
-typedef struct FunctionDictionary* FunctionDictionary;
 typedef struct Tokenizer* Tokenizer;
 
 Property property(char value)
@@ -88,10 +78,36 @@ Property property(char value)
 void function(Function instance)
 {
     instance->count = 0;
+    instance->capacity = 0;
+    instance->ranges = NULL;
 }
 
-Range function_new_range(Function instance)
+Range function_new_range(Function instance, Arena arena)
 {
+    if (instance->count == instance->capacity)
+    {
+        int newCapacity = instance->capacity * 2;
+
+        if (!newCapacity)
+        {
+            newCapacity = FUNCTION_INITIAL_CAPACITY;
+        }
+
+        Range newRanges = arena_reallocate(
+            arena,
+            instance->ranges,
+            instance->capacity * sizeof * newRanges,
+            newCapacity * sizeof * newRanges);
+
+        if (!newRanges)
+        {
+            return NULL;
+        }
+
+        instance->ranges = newRanges;
+        instance->capacity = newCapacity;
+    }
+
     Range result = instance->ranges + instance->count;
 
     instance->count++;
@@ -99,100 +115,33 @@ Range function_new_range(Function instance)
     return result;
 }
 
-static unsigned int function_dictionary_hash(char key[])
+void function_dictionary(HashTable instance)
 {
-    unsigned int hash = 0;
-
-    for (int i = 0; i < KEY_SIZE; i++)
-    {
-        hash = (hash * 36) + key[i] - 97;
-    }
-
-    return hash % FUNCTION_DICTIONARY_BUCKETS;
+    hash_table(instance, KEY_SIZE, sizeof(struct Function), NULL, NULL);
 }
 
-Function function_dictionary_get(FunctionDictionary instance, char key[])
+Function function_dictionary_get(HashTable instance, const char key[])
 {
-    unsigned int hash = function_dictionary_hash(key);
-
-    for (FunctionDictionaryEntry entry = instance->buckets[hash].firstEntry;
-        entry;
-        entry = entry->nextEntry)
-    {
-        if (memcmp(key, entry->key, KEY_SIZE) == 0)
-        {
-            return &entry->value;
-        }
-    }
-
-    return NULL;
+    return hash_table_get(instance, key);
 }
 
 bool function_dictionary_set(
-    FunctionDictionary instance,
-    char key[],
+    HashTable instance,
+    const char key[],
     Function value)
 {
-    FunctionDictionaryEntry* p;
-    unsigned int hash = function_dictionary_hash(key);
+    Function existing = hash_table_add(instance, key, NULL);
 
-    for (p = &instance->buckets[hash].firstEntry; *p; p = &(*p)->nextEntry)
-    {
-        if (memcmp(key, (*p)->key, KEY_SIZE) == 0)
-        {
-            (*p)->value = *value;
-
-            return true;
-        }
-    }
-
-    FunctionDictionaryEntry entry = malloc(sizeof * entry);
-
-    if (!entry)
+    if (!existing)
     {
         return false;
     }
 
-    if (!instance->buckets[hash].firstEntry)
-    {
-        FunctionDictionaryBucket first = instance->firstBucket;
-
-        instance->buckets[hash].nextBucket = first;
-        instance->firstBucket = instance->buckets + hash;
-    }
-
-    memcpy(entry->key, key, KEY_SIZE);
-
-    entry->value = *value;
-    entry->nextEntry = NULL;
-    *p = entry;
+    *existing = *value;
 
     return true;
 }
 
-void function_dictionary_clear(FunctionDictionary instance)
-{
-    for (FunctionDictionaryBucket bucket = instance->firstBucket;
-        bucket;
-        bucket = bucket->nextBucket)
-    {
-        FunctionDictionaryEntry entry = bucket->firstEntry;
-
-        while (entry)
-        {
-            FunctionDictionaryEntry nextEntry = entry->nextEntry;
-
-            free(entry);
-
-            entry = nextEntry;
-        }
-
-        bucket->firstEntry = NULL;
-    }
-
-    instance->firstBucket = NULL;
-}
-
 void tokenizer(Tokenizer instance, String tokens)
 {
     instance->tokens = tokens;
@@ -238,6 +187,11 @@ static bool parse_key(Tokenizer tokenizer, char result[])
 
     while (islower(*tokenizer->current))
     {
+        if (i == KEY_SIZE)
+        {
+            return false;
+        }
+
         result[i] = tokenizer_pop(tokenizer);
         i++;
     }
@@ -292,26 +246,37 @@ static bool parse_range(Tokenizer tokenizer, Range result)
     return true;
 }
 
-static bool parse_function(Tokenizer tokenizer, char key[], Function result)
+static Exception parse_function(
+    Tokenizer tokenizer,
+    Arena arena,
+    char key[],
+    Function result)
 {
     if (!parse_key(tokenizer, key) || tokenizer_pop(tokenizer) != '{')
     {
-        return false;
+        return EXCEPTION_FORMAT;
     }
 
     do
     {
-        if (!parse_range(tokenizer, function_new_range(result)))
+        Range range = function_new_range(result, arena);
+
+        if (!range)
         {
-            return false;
+            return EXCEPTION_OUT_OF_MEMORY;
+        }
+
+        if (!parse_range(tokenizer, range))
+        {
+            return EXCEPTION_FORMAT;
         }
     }
     while (tokenizer_pop(tokenizer) == ',');
 
-    return true;
+    return EXCEPTION_NONE;
 }
 
-static bool scan(Dynamic value, FunctionDictionary dictionary)
+static bool scan(Dynamic value, HashTable dictionary)
 {
     Function current = function_dictionary_get(dictionary, "in");
 
@@ -353,13 +318,15 @@ static bool scan(Dynamic value, FunctionDictionary dictionary)
     return false;
 }
 
-int main(void)
+static Exception read(Stream reader, Arena arena, HashTable dictionary)
 {
-    char buffer[BUFFER_SIZE];
-    struct FunctionDictionary dictionary = { 0 };
-    clock_t start = clock();
+    long count;
+    char* buffer = NULL;
+    size_t capacity = 0;
+    Exception exception = EXCEPTION_NONE;
 
-    while (fgets(buffer, sizeof buffer, stdin))
+    while (!exception &&
+        (count = stream_read_line(reader, &buffer, &capacity)) > 0)
     {
         if (buffer[0] == '\n')
         {
@@ -373,41 +340,177 @@ int main(void)
         tokenizer(&lexer, buffer);
         function(&current);
 
-        if (!parse_function(&lexer, key, &current))
+        exception = parse_function(&lexer, arena, key, &current);
+
+        if (!exception && !function_dictionary_set(dictionary, key, &current))
         {
-            fprintf(stderr, EXCEPTION_FORMAT);
+            exception = EXCEPTION_OUT_OF_MEMORY;
+        }
+    }
+
+    free(buffer);
 
-            return 1;
+    if (count < 0)
+    {
+        return EXCEPTION_OUT_OF_MEMORY;
+    }
+
+    return exception;
+}
+
+static Exception load(Cache cache, Arena arena, HashTable dictionary)
+{
+    const char* p = cache->data;
+    const char* end = p + cache->size;
+
+    while (p < end)
+    {
+        struct FunctionRecord record;
+        struct Function current;
+
+        if ((size_t)(end - p) < sizeof record)
+        {
+            return EXCEPTION_FORMAT;
         }
 
-        if (!function_dictionary_set(&dictionary, key, &current))
+        memcpy(&record, p, sizeof record);
+
+        p += sizeof record;
+
+        if (record.count < 1 ||
+            (size_t)record.count > (end - p) / sizeof * current.ranges)
         {
-            fprintf(stderr, "Error: Out of memory.\n");
+            return EXCEPTION_FORMAT;
+        }
+
+        size_t size = record.count * sizeof * current.ranges;
 
-            return 1;
+        current.count = record.count;
+        current.capacity = record.count;
+        current.ranges = arena_allocate(arena, size);
+
+        if (!current.ranges)
+        {
+            return EXCEPTION_OUT_OF_MEMORY;
         }
+
+        memcpy(current.ranges, p, size);
+
+        p += size;
+
+        if (!function_dictionary_set(dictionary, record.key, &current))
+        {
+            return EXCEPTION_OUT_OF_MEMORY;
+        }
+    }
+
+    return EXCEPTION_NONE;
+}
+
+// Part 2 reads the same workflows, so both parts share one cache file per
+// input.
+
+static void store(HashTable dictionary, const char* input, size_t length)
+{
+    size_t size = 0;
+    struct HashTableIterator iterator;
+
+    hash_table_begin(dictionary, &iterator);
+
+    while (hash_table_next(dictionary, &iterator))
+    {
+        Function current = iterator.value;
+
+        size += sizeof(struct FunctionRecord) +
+            current->count * sizeof * current->ranges;
+    }
+
+    char* payload = malloc(size);
+
+    if (!payload)
+    {
+        return;
     }
 
-    long sum = 0;
+    char* p = payload;
 
-    while (fgets(buffer, sizeof buffer, stdin))
+    hash_table_begin(dictionary, &iterator);
+
+    while (hash_table_next(dictionary, &iterator))
+    {
+        Function current = iterator.value;
+        size_t rangesSize = current->count * sizeof * current->ranges;
+        struct FunctionRecord record;
+
+        memset(&record, 0, sizeof record);
+        memcpy(record.key, iterator.key, KEY_SIZE);
+
+        record.count = current->count;
+
+        memcpy(p, &record, sizeof record);
+
+        p += sizeof record;
+
+        memcpy(p, current->ranges, rangesSize);
+
+        p += rangesSize;
+    }
+
+    cache_store(CACHE_NAME, input, length, payload, size);
+    free(payload);
+}
+
+// Moves past the workflows to the first part rating.
+
+static void skip(Stream reader)
+{
+    struct StringView line;
+
+    while (stream_next_line(reader, &line))
+    {
+        if (line.begin == line.end)
+        {
+            return;
+        }
+    }
+}
+
+// Sums the ratings of the accepted parts on some lines of the input. The
+// workflows are only read, so the lines may be split across threads.
+
+static Exception solve_ratings(
+    const char* input,
+    size_t length,
+    void* context,
+    long long* result)
+{
+    long count;
+    char* buffer = NULL;
+    size_t capacity = 0;
+    long long sum = 0;
+    struct Stream reader;
+
+    stream(&reader, input, length);
+
+    while ((count = stream_read_line(&reader, &buffer, &capacity)) > 0)
     {
         int localSum = 0;
         int dynamic[PROPERTY_NONE];
         Property property = 0;
 
-        for (String token = strtok(buffer, DELIMITERS);
-            token;
-            token = strtok(NULL, DELIMITERS))
+        struct StringView token;
+        struct StringView tokens = { buffer, buffer + count };
+
+        while (string_view_next_token(&tokens, DELIMITERS, &token))
         {
-            char* p = strchr(token, '=');
+            char* p = memchr(token.begin, '=', token.end - token.begin);
             struct Tokenizer lexer;
 
-            if (!p)
+            if (!p || property == PROPERTY_NONE)
             {
-                fprintf(stderr, EXCEPTION_FORMAT);
+                free(buffer);
 
-                return 1;
+                return EXCEPTION_FORMAT;
             }
 
             int number;
@@ -420,14 +523,86 @@ int main(void)
             property++;
         }
 
-        if (scan(dynamic, &dictionary))
+        if (scan(dynamic, context))
         {
             sum += localSum;
         }
     }
 
-    printf("19a %ld %lf\n", sum, (double)(clock() - start) / CLOCKS_PER_SEC);
-    function_dictionary_clear(&dictionary);
+    free(buffer);
+
+    if (count < 0)
+    {
+        return EXCEPTION_OUT_OF_MEMORY;
+    }
 
-    return 0;
+    *result = sum;
+
+    return EXCEPTION_NONE;
+}
+
+Exception solve(const char* input, size_t length, long long* result)
+{
+    Exception exception;
+    struct Arena ranges;
+    struct Cache cache;
+    struct HashTable dictionary;
+    struct Stream reader;
+
+    stream(&reader, input, length);
+    arena(&ranges, ARENA_BLOCK_SIZE);
+    function_dictionary(&dictionary);
+
+    if (cache_load(&cache, CACHE_NAME, input, length))
+    {
+        exception = load(&cache, &ranges, &dictionary);
+
+        finalize_cache(&cache);
+        skip(&reader);
+    }
+    else
+    {
+        exception = read(&reader, &ranges, &dictionary);
+
+        if (!exception && cache_enabled())
+        {
+            store(&dictionary, input, length);
+        }
+    }
+
+    if (exception)
+    {
+        finalize_hash_table(&dictionary);
+        finalize_arena(&ranges);
+
+        return exception;
+    }
+
+    long long sum;
+
+    exception = shard_solve_context(
+        reader.current,
+        reader.end - reader.current,
+        solve_ratings,
+        &dictionary,
+        SHARD_LINE,
+        solver_threads(),
+        &sum);
+
+    finalize_hash_table(&dictionary);
+    finalize_arena(&ranges);
+
+    if (exception)
+    {
+        return exception;
+    }
+
+    *result = sum;
+
+    return EXCEPTION_NONE;
+}
+
+int main(void)
+{
+    return solver_main("19a", solve);
 }
@@ -4,15 +4,18 @@
 
 #include <ctype.h>
 #include <stdbool.h>
-#include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
-#include <time.h>
-#define BUFFER_SIZE 64
-#define CALL_STACK_CAPACITY 8
+#include "../lib/solver.h"
+#include "../lib/stream.h"
+#include "../lib/arena.h"
+#include "../lib/cache.h"
+#include "../lib/hash_table.h"
+#define CALL_STACK_INITIAL_CAPACITY 8
+#define ARENA_BLOCK_SIZE 65536
+#define CACHE_NAME "19"
 #define DELIMITERS ","
-#define FUNCTION_DICTIONARY_BUCKETS 1543
-#define FUNCTION_RANGES_CAPACITY 8
+#define FUNCTION_INITIAL_CAPACITY 8
 #define KEY_SIZE 3
 
 enum Property
@@ -41,7 +44,8 @@ struct Range
 struct Function
 {
     int count;
-    struct Range ranges[FUNCTION_RANGES_CAPACITY];
+    int capacity;
+    struct Range* ranges;
 };
 
 struct Call
@@ -52,27 +56,17 @@ struct Call
 
 struct CallStack
 {
-    struct Call items[CALL_STACK_CAPACITY];
+    struct Call* items;
     int count;
+    int capacity;
 };
 
-struct FunctionDictionaryEntry
-{
-    struct FunctionDictionaryEntry* nextEntry;
-    struct Function value;
-    char key[KEY_SIZE];
-};
-
-struct FunctionDictionaryBucket
-{
-    struct FunctionDictionaryEntry* firstEntry;
-    struct FunctionDictionaryBucket* nextBucket;
-};
+// A workflow in the cache: its name, followed by `count` rules.
 
-struct FunctionDictionary
+struct FunctionRecord
 {
-    struct FunctionDictionaryBucket* firstBucket;
-    struct FunctionDictionaryBucket buckets[FUNCTION_DICTIONARY_BUCKETS];
+    char key[KEY_SIZE];
+    int count;
 };
 
 struct Tokenizer
@@ -89,9 +83,6 @@ typedef struct Range* Range;
 typedef struct Function* Function;
 typedef struct Call* Call;
 typedef struct CallStack* CallStack;
-typedef struct FunctionDictionaryEntry* FunctionDictionaryEntry;
-typedef struct FunctionDictionaryBucket* FunctionDictionaryBucket;
-typedef struct FunctionDictionary* FunctionDictionary;
 typedef struct Tokenizer* Tokenizer;
 
 Property property(char value)
@@ -117,13 +108,39 @@ void b_dynamic(BDynamic instance)
 
 void call_stack(CallStack instance)
 {
+    instance->items = NULL;
     instance->count = 0;
+    instance->capacity = 0;
 }
 
-void call_stack_push(CallStack instance, Call item)
+bool call_stack_push(CallStack instance, Call item)
 {
+    if (instance->count == instance->capacity)
+    {
+        int newCapacity = instance->capacity * 2;
+
+        if (!newCapacity)
+        {
+            newCapacity = CALL_STACK_INITIAL_CAPACITY;
+        }
+
+        Call newItems = realloc(
+            instance->items,
+            newCapacity * sizeof * newItems);
+
+        if (!newItems)
+        {
+            return false;
+        }
+
+        instance->items = newItems;
+        instance->capacity = newCapacity;
+    }
+
     instance->items[instance->count] = *item;
     instance->count++;
+
+    return true;
 }
 
 bool call_stack_try_pop(CallStack instance, Call result)
@@ -139,13 +156,44 @@ bool call_stack_try_pop(CallStack instance, Call result)
     return true;
 }
 
+void finalize_call_stack(CallStack instance)
+{
+    free(instance->items);
+}
+
 void function(Function instance)
 {
     instance->count = 0;
+    instance->capacity = 0;
+    instance->ranges = NULL;
 }
 
-Range function_new_range(Function instance)
+Range function_new_range(Function instance, Arena arena)
 {
+    if (instance->count == instance->capacity)
+    {
+        int newCapacity = instance->capacity * 2;
+
+        if (!newCapacity)
+        {
+            newCapacity = FUNCTION_INITIAL_CAPACITY;
+        }
+
+        Range newRanges = arena_reallocate(
+            arena,
+            instance->ranges,
+            instance->capacity * sizeof * newRanges,
+            newCapacity * sizeof * newRanges);
+
+        if (!newRanges)
+        {
+            return NULL;
+        }
+
+        instance->ranges = newRanges;
+        instance->capacity = newCapacity;
+    }
+
     Range result = instance->ranges + instance->count;
 
     instance->count++;
@@ -153,100 +201,33 @@ Range function_new_range(Function instance)
     return result;
 }
 
-static unsigned int function_dictionary_hash(char key[])
+void function_dictionary(HashTable instance)
 {
-    unsigned int hash = 0;
-
-    for (int i = 0; i < KEY_SIZE; i++)
-    {
-        hash = (hash * 36) + key[i] - 97;
-    }
-
-    return hash % FUNCTION_DICTIONARY_BUCKETS;
+    hash_table(instance, KEY_SIZE, sizeof(struct Function), NULL, NULL);
 }
 
-Function function_dictionary_get(FunctionDictionary instance, char key[])
+Function function_dictionary_get(HashTable instance, const char key[])
 {
-    unsigned int hash = function_dictionary_hash(key);
-
-    for (FunctionDictionaryEntry entry = instance->buckets[hash].firstEntry;
-        entry;
-        entry = entry->nextEntry)
-    {
-        if (memcmp(key, entry->key, KEY_SIZE) == 0)
-        {
-            return &entry->value;
-        }
-    }
-
-    return NULL;
+    return hash_table_get(instance, key);
 }
 
 bool function_dictionary_set(
-    FunctionDictionary instance,
-    char key[],
+    HashTable instance,
+    const char key[],
     Function value)
 {
-    FunctionDictionaryEntry* p;
-    unsigned int hash = function_dictionary_hash(key);
-
-    for (p = &instance->buckets[hash].firstEntry; *p; p = &(*p)->nextEntry)
-    {
-        if (memcmp(key, (*p)->key, KEY_SIZE) == 0)
-        {
-            (*p)->value = *value;
-
-            return true;
-        }
-    }
+    Function existing = hash_table_add(instance, key, NULL);
 
-    FunctionDictionaryEntry entry = malloc(sizeof * entry);
-
-    if (!entry)
+    if (!existing)
     {
         return false;
     }
 
-    if (!instance->buckets[hash].firstEntry)
-    {
-        FunctionDictionaryBucket first = instance->firstBucket;
-
-        instance->buckets[hash].nextBucket = first;
-        instance->firstBucket = instance->buckets + hash;
-    }
-
-    memcpy(entry->key, key, KEY_SIZE);
-
-    entry->value = *value;
-    entry->nextEntry = NULL;
-    *p = entry;
+    *existing = *value;
 
     return true;
 }
 
-void function_dictionary_clear(FunctionDictionary instance)
-{
-    for (FunctionDictionaryBucket bucket = instance->firstBucket;
-        bucket;
-        bucket = bucket->nextBucket)
-    {
-        FunctionDictionaryEntry entry = bucket->firstEntry;
-
-        while (entry)
-        {
-            FunctionDictionaryEntry nextEntry = entry->nextEntry;
-
-            free(entry);
-
-            entry = nextEntry;
-        }
-
-        bucket->firstEntry = NULL;
-    }
-
-    instance->firstBucket = NULL;
-}
-
 void tokenizer(Tokenizer instance, String tokens)
 {
     instance->tokens = tokens;
@@ -292,6 +273,11 @@ static bool parse_key(Tokenizer tokenizer, char result[])
 
     while (islower(*tokenizer->current))
     {
+        if (i == KEY_SIZE)
+        {
+            return false;
+        }
+
         result[i] = tokenizer_pop(tokenizer);
         i++;
     }
@@ -346,29 +332,40 @@ static bool parse_range(Tokenizer tokenizer, Range result)
     return true;
 }
 
-static bool parse_function(Tokenizer tokenizer, char key[], Function result)
+static Exception parse_function(
+    Tokenizer tokenizer,
+    Arena arena,
+    char key[],
+    Function result)
 {
     if (!parse_key(tokenizer, key) || tokenizer_pop(tokenizer) != '{')
     {
-        return false;
+        return EXCEPTION_FORMAT;
     }
 
     do
     {
-        if (!parse_range(tokenizer, function_new_range(result)))
+        Range range = function_new_range(result, arena);
+
+        if (!range)
         {
-            return false;
+            return EXCEPTION_OUT_OF_MEMORY;
+        }
+
+        if (!parse_range(tokenizer, range))
+        {
+            return EXCEPTION_FORMAT;
         }
     }
     while (tokenizer_pop(tokenizer) == ',');
 
-    return true;
+    return EXCEPTION_NONE;
 }
 
 static long long scan(
     Call current,
     CallStack stack,
-    FunctionDictionary dictionary)
+    HashTable dictionary)
 {
     for (Range range = current->function->ranges;
         range < current->function->ranges + current->function->count;
@@ -391,7 +388,10 @@ static long long scan(
                     next.value[range->identifier].min = comparand;
                     current->value[range->identifier].max = comparand;
 
-                    call_stack_push(stack, &next);
+                    if (!call_stack_push(stack, &next))
+                    {
+                        return -1;
+                    }
                 }
                 break;
 
@@ -407,7 +407,10 @@ static long long scan(
                     next.value[range->identifier].max = comparand + 1;
                     current->value[range->identifier].min = comparand + 1;
 
-                    call_stack_push(stack, &next);
+                    if (!call_stack_push(stack, &next))
+                    {
+                        return -1;
+                    }
                 }
                 break;
         }
@@ -432,7 +435,10 @@ static long long scan(
         next = *current;
         next.function = function_dictionary_get(dictionary, range->action);
 
-        call_stack_push(stack, &next);
+        if (!call_stack_push(stack, &next))
+        {
+            return -1;
+        }
 
         break;
     }
@@ -440,13 +446,15 @@ static long long scan(
     return 0;
 }
 
-int main(void)
+static Exception read(Stream reader, Arena arena, HashTable dictionary)
 {
-    char buffer[BUFFER_SIZE];
-    struct FunctionDictionary dictionary = { 0 };
-    clock_t start = clock();
+    long count;
+    char* buffer = NULL;
+    size_t capacity = 0;
+    Exception exception = EXCEPTION_NONE;
 
-    while (fgets(buffer, sizeof buffer, stdin))
+    while (!exception &&
+        (count = stream_read_line(reader, &buffer, &capacity)) > 0)
     {
         if (buffer[0] == '\n')
         {
@@ -460,21 +468,162 @@ int main(void)
         tokenizer(&lexer, buffer);
         function(&current);
 
-        if (!parse_function(&lexer, key, &current))
+        exception = parse_function(&lexer, arena, key, &current);
+
+        if (!exception && !function_dictionary_set(dictionary, key, &current))
+        {
+            exception = EXCEPTION_OUT_OF_MEMORY;
+        }
+    }
+
+    free(buffer);
+
+    if (count < 0)
+    {
+        return EXCEPTION_OUT_OF_MEMORY;
+    }
+
+    return exception;
+}
+
+static Exception load(Cache cache, Arena arena, HashTable dictionary)
+{
+    const char* p = cache->data;
+    const char* end = p + cache->size;
+
+    while (p < end)
+    {
+        struct FunctionRecord record;
+        struct Function current;
+
+        if ((size_t)(end - p) < sizeof record)
         {
-            fprintf(stderr, "Error: Format.\n");
+            return EXCEPTION_FORMAT;
+        }
+
+        memcpy(&record, p, sizeof record);
 
-            return 1;
+        p += sizeof record;
+
+        if (record.count < 1 ||
+            (size_t)record.count > (end - p) / sizeof * current.ranges)
+        {
+            return EXCEPTION_FORMAT;
         }
 
-        if (!function_dictionary_set(&dictionary, key, &current))
+        size_t size = record.count * sizeof * current.ranges;
+
+        current.count = record.count;
+        current.capacity = record.count;
+        current.ranges = arena_allocate(arena, size);
+
+        if (!current.ranges)
         {
-            fprintf(stderr, "Error: Out of memory.\n");
+            return EXCEPTION_OUT_OF_MEMORY;
+        }
+
+        memcpy(current.ranges, p, size);
+
+        p += size;
+
+        if (!function_dictionary_set(dictionary, record.key, &current))
+        {
+            return EXCEPTION_OUT_OF_MEMORY;
+        }
+    }
+
+    return EXCEPTION_NONE;
+}
+
+// Part 1 reads the same workflows, so both parts share one cache file per
+// input.
+
+static void store(HashTable dictionary, const char* input, size_t length)
+{
+    size_t size = 0;
+    struct HashTableIterator iterator;
+
+    hash_table_begin(dictionary, &iterator);
+
+    while (hash_table_next(dictionary, &iterator))
+    {
+        Function current = iterator.value;
+
+        size += sizeof(struct FunctionRecord) +
+            current->count * sizeof * current->ranges;
+    }
+
+    char* payload = malloc(size);
+
+    if (!payload)
+    {
+        return;
+    }
+
+    char* p = payload;
+
+    hash_table_begin(dictionary, &iterator);
+
+    while (hash_table_next(dictionary, &iterator))
+    {
+        Function current = iterator.value;
+        size_t rangesSize = current->count * sizeof * current->ranges;
+        struct FunctionRecord record;
+
+        memset(&record, 0, sizeof record);
+        memcpy(record.key, iterator.key, KEY_SIZE);
 
-            return 1;
+        record.count = current->count;
+
+        memcpy(p, &record, sizeof record);
+
+        p += sizeof record;
+
+        memcpy(p, current->ranges, rangesSize);
+
+        p += rangesSize;
+    }
+
+    cache_store(CACHE_NAME, input, length, payload, size);
+    free(payload);
+}
+
+Exception solve(const char* input, size_t length, long long* result)
+{
+    Exception exception;
+    struct Arena ranges;
+    struct Cache cache;
+    struct HashTable dictionary;
+    struct Stream reader;
+
+    stream(&reader, input, length);
+    arena(&ranges, ARENA_BLOCK_SIZE);
+    function_dictionary(&dictionary);
+
+    if (cache_load(&cache, CACHE_NAME, input, length))
+    {
+        exception = load(&cache, &ranges, &dictionary);
+
+        finalize_cache(&cache);
+    }
+    else
+    {
+        exception = read(&reader, &ranges, &dictionary);
+
+        if (!exception && cache_enabled())
+        {
+            store(&dictionary, input, length);
         }
     }
 
+    if (exception)
+    {
+        finalize_hash_table(&dictionary);
+        finalize_arena(&ranges);
+
+        return exception;
+    }
+
     long long total = 0;
     struct Call current;
     struct CallStack stack;
@@ -483,15 +632,55 @@ int main(void)
 
     b_dynamic(current.value);
     call_stack(&stack);
-    call_stack_push(&stack, &current);
 
-    while (call_stack_try_pop(&stack, &current))
+    if (!dictionary.count)
+    {
+        exception = EXCEPTION_FORMAT;
+    }
+    else if (!call_stack_push(&stack, &current))
     {
-        total += scan(&current, &stack, &dictionary);
+        exception = EXCEPTION_OUT_OF_MEMORY;
     }
 
-    printf("19b %lld %lf\n", total, (double)(clock() - start) / CLOCKS_PER_SEC);
-    function_dictionary_clear(&dictionary);
+    while (!exception && call_stack_try_pop(&stack, &current))
+    {
+        // The "in" workflow, or a workflow that a rule sends parts to, is
+        // undefined.
 
-    return 0;
+        if (!current.function)
+        {
+            exception = EXCEPTION_KEY_NOT_FOUND;
+
+            continue;
+        }
+
+        long long product = scan(&current, &stack, &dictionary);
+
+        if (product < 0)
+        {
+            exception = EXCEPTION_OUT_OF_MEMORY;
+
+            continue;
+        }
+
+        total += product;
+    }
+
+    finalize_call_stack(&stack);
+    finalize_hash_table(&dictionary);
+    finalize_arena(&ranges);
+
+    if (exception)
+    {
+        return exception;
+    }
+
+    *result = total;
+
+    return EXCEPTION_NONE;
+}
+
+int main(void)
+{
+    return solver_main("19b", solve);
 }
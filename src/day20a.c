@@ -3,42 +3,19 @@
 // Pulse Propagation Part 1
 
 #include <stdbool.h>
-#include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
-#include <time.h>
-#define BUFFER_SIZE 32
+#include "../lib/solver.h"
+#include "../lib/stream.h"
+#include "../lib/hash_table.h"
+#include "../lib/queue.h"
 #define DELIMITERS ", \n"
-#define DICTIONARY_BUCKETS 53
-#define EXCEPTION_OUT_OF_MEMORY "Error: Out of memory.\n"
-#define MESSAGE_QUEUE_CAPACITY 64
-#define MODULE_COLLECTION_BUCKETS 97
-#define MODULE_TARGETS_CAPACITY 8
-#define STRING_CAPACITY 16
+#define MODULE_INITIAL_CAPACITY 8
 
 struct String
 {
     int length;
-    char buffer[STRING_CAPACITY];
-};
-
-struct DictionaryEntry
-{
-    struct DictionaryEntry* nextEntry;
-    struct String key;
-    bool value;
-};
-
-struct DictionaryBucket
-{
-    struct DictionaryEntry* firstEntry;
-    struct DictionaryBucket* nextBucket;
-};
-
-struct Dictionary
-{
-    struct DictionaryBucket* firstBucket;
-    struct DictionaryBucket buckets[DICTIONARY_BUCKETS];
+    const char* buffer;
 };
 
 struct Message
@@ -48,67 +25,47 @@ struct Message
     bool pulse;
 };
 
-struct MessageQueue
+struct Conjunction
 {
-    int first;
-    int last;
-    struct Message items[MESSAGE_QUEUE_CAPACITY];
+    struct HashTable pulses;
+    int high;
 };
 
 union ModuleType
 {
     bool pulse;
-    struct Dictionary* pulses;
+    struct Conjunction conjunction;
 };
 
 struct Module
 {
-    struct Module* nextModule;
     union ModuleType child;
     int targetCount;
+    int targetCapacity;
     struct String name;
-    struct String targets[MODULE_TARGETS_CAPACITY];
+    struct String* targets;
     bool isConjunction;
 };
 
-struct ModuleCollectionBucket
-{
-    struct Module* firstModule;
-    struct ModuleCollectionBucket* nextBucket;
-};
-
-struct ModuleCollection
-{
-    struct ModuleCollectionBucket* firstBucket;
-    struct ModuleCollectionBucket buckets[MODULE_COLLECTION_BUCKETS];
-};
-
-typedef char* ZString;
 typedef struct String* String;
-typedef struct DictionaryEntry* DictionaryEntry;
-typedef struct DictionaryBucket* DictionaryBucket;
-typedef struct Dictionary* Dictionary;
+typedef const void* Object;
+typedef struct Conjunction* Conjunction;
 typedef struct Message* Message;
-typedef struct MessageQueue* MessageQueue;
 typedef struct Module* Module;
-typedef struct ModuleCollectionBucket* ModuleCollectionBucket;
-typedef struct ModuleCollection* ModuleCollection;
 
-void string(String instance, ZString buffer)
+void string(String instance, StringView value)
 {
-    instance->length = strlen(buffer);
-
-    memcpy(instance->buffer, buffer, instance->length);
+    instance->length = value->end - value->begin;
+    instance->buffer = value->begin;
 }
 
 void string_copy(String destination, String source)
 {
     destination->length = source->length;
-
-    memcpy(destination->buffer, source->buffer, source->length);
+    destination->buffer = source->buffer;
 }
 
-bool string_equals(String instance, String other)
+bool string_equals(const struct String* instance, const struct String* other)
 {
     if (instance->length != other->length)
     {
@@ -118,7 +75,7 @@ bool string_equals(String instance, String other)
     return memcmp(instance->buffer, other->buffer, instance->length) == 0;
 }
 
-unsigned int string_get_hash_code(String instance)
+unsigned int string_get_hash_code(const struct String* instance)
 {
     unsigned int hash = 0;
 
@@ -130,198 +87,100 @@ unsigned int string_get_hash_code(String instance)
     return hash;
 }
 
-void dictionary(Dictionary instance)
+static unsigned int string_table_hash(Object key, size_t size)
 {
-    instance->firstBucket = NULL;
+    (void)size;
 
-    for (int i = 0; i < DICTIONARY_BUCKETS; i++)
-    {
-        instance->buckets[i].firstEntry = NULL;
-        instance->buckets[i].nextBucket = NULL;
-    }
+    return string_get_hash_code(key);
 }
 
-bool dictionary_try_get_value(Dictionary instance, String key, bool* result)
+static bool string_table_equals(Object left, Object right, size_t size)
 {
-    unsigned int hash = string_get_hash_code(key) % DICTIONARY_BUCKETS;
+    (void)size;
 
-    for (DictionaryEntry entry = instance->buckets[hash].firstEntry;
-        entry;
-        entry = entry->nextEntry)
-    {
-        if (string_equals(key, &entry->key))
-        {
-            *result = entry->value;
-
-            return true;
-        }
-    }
-
-    return false;
+    return string_equals(left, right);
 }
 
-bool dictionary_set(Dictionary instance, String key, bool value)
+void string_table(HashTable instance, size_t valueSize)
 {
-    DictionaryEntry* p;
-    unsigned int hash = string_get_hash_code(key) % DICTIONARY_BUCKETS;
-
-    for (p = &instance->buckets[hash].firstEntry; *p; p = &(*p)->nextEntry)
-    {
-        if (string_equals(key, &(*p)->key))
-        {
-            (*p)->value = value;
-
-            return true;
-        }
-    }
-
-    DictionaryEntry entry = malloc(sizeof * entry);
-
-    if (!entry)
-    {
-        return false;
-    }
-
-    if (!instance->buckets[hash].firstEntry)
-    {
-        DictionaryBucket first = instance->firstBucket;
-
-        instance->buckets[hash].nextBucket = first;
-        instance->firstBucket = instance->buckets + hash;
-    }
-
-    string_copy(&entry->key, key);
-
-    entry->value = value;
-    entry->nextEntry = NULL;
-    *p = entry;
-
-    return true;
+    hash_table(
+        instance,
+        sizeof(struct String),
+        valueSize,
+        string_table_hash,
+        string_table_equals);
 }
 
-bool dictionary_all(Dictionary instance)
+void conjunction(Conjunction instance)
 {
-    for (DictionaryBucket bucket = instance->firstBucket;
-        bucket;
-        bucket = bucket->nextBucket)
-    {
-        for (DictionaryEntry entry = bucket->firstEntry;
-            entry;
-            entry = entry->nextEntry)
-        {
-            if (!entry->value)
-            {
-                return false;
-            }
-        }
-    }
+    string_table(&instance->pulses, sizeof(bool));
 
-    return true;
+    instance->high = 0;
 }
 
-void dictionary_clear(Dictionary instance)
+bool conjunction_set(Conjunction instance, String key, bool value)
 {
-    for (DictionaryBucket bucket = instance->firstBucket;
-        bucket;
-        bucket = bucket->nextBucket)
-    {
-        DictionaryEntry entry = bucket->firstEntry;
-
-        while (entry)
-        {
-            DictionaryEntry nextEntry = entry->nextEntry;
-
-            free(entry);
-
-            entry = nextEntry;
-        }
+    bool* existing = hash_table_add(&instance->pulses, key, NULL);
 
-        bucket->firstEntry = NULL;
+    if (!existing)
+    {
+        return false;
     }
 
-    instance->firstBucket = NULL;
-}
+    instance->high += value - *existing;
+    *existing = value;
 
-void message_queue(MessageQueue instance)
-{
-    instance->first = -1;
-    instance->last = -1;
+    return true;
 }
 
-Message message_queue_enqueue(MessageQueue instance)
+bool conjunction_all(Conjunction instance)
 {
-    if (instance->first == -1)
-    {
-        instance->first = 0;
-        instance->last = 0;
-    }
-    else if (instance->first && instance->last == MESSAGE_QUEUE_CAPACITY - 1)
-    {
-        instance->last = 0;
-    }
-    else
-    {
-        instance->last++;
-    }
-
-    return instance->items + instance->last;
+    return (size_t)instance->high == instance->pulses.count;
 }
 
-bool message_queue_try_dequeue(MessageQueue instance, Message result)
+void module(Module instance, bool isConjunction, String name)
 {
-    if (instance->first == -1)
-    {
-        return false;
-    }
-
-    *result = instance->items[instance->first];
+    instance->isConjunction = isConjunction;
+    instance->targetCount = 0;
+    instance->targetCapacity = 0;
+    instance->targets = NULL;
 
-    if (instance->first == instance->last)
-    {
-        instance->first = -1;
-        instance->last = -1;
-    }
-    else if (instance->first == MESSAGE_QUEUE_CAPACITY - 1)
+    if (isConjunction)
     {
-        instance->first = 0;
+        conjunction(&instance->child.conjunction);
     }
     else
     {
-        instance->first++;
+        instance->child.pulse = false;
     }
 
-    return true;
+    string_copy(&instance->name, name);
 }
 
-bool module(Module instance, bool isConjunction, ZString name)
+String module_new_target(Module instance)
 {
-    instance->isConjunction = isConjunction;
-    instance->nextModule = NULL;
-    instance->targetCount = 0;
-
-    if (isConjunction)
+    if (instance->targetCount == instance->targetCapacity)
     {
-        instance->child.pulses = malloc(sizeof * instance->child.pulses);
+        int newCapacity = instance->targetCapacity * 2;
 
-        if (!instance->child.pulses)
+        if (!newCapacity)
         {
-            return false;
+            newCapacity = MODULE_INITIAL_CAPACITY;
         }
 
-        dictionary(instance->child.pulses);
-    }
-    else
-    {
-        instance->child.pulse = false;
-    }
+        String newTargets = realloc(
+            instance->targets,
+            newCapacity * sizeof * newTargets);
 
-    string(&instance->name, name);
+        if (!newTargets)
+        {
+            return NULL;
+        }
 
-    return true;
-}
+        instance->targets = newTargets;
+        instance->targetCapacity = newCapacity;
+    }
 
-String module_new_target(Module instance)
-{
     String result = instance->targets + instance->targetCount;
 
     instance->targetCount++;
@@ -329,156 +188,176 @@ String module_new_target(Module instance)
     return result;
 }
 
-void module_send(Module module, MessageQueue queue, bool pulse)
+bool module_send(Module module, Queue queue, bool pulse)
 {
     for (int i = 0; i < module->targetCount; i++)
     {
-        Message message = message_queue_enqueue(queue);
+        Message message = queue_enqueue(queue);
+
+        if (!message)
+        {
+            return false;
+        }
 
         message->pulse = pulse;
 
         string_copy(&message->source, &module->name);
         string_copy(&message->target, module->targets + i);
     }
+
+    return true;
 }
 
-bool module_respond(Module instance, Message message, MessageQueue queue)
+bool module_respond(Module instance, Message message, Queue queue)
 {
     if (instance->isConjunction)
     {
-        if (!dictionary_set(
-            instance->child.pulses,
+        if (!conjunction_set(
+            &instance->child.conjunction,
             &message->source,
             message->pulse))
         {
-            fprintf(stderr, EXCEPTION_OUT_OF_MEMORY);
-
             return false;
         }
 
-        module_send(instance, queue, !dictionary_all(instance->child.pulses));
+        return module_send(
+            instance,
+            queue,
+            !conjunction_all(&instance->child.conjunction));
     }
-    else
-    {
-        if (message->pulse)
-        {
-            return true;
-        }
 
-        instance->child.pulse = !instance->child.pulse;
-
-        module_send(instance, queue, instance->child.pulse);
+    if (message->pulse)
+    {
+        return true;
     }
 
-    return true;
+    instance->child.pulse = !instance->child.pulse;
+
+    return module_send(instance, queue, instance->child.pulse);
 }
 
 void finalize_module(Module instance)
 {
+    free(instance->targets);
+
     if (instance->isConjunction)
     {
-        dictionary_clear(instance->child.pulses);
-        free(instance->child.pulses);
+        finalize_hash_table(&instance->child.conjunction.pulses);
     }
 }
 
-Module module_collection_get(ModuleCollection instance, String name)
+Module module_collection_get(HashTable instance, String name)
 {
-    unsigned int hash = string_get_hash_code(name) % MODULE_COLLECTION_BUCKETS;
-
-    for (Module module = instance->buckets[hash].firstModule;
-        module;
-        module = module->nextModule)
-    {
-        if (string_equals(name, &module->name))
-        {
-            return module;
-        }
-    }
-
-    return NULL;
+    return hash_table_get(instance, name);
 }
 
-void module_collection_add(ModuleCollection instance, Module item)
+void finalize_module_collection(HashTable instance)
 {
-    unsigned int hash = string_get_hash_code(&item->name) %
-        MODULE_COLLECTION_BUCKETS;
+    struct HashTableIterator iterator;
 
-    if (!instance->buckets[hash].firstModule)
-    {
-        ModuleCollectionBucket first = instance->firstBucket;
+    hash_table_begin(instance, &iterator);
 
-        instance->buckets[hash].nextBucket = first;
-        instance->firstBucket = instance->buckets + hash;
+    while (hash_table_next(instance, &iterator))
+    {
+        finalize_module(iterator.value);
     }
 
-    item->nextModule = instance->buckets[hash].firstModule;
-    instance->buckets[hash].firstModule = item;
+    finalize_hash_table(instance);
 }
 
-int main(void)
+Exception solve(const char* input, size_t length, long long* result)
 {
-    clock_t start = clock();
-    char buffer[BUFFER_SIZE];
-    struct ModuleCollection modules = { 0 };
+    struct HashTable modules;
+    struct Stream reader;
+    struct StringView line;
+
+    stream(&reader, input, length);
+    string_table(&modules, sizeof(struct Module));
 
-    while (fgets(buffer, sizeof buffer, stdin))
+    while (stream_next_line(&reader, &line))
     {
-        char* mid = strstr(buffer, " -> ");
+        const char* mid = memchr(line.begin, '>', line.end - line.begin);
 
-        if (!mid)
+        if (!mid || mid - line.begin < 3 || memcmp(mid - 2, " -> ", 4) != 0)
         {
-            fprintf(stderr, "Error: Format.\n");
+            finalize_module_collection(&modules);
 
-            return 1;
+            return EXCEPTION_FORMAT;
         }
 
-        *mid = '\0';
+        struct StringView name =
+        {
+            .begin = line.begin + 1,
+            .end = mid - 2
+        };
+        bool added;
+        struct String key;
+        struct StringView token;
+
+        string(&key, &name);
 
-        Module next = malloc(sizeof * next);
+        Module next = hash_table_add(&modules, &key, &added);
 
-        if (!next || !module(next, buffer[0] != '%', buffer + 1))
+        if (!next)
         {
-            fprintf(stderr, EXCEPTION_OUT_OF_MEMORY);
+            finalize_module_collection(&modules);
 
-            return 1;
+            return EXCEPTION_OUT_OF_MEMORY;
         }
 
-        module_collection_add(&modules, next);
+        if (!added)
+        {
+            finalize_module_collection(&modules);
+
+            return EXCEPTION_FORMAT;
+        }
+
+        module(next, line.begin[0] != '%', &key);
+
+        line.begin = mid + 1;
 
-        for (ZString token = strtok(mid + 4, DELIMITERS);
-            token;
-            token = strtok(NULL, DELIMITERS))
+        while (string_view_next_token(&line, DELIMITERS, &token))
         {
-            string(module_new_target(next), token);
+            String target = module_new_target(next);
+
+            if (!target)
+            {
+                finalize_module_collection(&modules);
+
+                return EXCEPTION_OUT_OF_MEMORY;
+            }
+
+            string(target, &token);
         }
     }
 
-    for (ModuleCollectionBucket bucket = modules.firstBucket;
-        bucket;
-        bucket = bucket->nextBucket)
+    struct HashTableIterator iterator;
+
+    hash_table_begin(&modules, &iterator);
+
+    while (hash_table_next(&modules, &iterator))
     {
-        for (Module module = bucket->firstModule;
-            module;
-            module = module->nextModule)
+        Module module = iterator.value;
+
+        for (int i = 0; i < module->targetCount; i++)
         {
-            for (int i = 0; i < module->targetCount; i++)
-            {
-                Module target = module_collection_get(
-                    &modules,
-                    module->targets + i);
+            Module target = module_collection_get(
+                &modules,
+                module->targets + i);
 
-                if (!target || !target->isConjunction)
-                {
-                    continue;
-                }
+            if (!target || !target->isConjunction)
+            {
+                continue;
+            }
 
-                if (!dictionary_set(target->child.pulses, &module->name, false))
-                {
-                    fprintf(stderr, EXCEPTION_OUT_OF_MEMORY);
+            if (!conjunction_set(
+                &target->child.conjunction,
+                &module->name,
+                false))
+            {
+                finalize_module_collection(&modules);
 
-                    return 1;
-                }
+                return EXCEPTION_OUT_OF_MEMORY;
             }
         }
     }
@@ -486,15 +365,15 @@ int main(void)
     struct String broadcasterKey =
     {
         .length = 10,
-        .buffer = { 'r', 'o', 'a', 'd', 'c', 'a', 's', 't', 'e', 'r' }
+        .buffer = "roadcaster"
     };
     Module broadcaster = module_collection_get(&modules, &broadcasterKey);
 
     if (!broadcaster)
     {
-        fprintf(stderr, "Error: Key not found.\n");
+        finalize_module_collection(&modules);
 
-        return 1;
+        return EXCEPTION_KEY_NOT_FOUND;
     }
 
     int counts[2] =
@@ -503,16 +382,27 @@ int main(void)
         [false] = 1000
     };
 
+    struct Queue pending;
+
+    queue(&pending, sizeof(struct Message));
+
     for (int i = 0; i < 1000; i++)
     {
+        Message next;
         struct Message current;
-        struct MessageQueue queue;
 
-        message_queue(&queue);
-        module_send(broadcaster, &queue, false);
+        if (!module_send(broadcaster, &pending, false))
+        {
+            finalize_queue(&pending);
+            finalize_module_collection(&modules);
 
-        while (message_queue_try_dequeue(&queue, &current))
+            return EXCEPTION_OUT_OF_MEMORY;
+        }
+
+        while ((next = queue_dequeue(&pending)))
         {
+            current = *next;
+
             counts[current.pulse]++;
 
             Module target = module_collection_get(&modules, &current.target);
@@ -522,35 +412,25 @@ int main(void)
                 continue;
             }
 
-            if (!module_respond(target, &current, &queue))
+            if (!module_respond(target, &current, &pending))
             {
-                fprintf(stderr, EXCEPTION_OUT_OF_MEMORY);
+                finalize_queue(&pending);
+                finalize_module_collection(&modules);
 
-                return 1;
+                return EXCEPTION_OUT_OF_MEMORY;
             }
         }
     }
 
-    long result = counts[true] * counts[false];
+    *result = counts[true] * counts[false];
 
-    printf("20a %ld %lf\n", result, (double)(clock() - start) / CLOCKS_PER_SEC);
+    finalize_queue(&pending);
+    finalize_module_collection(&modules);
 
-    for (ModuleCollectionBucket bucket = modules.firstBucket;
-        bucket;
-        bucket = bucket->nextBucket)
-    {
-        Module module = bucket->firstModule;
-
-        while (module)
-        {
-            Module next = module->nextModule;
-
-            finalize_module(module);
-            free(module);
-
-            module = next;
-        }
-    }
+    return EXCEPTION_NONE;
+}
 
-    return 0;
+int main(void)
+{
+    return solver_main("20a", solve);
 }
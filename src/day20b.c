@@ -3,51 +3,20 @@
 // Pulse Propagation Part 2
 
 #include <stdbool.h>
-#include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
-#include <time.h>
-#define BUFFER_SIZE 32
-#define DICTIONARY_BUCKETS 53
+#include "../lib/solver.h"
+#include "../lib/stream.h"
+#include "../lib/hash_table.h"
+#include "../lib/queue.h"
+#include "../lib/trace.h"
 #define DELIMITERS ", \n"
-#define EXCEPTION_FORMAT "Error: Format.\n"
-#define EXCEPTION_OUT_OF_MEMORY "Error: Out of memory.\n"
-#define MESSAGE_QUEUE_CAPACITY 64
-#define MODULE_COLLECTION_BUCKETS 97
-#define MODULE_TARGETS_CAPACITY 8
-#define SET_BUCKETS 53
-#define STRING_CAPACITY 16
-
-enum AddResult
-{
-    ADD_RESULT_ADDED,
-    ADD_RESULT_NOT_ADDED,
-    ADD_RESULT_OUT_OF_MEMORY
-};
+#define MODULE_INITIAL_CAPACITY 8
 
 struct String
 {
     int length;
-    char buffer[STRING_CAPACITY];
-};
-
-struct DictionaryEntry
-{
-    struct DictionaryEntry* nextEntry;
-    struct String key;
-    bool value;
-};
-
-struct DictionaryBucket
-{
-    struct DictionaryEntry* firstEntry;
-    struct DictionaryBucket* nextBucket;
-};
-
-struct Dictionary
-{
-    struct DictionaryBucket* firstBucket;
-    struct DictionaryBucket buckets[DICTIONARY_BUCKETS];
+    const char* buffer;
 };
 
 struct Message
@@ -57,74 +26,33 @@ struct Message
     bool pulse;
 };
 
-struct MessageQueue
+struct Conjunction
 {
-    int first;
-    int last;
-    struct Message items[MESSAGE_QUEUE_CAPACITY];
+    struct HashTable pulses;
+    int high;
 };
 
 union ModuleType
 {
     bool pulse;
-    struct Dictionary* pulses;
+    struct Conjunction conjunction;
 };
 
 struct Module
 {
-    struct Module* nextModule;
     union ModuleType child;
     int targetCount;
+    int targetCapacity;
     struct String name;
-    struct String targets[MODULE_TARGETS_CAPACITY];
+    struct String* targets;
     bool isConjunction;
 };
 
-struct ModuleCollectionBucket
-{
-    struct Module* firstModule;
-    struct ModuleCollectionBucket* nextBucket;
-};
-
-struct ModuleCollection
-{
-    struct ModuleCollectionBucket* firstBucket;
-    struct ModuleCollectionBucket buckets[MODULE_COLLECTION_BUCKETS];
-};
-
-struct SetEntry
-{
-    struct SetEntry* nextEntry;
-    struct String item;
-};
-
-struct SetBucket
-{
-    struct SetEntry* firstEntry;
-    struct SetBucket* nextBucket;
-};
-
-struct Set
-{
-    struct SetBucket* firstBucket;
-    struct SetBucket buckets[DICTIONARY_BUCKETS];
-    int count;
-};
-
-typedef char* ZString;
-typedef enum AddResult AddResult;
 typedef struct String* String;
-typedef struct DictionaryEntry* DictionaryEntry;
-typedef struct DictionaryBucket* DictionaryBucket;
-typedef struct Dictionary* Dictionary;
+typedef const void* Object;
+typedef struct Conjunction* Conjunction;
 typedef struct Message* Message;
-typedef struct MessageQueue* MessageQueue;
 typedef struct Module* Module;
-typedef struct ModuleCollectionBucket* ModuleCollectionBucket;
-typedef struct ModuleCollection* ModuleCollection;
-typedef struct SetEntry* SetEntry;
-typedef struct SetBucket* SetBucket;
-typedef struct Set* Set;
 
 long long math_gcd(long long a, long long b)
 {
@@ -144,21 +72,19 @@ long long math_lcm(long long a, long long b)
     return (a / math_gcd(a, b)) * b;
 }
 
-void string(String instance, ZString buffer)
+void string(String instance, StringView value)
 {
-    instance->length = strlen(buffer);
-
-    memcpy(instance->buffer, buffer, instance->length);
+    instance->length = value->end - value->begin;
+    instance->buffer = value->begin;
 }
 
 void string_copy(String destination, String source)
 {
     destination->length = source->length;
-
-    memcpy(destination->buffer, source->buffer, source->length);
+    destination->buffer = source->buffer;
 }
 
-bool string_equals(String instance, String other)
+bool string_equals(const struct String* instance, const struct String* other)
 {
     if (instance->length != other->length)
     {
@@ -168,7 +94,7 @@ bool string_equals(String instance, String other)
     return memcmp(instance->buffer, other->buffer, instance->length) == 0;
 }
 
-unsigned int string_get_hash_code(String instance)
+unsigned int string_get_hash_code(const struct String* instance)
 {
     unsigned int hash = 0;
 
@@ -180,198 +106,100 @@ unsigned int string_get_hash_code(String instance)
     return hash;
 }
 
-void dictionary(Dictionary instance)
+static unsigned int string_table_hash(Object key, size_t size)
 {
-    instance->firstBucket = NULL;
+    (void)size;
 
-    for (int i = 0; i < DICTIONARY_BUCKETS; i++)
-    {
-        instance->buckets[i].firstEntry = NULL;
-        instance->buckets[i].nextBucket = NULL;
-    }
+    return string_get_hash_code(key);
 }
 
-bool dictionary_try_get_value(Dictionary instance, String key, bool* result)
+static bool string_table_equals(Object left, Object right, size_t size)
 {
-    unsigned int hash = string_get_hash_code(key) % DICTIONARY_BUCKETS;
-
-    for (DictionaryEntry entry = instance->buckets[hash].firstEntry;
-        entry;
-        entry = entry->nextEntry)
-    {
-        if (string_equals(key, &entry->key))
-        {
-            *result = entry->value;
-
-            return true;
-        }
-    }
+    (void)size;
 
-    return false;
+    return string_equals(left, right);
 }
 
-bool dictionary_set(Dictionary instance, String key, int value)
+void string_table(HashTable instance, size_t valueSize)
 {
-    DictionaryEntry* p;
-    unsigned int hash = string_get_hash_code(key) % DICTIONARY_BUCKETS;
-
-    for (p = &instance->buckets[hash].firstEntry; *p; p = &(*p)->nextEntry)
-    {
-        if (string_equals(key, &(*p)->key))
-        {
-            (*p)->value = value;
-
-            return true;
-        }
-    }
-
-    DictionaryEntry entry = malloc(sizeof * entry);
-
-    if (!entry)
-    {
-        return false;
-    }
-
-    if (!instance->buckets[hash].firstEntry)
-    {
-        DictionaryBucket first = instance->firstBucket;
-
-        instance->buckets[hash].nextBucket = first;
-        instance->firstBucket = instance->buckets + hash;
-    }
-
-    string_copy(&entry->key, key);
-
-    entry->value = value;
-    entry->nextEntry = NULL;
-    *p = entry;
-
-    return true;
+    hash_table(
+        instance,
+        sizeof(struct String),
+        valueSize,
+        string_table_hash,
+        string_table_equals);
 }
 
-bool dictionary_all(Dictionary instance)
+void conjunction(Conjunction instance)
 {
-    for (DictionaryBucket bucket = instance->firstBucket;
-        bucket;
-        bucket = bucket->nextBucket)
-    {
-        for (DictionaryEntry entry = bucket->firstEntry;
-            entry;
-            entry = entry->nextEntry)
-        {
-            if (!entry->value)
-            {
-                return false;
-            }
-        }
-    }
+    string_table(&instance->pulses, sizeof(bool));
 
-    return true;
+    instance->high = 0;
 }
 
-void dictionary_clear(Dictionary instance)
+bool conjunction_set(Conjunction instance, String key, bool value)
 {
-    for (DictionaryBucket bucket = instance->firstBucket;
-        bucket;
-        bucket = bucket->nextBucket)
-    {
-        DictionaryEntry entry = bucket->firstEntry;
-
-        while (entry)
-        {
-            DictionaryEntry nextEntry = entry->nextEntry;
-
-            free(entry);
-
-            entry = nextEntry;
-        }
+    bool* existing = hash_table_add(&instance->pulses, key, NULL);
 
-        bucket->firstEntry = NULL;
+    if (!existing)
+    {
+        return false;
     }
 
-    instance->firstBucket = NULL;
-}
+    instance->high += value - *existing;
+    *existing = value;
 
-void message_queue(MessageQueue instance)
-{
-    instance->first = -1;
-    instance->last = -1;
+    return true;
 }
 
-Message message_queue_enqueue(MessageQueue instance)
+bool conjunction_all(Conjunction instance)
 {
-    if (instance->first == -1)
-    {
-        instance->first = 0;
-        instance->last = 0;
-    }
-    else if (instance->first && instance->last == MESSAGE_QUEUE_CAPACITY - 1)
-    {
-        instance->last = 0;
-    }
-    else
-    {
-        instance->last++;
-    }
-
-    return instance->items + instance->last;
+    return (size_t)instance->high == instance->pulses.count;
 }
 
-bool message_queue_try_dequeue(MessageQueue instance, Message result)
+void module(Module instance, bool isConjunction, String name)
 {
-    if (instance->first == -1)
-    {
-        return false;
-    }
-
-    *result = instance->items[instance->first];
+    instance->isConjunction = isConjunction;
+    instance->targetCount = 0;
+    instance->targetCapacity = 0;
+    instance->targets = NULL;
 
-    if (instance->first == instance->last)
-    {
-        instance->first = -1;
-        instance->last = -1;
-    }
-    else if (instance->first == MESSAGE_QUEUE_CAPACITY - 1)
+    if (isConjunction)
     {
-        instance->first = 0;
+        conjunction(&instance->child.conjunction);
     }
     else
     {
-        instance->first++;
+        instance->child.pulse = false;
     }
 
-    return true;
+    string_copy(&instance->name, name);
 }
 
-bool module(Module instance, bool isConjunction, ZString name)
+String module_new_target(Module instance)
 {
-    instance->isConjunction = isConjunction;
-    instance->nextModule = NULL;
-    instance->targetCount = 0;
-
-    if (isConjunction)
+    if (instance->targetCount == instance->targetCapacity)
     {
-        instance->child.pulses = malloc(sizeof * instance->child.pulses);
+        int newCapacity = instance->targetCapacity * 2;
 
-        if (!instance->child.pulses)
+        if (!newCapacity)
         {
-            return false;
+            newCapacity = MODULE_INITIAL_CAPACITY;
         }
 
-        dictionary(instance->child.pulses);
-    }
-    else
-    {
-        instance->child.pulse = false;
-    }
+        String newTargets = realloc(
+            instance->targets,
+            newCapacity * sizeof * newTargets);
 
-    string(&instance->name, name);
+        if (!newTargets)
+        {
+            return NULL;
+        }
 
-    return true;
-}
+        instance->targets = newTargets;
+        instance->targetCapacity = newCapacity;
+    }
 
-String module_new_target(Module instance)
-{
     String result = instance->targets + instance->targetCount;
 
     instance->targetCount++;
@@ -379,157 +207,86 @@ String module_new_target(Module instance)
     return result;
 }
 
-void module_send(Module module, MessageQueue queue, bool pulse)
+bool module_send(Module module, Queue queue, bool pulse)
 {
     for (int i = 0; i < module->targetCount; i++)
     {
-        Message message = message_queue_enqueue(queue);
+        Message message = queue_enqueue(queue);
+
+        if (!message)
+        {
+            return false;
+        }
 
         message->pulse = pulse;
 
         string_copy(&message->source, &module->name);
         string_copy(&message->target, module->targets + i);
     }
+
+    return true;
 }
 
-bool module_respond(Module instance, Message message, MessageQueue queue)
+bool module_respond(Module instance, Message message, Queue queue)
 {
     if (instance->isConjunction)
     {
-        if (!dictionary_set(
-            instance->child.pulses,
+        if (!conjunction_set(
+            &instance->child.conjunction,
             &message->source,
             message->pulse))
         {
-            fprintf(stderr, EXCEPTION_OUT_OF_MEMORY);
-
             return false;
         }
 
-        module_send(instance, queue, !dictionary_all(instance->child.pulses));
+        return module_send(
+            instance,
+            queue,
+            !conjunction_all(&instance->child.conjunction));
     }
-    else
-    {
-        if (message->pulse)
-        {
-            return true;
-        }
-
-        instance->child.pulse = !instance->child.pulse;
 
-        module_send(instance, queue, instance->child.pulse);
-    }
-
-    return true;
-}
-
-Module module_collection_get(ModuleCollection instance, String name)
-{
-    unsigned int hash = string_get_hash_code(name) % MODULE_COLLECTION_BUCKETS;
-
-    for (Module module = instance->buckets[hash].firstModule;
-        module;
-        module = module->nextModule)
+    if (message->pulse)
     {
-        if (string_equals(name, &module->name))
-        {
-            return module;
-        }
+        return true;
     }
 
-    return NULL;
+    instance->child.pulse = !instance->child.pulse;
+
+    return module_send(instance, queue, instance->child.pulse);
 }
 
 void finalize_module(Module instance)
 {
+    free(instance->targets);
+
     if (instance->isConjunction)
     {
-        dictionary_clear(instance->child.pulses);
-        free(instance->child.pulses);
+        finalize_hash_table(&instance->child.conjunction.pulses);
     }
 }
 
-void module_collection_add(ModuleCollection instance, Module item)
+Module module_collection_get(HashTable instance, String name)
 {
-    unsigned int hash = string_get_hash_code(&item->name) %
-        MODULE_COLLECTION_BUCKETS;
-
-    if (!instance->buckets[hash].firstModule)
-    {
-        ModuleCollectionBucket first = instance->firstBucket;
-
-        instance->buckets[hash].nextBucket = first;
-        instance->firstBucket = instance->buckets + hash;
-    }
-
-    item->nextModule = instance->buckets[hash].firstModule;
-    instance->buckets[hash].firstModule = item;
+    return hash_table_get(instance, name);
 }
 
-AddResult set_add(Set instance, String item)
+void finalize_module_collection(HashTable instance)
 {
-    SetEntry* p;
-    unsigned int hash = string_get_hash_code(item) % SET_BUCKETS;
-
-    for (p = &instance->buckets[hash].firstEntry; *p; p = &(*p)->nextEntry)
-    {
-        if (string_equals(item, &(*p)->item))
-        {
-            return ADD_RESULT_NOT_ADDED;
-        }
-    }
+    struct HashTableIterator iterator;
 
-    SetEntry entry = malloc(sizeof * entry);
+    hash_table_begin(instance, &iterator);
 
-    if (!entry)
+    while (hash_table_next(instance, &iterator))
     {
-        return ADD_RESULT_OUT_OF_MEMORY;
+        finalize_module(iterator.value);
     }
 
-    if (!instance->buckets[hash].firstEntry)
-    {
-        SetBucket first = instance->firstBucket;
-
-        instance->buckets[hash].nextBucket = first;
-        instance->firstBucket = instance->buckets + hash;
-    }
-
-    string_copy(&entry->item, item);
-
-    entry->nextEntry = NULL;
-    *p = entry;
-    instance->count++;
-
-    return ADD_RESULT_ADDED;
-}
-
-void set_clear(Set instance)
-{
-    for (SetBucket bucket = instance->firstBucket;
-        bucket;
-        bucket = bucket->nextBucket)
-    {
-        SetEntry entry = bucket->firstEntry;
-
-        while (entry)
-        {
-            SetEntry nextEntry = entry->nextEntry;
-
-            free(entry);
-
-            entry = nextEntry;
-        }
-
-        bucket->firstEntry = NULL;
-    }
-
-    instance->firstBucket = NULL;
-    instance->count = 0;
+    finalize_hash_table(instance);
 }
 
 static bool scan(
-    ModuleCollection modules,
-    Set visited,
+    HashTable modules,
+    HashTable visited,
     Module broadcaster,
     Module sender,
     long long* result)
@@ -537,19 +294,33 @@ static bool scan(
     *result = 1;
 
     int iterations = 0;
+    long long messages = 0;
+
+    struct Queue pending;
+
+    queue(&pending, sizeof(struct Message));
 
     while (visited->count < 4)
     {
         iterations++;
 
+        Message next;
         struct Message current;
-        struct MessageQueue queue;
 
-        message_queue(&queue);
-        module_send(broadcaster, &queue, false);
+        trace_begin("press");
 
-        while (message_queue_try_dequeue(&queue, &current))
+        if (!module_send(broadcaster, &pending, false))
         {
+            finalize_queue(&pending);
+
+            return false;
+        }
+
+        while ((next = queue_dequeue(&pending)))
+        {
+            current = *next;
+            messages++;
+
             Module target = module_collection_get(modules, &current.target);
 
             if (!target)
@@ -559,109 +330,152 @@ static bool scan(
 
             if (target == sender && current.pulse)
             {
-                AddResult status = set_add(visited, &current.source);
-
-                if (status == ADD_RESULT_OUT_OF_MEMORY)
+                if (!hash_table_add(visited, &current.source, NULL))
                 {
+                    finalize_queue(&pending);
+
                     return false;
                 }
 
                 *result = math_lcm(*result, iterations);
             }
 
-            if (!module_respond(target, &current, &queue))
+            if (!module_respond(target, &current, &pending))
             {
+                finalize_queue(&pending);
+
                 return false;
             }
         }
+
+        trace_end("press");
     }
 
+    solver_work("presses", iterations);
+    solver_work("messages", messages);
+    finalize_queue(&pending);
+
     return true;
 }
 
-int main(void)
+Exception solve(const char* input, size_t length, long long* result)
 {
-    clock_t start = clock();
-    char buffer[BUFFER_SIZE];
-    struct ModuleCollection modules = { 0 };
+    struct HashTable modules;
     struct String receiver =
     {
         .length = 2,
-        .buffer = { 'r', 'x' }
+        .buffer = "rx"
     };
-    Module sender = NULL;
+    struct String senderName = { 0 };
+    struct Stream reader;
+    struct StringView line;
 
-    while (fgets(buffer, sizeof buffer, stdin))
+    stream(&reader, input, length);
+    string_table(&modules, sizeof(struct Module));
+
+    while (stream_next_line(&reader, &line))
     {
-        char* mid = strstr(buffer, " -> ");
+        const char* mid = memchr(line.begin, '>', line.end - line.begin);
 
-        if (!mid)
+        if (!mid || mid - line.begin < 3 || memcmp(mid - 2, " -> ", 4) != 0)
         {
-            fprintf(stderr, EXCEPTION_FORMAT);
+            finalize_module_collection(&modules);
 
-            return 1;
+            return EXCEPTION_FORMAT;
         }
 
-        *mid = '\0';
+        struct StringView name =
+        {
+            .begin = line.begin + 1,
+            .end = mid - 2
+        };
+        bool added;
+        struct String key;
+        struct StringView token;
+
+        string(&key, &name);
+
+        Module next = hash_table_add(&modules, &key, &added);
 
-        Module next = malloc(sizeof * next);
+        if (!next)
+        {
+            finalize_module_collection(&modules);
+
+            return EXCEPTION_OUT_OF_MEMORY;
+        }
 
-        if (!next || !module(next, buffer[0] != '%', buffer + 1))
+        if (!added)
         {
-            fprintf(stderr, EXCEPTION_OUT_OF_MEMORY);
+            finalize_module_collection(&modules);
 
-            return 1;
+            return EXCEPTION_FORMAT;
         }
 
-        module_collection_add(&modules, next);
+        module(next, line.begin[0] != '%', &key);
 
-        for (ZString token = strtok(mid + 4, DELIMITERS);
-            token;
-            token = strtok(NULL, DELIMITERS))
+        line.begin = mid + 1;
+
+        while (string_view_next_token(&line, DELIMITERS, &token))
         {
             String target = module_new_target(next);
 
-            string(target, token);
+            if (!target)
+            {
+                finalize_module_collection(&modules);
+
+                return EXCEPTION_OUT_OF_MEMORY;
+            }
+
+            string(target, &token);
 
             if (string_equals(target, &receiver))
             {
-                sender = next;
+                string_copy(&senderName, &key);
             }
         }
     }
 
+    Module sender = NULL;
+
+    if (senderName.buffer)
+    {
+        sender = module_collection_get(&modules, &senderName);
+    }
+
     if (!sender)
     {
-        fprintf(stderr, EXCEPTION_FORMAT);
+        finalize_module_collection(&modules);
 
-        return 1;
+        return EXCEPTION_FORMAT;
     }
 
-    for (ModuleCollectionBucket bucket = modules.firstBucket;
-        bucket;
-        bucket = bucket->nextBucket)
+    struct HashTableIterator iterator;
+
+    hash_table_begin(&modules, &iterator);
+
+    while (hash_table_next(&modules, &iterator))
     {
-        for (Module module = bucket->firstModule;
-            module;
-            module = module->nextModule)
+        Module module = iterator.value;
+
+        for (int i = 0; i < module->targetCount; i++)
         {
-            for (int i = 0; i < module->targetCount; i++)
-            {
-                Module target = module_collection_get(
-                    &modules,
-                    module->targets + i);
+            Module target = module_collection_get(
+                &modules,
+                module->targets + i);
 
-                if (!target || !target->isConjunction)
-                {
-                    continue;
-                }
+            if (!target || !target->isConjunction)
+            {
+                continue;
+            }
 
-                if (!dictionary_set(target->child.pulses, &module->name, false))
-                {
-                    fprintf(stderr, EXCEPTION_OUT_OF_MEMORY);
+            if (!conjunction_set(
+                &target->child.conjunction,
+                &module->name,
+                false))
+            {
+                finalize_module_collection(&modules);
 
-                    return 1;
-                }
+                return EXCEPTION_OUT_OF_MEMORY;
             }
         }
     }
@@ -669,46 +483,39 @@ int main(void)
     struct String broadcasterKey =
     {
         .length = 10,
-        .buffer = { 'r', 'o', 'a', 'd', 'c', 'a', 's', 't', 'e', 'r' }
+        .buffer = "roadcaster"
     };
     Module broadcaster = module_collection_get(&modules, &broadcasterKey);
 
     if (!broadcaster)
     {
-        fprintf(stderr, "Error: Key not found.\n");
+        finalize_module_collection(&modules);
 
-        return 1;
+        return EXCEPTION_KEY_NOT_FOUND;
     }
 
-    struct Set visited = { 0 };
     long long lcm;
+    struct HashTable visited;
+
+    string_table(&visited, 0);
 
     if (!scan(&modules, &visited, broadcaster, sender, &lcm))
     {
-        fprintf(stderr, EXCEPTION_OUT_OF_MEMORY);
+        finalize_hash_table(&visited);
+        finalize_module_collection(&modules);
 
-        return 1;
+        return EXCEPTION_OUT_OF_MEMORY;
     }
 
-    printf("20b %lld %lf\n", lcm, (double)(clock() - start) / CLOCKS_PER_SEC);
-    set_clear(&visited);
+    *result = lcm;
 
-    for (ModuleCollectionBucket bucket = modules.firstBucket;
-        bucket;
-        bucket = bucket->nextBucket)
-    {
-        Module module = bucket->firstModule;
-
-        while (module)
-        {
-            Module next = module->nextModule;
+    finalize_hash_table(&visited);
+    finalize_module_collection(&modules);
 
-            finalize_module(module);
-            free(module);
-
-            module = next;
-        }
-    }
+    return EXCEPTION_NONE;
+}
 
-    return 0;
+int main(void)
+{
+    return solver_main("20b", solve);
 }
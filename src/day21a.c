@@ -3,22 +3,13 @@
 // Step Counter Part 1
 
 #include <stdbool.h>
-#include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
-#include <time.h>
-#define COORDINATE_SET_BUCKETS 24593
-#define DIMENSION 256
-#define EXCEPTION_FORMAT "Error: Format.\n"
-#define EXCEPTION_OUT_OF_MEMORY "Error: Out of memory.\n"
-#define STATE_QUEUE_CAPACITY 2048
-
-enum AddResult
-{
-    ADD_RESULT_ADDED,
-    ADD_RESULT_NOT_ADDED,
-    ADD_RESULT_OUT_OF_MEMORY
-};
+#include "../lib/solver.h"
+#include "../lib/stream.h"
+#include "../lib/hash_table.h"
+#include "../lib/queue.h"
+#include "../lib/workspace.h"
 
 struct Coordinate
 {
@@ -26,30 +17,13 @@ struct Coordinate
     int j;
 };
 
-struct CoordinateSetEntry
-{
-    struct CoordinateSetEntry* nextEntry;
-    struct Coordinate item;
-};
-
-struct CoordinateSetBucket
-{
-    struct CoordinateSetEntry* firstEntry;
-    struct CoordinateSetBucket* nextBucket;
-};
-
-struct CoordinateSet
-{
-    struct CoordinateSetBucket* firstBucket;
-    struct CoordinateSetBucket buckets[COORDINATE_SET_BUCKETS];
-};
-
 struct Matrix
 {
     struct Coordinate origin;
     int rows;
     int columns;
-    char items[DIMENSION * DIMENSION];
+    size_t capacity;
+    char* items;
 };
 
 struct State
@@ -58,99 +32,40 @@ struct State
     int priority;
 };
 
-struct StateQueue
-{
-    struct State items[STATE_QUEUE_CAPACITY];
-    int first;
-    int last;
-};
-
-typedef enum AddResult AddResult;
 typedef struct Coordinate* Coordinate;
-typedef struct CoordinateSetEntry* CoordinateSetEntry;
-typedef struct CoordinateSetBucket* CoordinateSetBucket;
-typedef struct CoordinateSet* CoordinateSet;
 typedef struct Matrix* Matrix;
 typedef struct State* State;
-typedef struct StateQueue* StateQueue;
 
-void coordinate_empty(Coordinate result)
-{
-    result->i = -1;
-    result->j = -1;
-}
+// The structures of a search, kept in a workspace between inputs.
 
-void coordinate_set(CoordinateSet instance)
+struct Search
 {
-    instance->firstBucket = NULL;
+    struct Matrix matrix;
+    struct HashTable visited;
+    struct Queue frontier;
+};
 
-    for (int i = 0; i < COORDINATE_SET_BUCKETS; i++)
-    {
-        instance->buckets[i].firstEntry = NULL;
-        instance->buckets[i].nextBucket = NULL;
-    }
-}
+typedef struct Search* Search;
 
-AddResult coordinate_set_add(CoordinateSet instance, Coordinate item)
+void coordinate_empty(Coordinate result)
 {
-    CoordinateSetEntry* p;
-    unsigned int hash = (item->i * DIMENSION + item->j) %
-        COORDINATE_SET_BUCKETS;
-
-    for (p = &instance->buckets[hash].firstEntry; *p; p = &(*p)->nextEntry)
-    {
-        if (item->i == (*p)->item.i && item->j == (*p)->item.j)
-        {
-            return ADD_RESULT_NOT_ADDED;
-        }
-    }
-
-    CoordinateSetEntry entry = malloc(sizeof * entry);
-
-    if (!entry)
-    {
-        return ADD_RESULT_OUT_OF_MEMORY;
-    }
-
-    if (!instance->buckets[hash].firstEntry)
-    {
-        CoordinateSetBucket first = instance->firstBucket;
-
-        instance->buckets[hash].nextBucket = first;
-        instance->firstBucket = instance->buckets + hash;
-    }
-
-    entry->item = *item;
-    entry->nextEntry = NULL;
-    *p = entry;
-
-    return ADD_RESULT_ADDED;
+    result->i = -1;
+    result->j = -1;
 }
 
-void coordinate_set_clear(CoordinateSet instance)
+void matrix(Matrix instance)
 {
-    for (CoordinateSetBucket bucket = instance->firstBucket;
-        bucket;
-        bucket = bucket->nextBucket)
-    {
-        CoordinateSetEntry entry = bucket->firstEntry;
-
-        while (entry)
-        {
-            CoordinateSetEntry nextEntry = entry->nextEntry;
-
-            free(entry);
-
-            entry = nextEntry;
-        }
-
-        bucket->firstEntry = NULL;
-    }
+    coordinate_empty(&instance->origin);
 
-    instance->firstBucket = NULL;
+    instance->rows = 0;
+    instance->columns = 0;
+    instance->capacity = 0;
+    instance->items = NULL;
 }
 
-void matrix(Matrix instance, int n)
+// Removes every row, keeping the storage, and sets the number of columns.
+
+void matrix_clear(Matrix instance, int n)
 {
     coordinate_empty(&instance->origin);
 
@@ -163,9 +78,37 @@ char matrix_get(Matrix instance, int i, int j)
     return instance->items[(instance->columns * i) + j];
 }
 
-void matrix_add_row(Matrix instance, char values[])
+bool matrix_add_row(Matrix instance, const char values[])
 {
     int m = instance->rows;
+    size_t count = (size_t)(m + 1) * instance->columns;
+
+    if (count > instance->capacity)
+    {
+        size_t newCapacity = instance->capacity * 2;
+
+        // The first rows are expected to form a square grid.
+
+        if (newCapacity < (size_t)instance->columns * instance->columns)
+        {
+            newCapacity = (size_t)instance->columns * instance->columns;
+        }
+
+        if (newCapacity < count)
+        {
+            newCapacity = count;
+        }
+
+        char* newItems = realloc(instance->items, newCapacity);
+
+        if (!newItems)
+        {
+            return false;
+        }
+
+        instance->items = newItems;
+        instance->capacity = newCapacity;
+    }
 
     instance->rows = m + 1;
 
@@ -173,204 +116,230 @@ void matrix_add_row(Matrix instance, char values[])
         instance->items + (instance->columns * m),
         values,
         instance->columns);
-}
 
-void state(State instance, Coordinate coordinate)
-{
-    instance->coordinate = *coordinate;
-    instance->priority = 0;
+    return true;
 }
 
-void state_queue(StateQueue instance)
+void finalize_matrix(Matrix instance)
 {
-    instance->first = -1;
-    instance->last = -1;
+    free(instance->items);
 }
 
-State state_queue_enqueue(StateQueue instance)
+static void search(void* instance)
 {
-    if (instance->first == -1)
-    {
-        instance->first = 0;
-        instance->last = 0;
-    }
-    else if (instance->first && instance->last == STATE_QUEUE_CAPACITY - 1)
-    {
-        instance->last = 0;
-    }
-    else
-    {
-        instance->last++;
-    }
+    Search search = instance;
 
-    return instance->items + instance->last;
+    matrix(&search->matrix);
+    hash_table(&search->visited, sizeof(struct Coordinate), 0, NULL, NULL);
+    queue(&search->frontier, sizeof(struct State));
 }
 
-bool state_queue_try_dequeue(StateQueue instance, State result)
+static void finalize_search(void* instance)
 {
-    if (instance->first == -1)
-    {
-        return false;
-    }
-
-    *result = instance->items[instance->first];
+    Search search = instance;
 
-    if (instance->first == instance->last)
-    {
-        instance->first = -1;
-        instance->last = -1;
-    }
-    else if (instance->first == STATE_QUEUE_CAPACITY - 1)
-    {
-        instance->first = 0;
-    }
-    else
-    {
-        instance->first++;
-    }
+    finalize_matrix(&search->matrix);
+    finalize_hash_table(&search->visited);
+    finalize_queue(&search->frontier);
+}
 
-    return true;
+void state(State instance, Coordinate coordinate)
+{
+    instance->coordinate = *coordinate;
+    instance->priority = 0;
 }
 
-static void scan_hi(Matrix matrix, State current, StateQueue queue)
+static bool scan_hi(Matrix matrix, State current, Queue queue)
 {
     int i = current->coordinate.i - 1;
 
     if (i < 0 || matrix_get(matrix, i, current->coordinate.j) == '#')
     {
-        return;
+        return true;
     }
 
-    State state = state_queue_enqueue(queue);
+    State state = queue_enqueue(queue);
+
+    if (!state)
+    {
+        return false;
+    }
 
     state->coordinate.i = i;
     state->coordinate.j = current->coordinate.j;
     state->priority = current->priority + 1;
+
+    return true;
 }
 
-static void scan_lo(Matrix matrix, State current, StateQueue queue)
+static bool scan_lo(Matrix matrix, State current, Queue queue)
 {
     int i = current->coordinate.i + 1;
 
     if (i >= matrix->rows || matrix_get(matrix, i, current->coordinate.j) == '#')
     {
-        return;
+        return true;
     }
 
-    State state = state_queue_enqueue(queue);
+    State state = queue_enqueue(queue);
+
+    if (!state)
+    {
+        return false;
+    }
 
     state->coordinate.i = i;
     state->coordinate.j = current->coordinate.j;
     state->priority = current->priority + 1;
+
+    return true;
 }
 
-static void scan_left(Matrix matrix, State current, StateQueue queue)
+static bool scan_left(Matrix matrix, State current, Queue queue)
 {
     int j = current->coordinate.j - 1;
 
     if (j < 0 || matrix_get(matrix, current->coordinate.i, j) == '#')
     {
-        return;
+        return true;
     }
 
-    State state = state_queue_enqueue(queue);
+    State state = queue_enqueue(queue);
+
+    if (!state)
+    {
+        return false;
+    }
 
     state->coordinate.i = current->coordinate.i;
     state->coordinate.j = j;
     state->priority = current->priority + 1;
+
+    return true;
 }
 
-static void scan_right(Matrix matrix, State current, StateQueue queue)
+static bool scan_right(Matrix matrix, State current, Queue queue)
 {
     int j = current->coordinate.j + 1;
 
     if (j >= matrix->columns ||
         matrix_get(matrix, current->coordinate.i, j) == '#')
     {
-        return;
+        return true;
     }
 
-    State state = state_queue_enqueue(queue);
+    State state = queue_enqueue(queue);
+
+    if (!state)
+    {
+        return false;
+    }
 
     state->coordinate.i = current->coordinate.i;
     state->coordinate.j = j;
     state->priority = current->priority + 1;
+
+    return true;
 }
 
-int main(void)
+Exception solve(const char* input, size_t length, long long* result)
 {
-    char buffer[DIMENSION + 2];
-    clock_t start = clock();
+    struct Stream reader;
+    struct StringView line;
 
-    if (!fgets(buffer, sizeof buffer, stdin))
-    {
-        fprintf(stderr, EXCEPTION_FORMAT);
+    stream(&reader, input, length);
 
-        return 1;
+    if (!stream_next_line(&reader, &line))
+    {
+        return EXCEPTION_FORMAT;
     }
 
-    int n = strlen(buffer) - 1;
+    int n = line.end - line.begin;
 
     if (n < 1)
     {
-        fprintf(stderr, EXCEPTION_FORMAT);
+        return EXCEPTION_FORMAT;
+    }
+
+    Search workspace = workspace_get(
+        "21a",
+        sizeof * workspace,
+        search,
+        finalize_search);
 
-        return 1;
+    if (!workspace)
+    {
+        return EXCEPTION_OUT_OF_MEMORY;
     }
 
-    struct Matrix a;
+    Matrix a = &workspace->matrix;
+    HashTable visited = &workspace->visited;
+    Queue frontier = &workspace->frontier;
 
-    matrix(&a, n);
+    matrix_clear(a, n);
+    hash_table_clear(visited);
+    queue_clear(frontier);
 
     do
     {
-        matrix_add_row(&a, buffer);
+        if (line.end - line.begin != n)
+        {
+            return EXCEPTION_FORMAT;
+        }
 
-        char* token = strchr(buffer, 'S');
+        if (!matrix_add_row(a, line.begin))
+        {
+            return EXCEPTION_OUT_OF_MEMORY;
+        }
+
+        const char* token = memchr(line.begin, 'S', n);
 
         if (token)
         {
-            a.origin.i = a.rows - 1;
-            a.origin.j = token - buffer;
+            a->origin.i = a->rows - 1;
+            a->origin.j = token - line.begin;
         }
     }
-    while (fgets(buffer, n + 2, stdin));
+    while (stream_next_line(&reader, &line));
 
-    if (a.origin.i < 0 || a.origin.j < 0)
+    if (a->origin.i < 0 || a->origin.j < 0)
     {
-        fprintf(stderr, EXCEPTION_FORMAT);
-
-        return 1;
+        return EXCEPTION_FORMAT;
     }
 
-    CoordinateSet visited = malloc(sizeof * visited);
+    int total = 0;
+    Exception exception = EXCEPTION_NONE;
+    State next;
+    struct State current;
+    State initial;
+
+    initial = queue_enqueue(frontier);
 
-    if (!visited)
+    if (!initial)
     {
-        fprintf(stderr, EXCEPTION_OUT_OF_MEMORY);
-
-        return 1;
+        exception = EXCEPTION_OUT_OF_MEMORY;
+    }
+    else
+    {
+        state(initial, &a->origin);
     }
 
-    int total = 0;
-    struct StateQueue queue;
-    struct State current;
+    while (!exception && (next = queue_dequeue(frontier)))
+    {
+        current = *next;
 
-    coordinate_set(visited);
-    state_queue(&queue);
-    state(state_queue_enqueue(&queue), &a.origin);
+        bool added;
 
-    while (state_queue_try_dequeue(&queue, &current))
-    {
-        switch (coordinate_set_add(visited, &current.coordinate))
+        if (!hash_table_add(visited, &current.coordinate, &added))
         {
-            case ADD_RESULT_ADDED: break;
-            case ADD_RESULT_NOT_ADDED: continue;
+            exception = EXCEPTION_OUT_OF_MEMORY;
 
-            case ADD_RESULT_OUT_OF_MEMORY:
-                fprintf(stderr, EXCEPTION_OUT_OF_MEMORY);
+            continue;
+        }
 
-                return 1;
+        if (!added)
+        {
+            continue;
         }
 
         if (current.priority % 2 == 0)
@@ -383,13 +352,26 @@ int main(void)
             continue;
         }
 
-        scan_hi(&a, &current, &queue);
-        scan_lo(&a, &current, &queue);
-        scan_left(&a, &current, &queue);
-        scan_right(&a, &current, &queue);
+        if (!scan_hi(a, &current, frontier) ||
+            !scan_lo(a, &current, frontier) ||
+            !scan_left(a, &current, frontier) ||
+            !scan_right(a, &current, frontier))
+        {
+            exception = EXCEPTION_OUT_OF_MEMORY;
+        }
     }
 
-    printf("21a %d %lf\n", total, (double)(clock() - start) / CLOCKS_PER_SEC);
-    coordinate_set_clear(visited);
-    free(visited);
+    if (exception)
+    {
+        return exception;
+    }
+
+    *result = total;
+
+    return EXCEPTION_NONE;
+}
+
+int main(void)
+{
+    return solver_main("21a", solve);
 }
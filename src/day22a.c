@@ -4,13 +4,15 @@
 
 #include <limits.h>
 #include <stdbool.h>
-#include <stdio.h>
 #include <stdlib.h>
-#include <time.h>
-#define BRICK_BUFFER_CAPACITY 2048
-#define BRICK_CHILDREN_CAPACITY 10
-#define BRICK_PARENTS_CAPACITY 10
-#define BUFFER_SIZE 32
+#include <string.h>
+#include "../lib/solver.h"
+#include "../lib/stream.h"
+#include "../lib/arena.h"
+#include "../lib/cache.h"
+#define ARENA_BLOCK_SIZE 65536
+#define BRICK_COLLECTION_INITIAL_CAPACITY 4
+#define CACHE_NAME "22"
 #define DELIMITERS ",~"
 
 struct Point
@@ -25,7 +27,9 @@ struct Brick;
 struct BrickCollection
 {
     struct Brick** items;
+    Arena arena;
     int count;
+    int capacity;
 };
 
 struct Brick
@@ -52,52 +56,70 @@ int math_min(int a, int b)
     return b;
 }
 
-void brick_collection(BrickCollection, Brick items[]);
+void brick_collection(BrickCollection instance, Arena arena);
 
-bool brick(Brick instance, Point p, Point q)
+void brick(Brick instance, Point p, Point q, Arena arena)
 {
-    Brick* parents = malloc(BRICK_PARENTS_CAPACITY * sizeof * parents);
-
-    if (!parents)
-    {
-        return false;
-    }
-
-    Brick* children = malloc(BRICK_CHILDREN_CAPACITY * sizeof * children);
-
-    if (!children)
-    {
-        free(parents);
-
-        return false;
-    }
-
     instance->p = *p;
     instance->q = *q;
     instance->floor = math_min(p->z, q->z);
 
-    brick_collection(&instance->parents, parents);
-    brick_collection(&instance->children, children);
-
-    return true;
+    brick_collection(&instance->parents, arena);
+    brick_collection(&instance->children, arena);
 }
 
-void finalize_brick(Brick instance)
-{
-    free(instance->parents.items);
-    free(instance->children.items);
-}
+// Initializes an empty collection. If `arena` is not NULL, the items are
+// allocated from it and released with the arena.
 
-void brick_collection(BrickCollection instance, Brick items[])
+void brick_collection(BrickCollection instance, Arena arena)
 {
+    instance->items = NULL;
+    instance->arena = arena;
     instance->count = 0;
-    instance->items = items;
+    instance->capacity = 0;
 }
 
-void brick_collection_add(BrickCollection instance, Brick item)
+bool brick_collection_add(BrickCollection instance, Brick item)
 {
+    if (instance->count == instance->capacity)
+    {
+        int newCapacity = instance->capacity * 2;
+
+        if (!newCapacity)
+        {
+            newCapacity = BRICK_COLLECTION_INITIAL_CAPACITY;
+        }
+
+        Brick* newItems;
+
+        if (instance->arena)
+        {
+            newItems = arena_reallocate(
+                instance->arena,
+                instance->items,
+                instance->capacity * sizeof * newItems,
+                newCapacity * sizeof * newItems);
+        }
+        else
+        {
+            newItems = realloc(
+                instance->items,
+                newCapacity * sizeof * newItems);
+        }
+
+        if (!newItems)
+        {
+            return false;
+        }
+
+        instance->items = newItems;
+        instance->capacity = newCapacity;
+    }
+
     instance->items[instance->count] = item;
     instance->count++;
+
+    return true;
 }
 
 static int brick_collection_compare_items(Object left, Object right)
@@ -110,6 +132,11 @@ static int brick_collection_compare_items(Object left, Object right)
 
 void brick_collection_sort(BrickCollection instance)
 {
+    if (!instance->count)
+    {
+        return;
+    }
+
     qsort(
         instance->items,
         instance->count,
@@ -122,59 +149,161 @@ void brick_collection_clear(BrickCollection instance)
     instance->count = 0;
 }
 
-static bool scan(BrickCollection instance)
+void finalize_brick_collection(BrickCollection instance)
 {
-    for (Brick* p = instance->items; p < instance->items + instance->count; p++)
+    if (!instance->arena)
     {
-        if ((*p)->parents.count < 2)
-        {
-            return false;
-        }
+        free(instance->items);
+    }
+}
+
+static bool parse_point(StringView line, Point result)
+{
+    struct StringView x;
+    struct StringView y;
+    struct StringView z;
+
+    if (!string_view_next_token(line, DELIMITERS, &x) ||
+        !string_view_next_token(line, DELIMITERS, &y) ||
+        !string_view_next_token(line, DELIMITERS, &z))
+    {
+        return false;
     }
 
+    result->x = string_view_to_long(&x);
+    result->y = string_view_to_long(&y);
+    result->z = string_view_to_long(&z);
+
     return true;
 }
 
-int main(void)
+static bool add(
+    Arena arena,
+    BrickCollection bricks,
+    Point p,
+    Point q,
+    int* floor)
 {
-    struct Point p;
-    struct Point q;
-    struct Brick* brickBuffer[BRICK_BUFFER_CAPACITY];
-    struct Brick* supportedBuffer[BRICK_BUFFER_CAPACITY];
-    struct BrickCollection bricks;
-    struct BrickCollection supported;
-    int floor = INT_MAX;
-    clock_t start = clock();
+    Brick current = arena_allocate(arena, sizeof * current);
+
+    if (!current)
+    {
+        return false;
+    }
 
-    brick_collection(&bricks, brickBuffer);
-    brick_collection(&supported, supportedBuffer);
+    brick(current, p, q, arena);
 
-    while (scanf("%d,%d,%d~%d,%d,%d\n", &p.x, &p.y, &p.z, &q.x, &q.y, &q.z) > 0)
+    if (!brick_collection_add(bricks, current))
     {
-        Brick current = malloc(sizeof * current);
+        return false;
+    }
+
+    if (current->floor < *floor)
+    {
+        *floor = current->floor;
+    }
+
+    return true;
+}
+
+static Exception read(
+    Stream reader,
+    Arena arena,
+    BrickCollection bricks,
+    int* floor)
+{
+    struct StringView line;
 
-        if (!brick(current, &p, &q))
+    while (stream_next_line(reader, &line))
+    {
+        struct Point p;
+        struct Point q;
+
+        if (line.begin == line.end)
+        {
+            continue;
+        }
+
+        if (!parse_point(&line, &p) || !parse_point(&line, &q))
         {
-            fprintf(stderr, "Error: Out of memory.\n");
+            return EXCEPTION_FORMAT;
+        }
 
-            return 1;
+        if (!add(arena, bricks, &p, &q, floor))
+        {
+            return EXCEPTION_OUT_OF_MEMORY;
         }
+    }
 
-        brick_collection_add(&bricks, current);
+    return EXCEPTION_NONE;
+}
 
-        if (current->floor < floor)
+// The compiled form of the input holds the two endpoints of each brick, with
+// the bricks sorted from lowest to highest.
+
+static Exception load(
+    Cache cache,
+    Arena arena,
+    BrickCollection bricks,
+    int* floor)
+{
+    struct Point points[2];
+
+    if (cache->size % sizeof points)
+    {
+        return EXCEPTION_FORMAT;
+    }
+
+    const char* end = (const char*)cache->data + cache->size;
+
+    for (const char* p = cache->data; p < end; p += sizeof points)
+    {
+        memcpy(points, p, sizeof points);
+
+        if (!add(arena, bricks, points, points + 1, floor))
         {
-            floor = current->floor;
+            return EXCEPTION_OUT_OF_MEMORY;
         }
     }
 
-    brick_collection_sort(&bricks);
+    return EXCEPTION_NONE;
+}
+
+// Part 2 compiles the same sorted bricks, so both parts share one cache
+// file per input.
+
+static void store(BrickCollection bricks, const char* input, size_t length)
+{
+    size_t size = bricks->count * 2 * sizeof(struct Point);
+    Point points = malloc(size);
+
+    if (!points)
+    {
+        return;
+    }
+
+    for (int i = 0; i < bricks->count; i++)
+    {
+        points[2 * i] = bricks->items[i]->p;
+        points[2 * i + 1] = bricks->items[i]->q;
+    }
+
+    cache_store(CACHE_NAME, input, length, points, size);
+    free(points);
+}
+
+// Settles the bricks, which must be sorted from lowest to highest.
 
-    for (Brick* p = bricks.items; p < bricks.items + bricks.count; p++)
+static bool settle(BrickCollection bricks, BrickCollection supported, int floor)
+{
+    for (Brick* p = bricks->items; p < bricks->items + bricks->count; p++)
     {
         if ((*p)->floor == floor)
         {
-            brick_collection_add(&supported, *p);
+            if (!brick_collection_add(supported, *p))
+            {
+                return false;
+            }
 
             continue;
         }
@@ -183,8 +312,8 @@ int main(void)
 
         (*p)->floor = 1;
 
-        for (Brick* q = supported.items;
-            q < supported.items + supported.count;
+        for (Brick* q = supported->items;
+            q < supported->items + supported->count;
             q++)
         {
             if ((*q)->p.x <= (*p)->q.x && (*p)->p.x <= (*q)->q.x &&
@@ -199,23 +328,101 @@ int main(void)
                     (*p)->floor = z;
                 }
 
-                if (z == (*p)->floor)
+                if (z == (*p)->floor &&
+                    !brick_collection_add(&(*p)->parents, *q))
                 {
-                    brick_collection_add(&(*p)->parents, *q);
+                    return false;
                 }
             }
         }
 
-        brick_collection_add(&supported, *p);
+        if (!brick_collection_add(supported, *p))
+        {
+            return false;
+        }
 
         for (Brick* parent = (*p)->parents.items;
             parent < (*p)->parents.items + (*p)->parents.count;
             parent++)
         {
-            brick_collection_add(&(*parent)->children, *p);
+            if (!brick_collection_add(&(*parent)->children, *p))
+            {
+                return false;
+            }
+        }
+    }
+
+    return true;
+}
+
+static bool scan(BrickCollection instance)
+{
+    for (Brick* p = instance->items; p < instance->items + instance->count; p++)
+    {
+        if ((*p)->parents.count < 2)
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+Exception solve(const char* input, size_t length, long long* result)
+{
+    int floor = INT_MAX;
+    struct Arena allocator;
+    struct BrickCollection bricks;
+    struct BrickCollection supported;
+    struct Stream reader;
+
+    stream(&reader, input, length);
+    arena(&allocator, ARENA_BLOCK_SIZE);
+    brick_collection(&bricks, NULL);
+    brick_collection(&supported, NULL);
+
+    Exception exception;
+    struct Cache cache;
+
+    if (cache_load(&cache, CACHE_NAME, input, length))
+    {
+        exception = load(&cache, &allocator, &bricks, &floor);
+
+        finalize_cache(&cache);
+    }
+    else
+    {
+        exception = read(&reader, &allocator, &bricks, &floor);
+
+        if (!exception)
+        {
+            brick_collection_sort(&bricks);
+
+            if (cache_enabled())
+            {
+                store(&bricks, input, length);
+            }
         }
     }
 
+    solver_phase("settle");
+
+    if (!exception && !settle(&bricks, &supported, floor))
+    {
+        exception = EXCEPTION_OUT_OF_MEMORY;
+    }
+
+    solver_phase("search");
+
+    if (exception)
+    {
+        finalize_brick_collection(&supported);
+        finalize_brick_collection(&bricks);
+    finalize_arena(&allocator);
+
+        return exception;
+    }
+
     int total = 0;
 
     for (Brick* q = supported.items; q < supported.items + supported.count; q++)
@@ -226,13 +433,16 @@ int main(void)
         }
     }
 
-    printf("22a %d %lf\n", total, (double)(clock() - start) / CLOCKS_PER_SEC);
+    finalize_brick_collection(&supported);
+    finalize_brick_collection(&bricks);
+    finalize_arena(&allocator);
 
-    for (Brick* p = bricks.items; p < bricks.items + bricks.count; p++)
-    {
-        finalize_brick(*p);
-        free(*p);
-    }
+    *result = total;
+
+    return EXCEPTION_NONE;
+}
 
-    return 0;
+int main(void)
+{
+    return solver_main("22a", solve);
 }
@@ -4,25 +4,17 @@
 
 #include <limits.h>
 #include <stdbool.h>
-#include <stdio.h>
 #include <stdlib.h>
-#include <time.h>
-#define BRICK_BUFFER_CAPACITY 2048
-#define BRICK_CHILDREN_CAPACITY 10
-#define BRICK_PARENTS_CAPACITY 10
-#define BRICK_SET_BUCKETS 3079
-#define BUFFER_SIZE 32
+#include <string.h>
+#include "../lib/solver.h"
+#include "../lib/stream.h"
+#include "../lib/arena.h"
+#include "../lib/cache.h"
+#include "../lib/hash_table.h"
+#define ARENA_BLOCK_SIZE 65536
+#define BRICK_COLLECTION_INITIAL_CAPACITY 4
+#define CACHE_NAME "22"
 #define DELIMITERS ",~"
-#define EXCEPTION_OUT_OF_MEMORY "Error: Out of memory.\n"
-#define SIZE_X 10
-#define SIZE_Y 10
-
-enum AddResult
-{
-    ADD_RESULT_ADDED,
-    ADD_RESULT_NOT_ADDED,
-    ADD_RESULT_OUT_OF_MEMORY
-};
 
 struct Point
 {
@@ -36,7 +28,9 @@ struct Brick;
 struct BrickCollection
 {
     struct Brick** items;
+    Arena arena;
     int count;
+    int capacity;
 };
 
 struct Brick
@@ -48,33 +42,10 @@ struct Brick
     int floor;
 };
 
-struct BrickSetEntry
-{
-    struct BrickSetEntry* nextEntry;
-    struct Brick* item;
-};
-
-struct BrickSetBucket
-{
-    struct BrickSetEntry* firstEntry;
-    struct BrickSetBucket* nextBucket;
-};
-
-struct BrickSet
-{
-    struct BrickSetBucket* firstBucket;
-    struct BrickSetBucket buckets[BRICK_SET_BUCKETS];
-    int count;
-};
-
 typedef const void* Object;
-typedef enum AddResult AddResult;
 typedef struct Point* Point;
 typedef struct Brick* Brick;
 typedef struct BrickCollection* BrickCollection;
-typedef struct BrickSetEntry* BrickSetEntry;
-typedef struct BrickSetBucket* BrickSetBucket;
-typedef struct BrickSet* BrickSet;
 
 int math_min(int a, int b)
 {
@@ -86,59 +57,70 @@ int math_min(int a, int b)
     return b;
 }
 
-void brick_collection(BrickCollection, Brick items[]);
+void brick_collection(BrickCollection instance, Arena arena);
 
-bool brick(Brick instance, Point p, Point q)
+void brick(Brick instance, Point p, Point q, Arena arena)
 {
-    Brick* parents = malloc(BRICK_PARENTS_CAPACITY * sizeof * parents);
-
-    if (!parents)
-    {
-        return false;
-    }
-
-    Brick* children = malloc(BRICK_CHILDREN_CAPACITY * sizeof * children);
-
-    if (!children)
-    {
-        free(parents);
-
-        return false;
-    }
-
     instance->p = *p;
     instance->q = *q;
     instance->floor = math_min(p->z, q->z);
 
-    brick_collection(&instance->parents, parents);
-    brick_collection(&instance->children, children);
-
-    return true;
+    brick_collection(&instance->parents, arena);
+    brick_collection(&instance->children, arena);
 }
 
-unsigned int brick_get_hash_code(Brick instance)
-{
-    return ((unsigned int)instance->p.z * SIZE_X * SIZE_Y) +
-        ((unsigned int)instance->p.y * SIZE_X) +
-        (unsigned int)instance->p.x;
-}
-
-void finalize_brick(Brick instance)
-{
-    free(instance->parents.items);
-    free(instance->children.items);
-}
+// Initializes an empty collection. If `arena` is not NULL, the items are
+// allocated from it and released with the arena.
 
-void brick_collection(BrickCollection instance, Brick items[])
+void brick_collection(BrickCollection instance, Arena arena)
 {
+    instance->items = NULL;
+    instance->arena = arena;
     instance->count = 0;
-    instance->items = items;
+    instance->capacity = 0;
 }
 
-void brick_collection_add(BrickCollection instance, Brick item)
+bool brick_collection_add(BrickCollection instance, Brick item)
 {
+    if (instance->count == instance->capacity)
+    {
+        int newCapacity = instance->capacity * 2;
+
+        if (!newCapacity)
+        {
+            newCapacity = BRICK_COLLECTION_INITIAL_CAPACITY;
+        }
+
+        Brick* newItems;
+
+        if (instance->arena)
+        {
+            newItems = arena_reallocate(
+                instance->arena,
+                instance->items,
+                instance->capacity * sizeof * newItems,
+                newCapacity * sizeof * newItems);
+        }
+        else
+        {
+            newItems = realloc(
+                instance->items,
+                newCapacity * sizeof * newItems);
+        }
+
+        if (!newItems)
+        {
+            return false;
+        }
+
+        instance->items = newItems;
+        instance->capacity = newCapacity;
+    }
+
     instance->items[instance->count] = item;
     instance->count++;
+
+    return true;
 }
 
 Brick brick_collection_remove_first(BrickCollection instance)
@@ -163,6 +145,11 @@ static int brick_collection_compare_items(Object left, Object right)
 
 void brick_collection_sort(BrickCollection instance)
 {
+    if (!instance->count)
+    {
+        return;
+    }
+
     qsort(
         instance->items,
         instance->count,
@@ -175,141 +162,179 @@ void brick_collection_clear(BrickCollection instance)
     instance->count = 0;
 }
 
-AddResult brick_set_add(BrickSet instance, Brick item)
+void finalize_brick_collection(BrickCollection instance)
 {
-    BrickSetEntry* p;
-    unsigned int hash = brick_get_hash_code(item) % BRICK_SET_BUCKETS;
+    if (!instance->arena)
+    {
+        free(instance->items);
+    }
+}
 
-    for (p = &instance->buckets[hash].firstEntry; *p; p = &(*p)->nextEntry)
+bool brick_set_is_superset(HashTable instance, BrickCollection other)
+{
+    if (instance->count < (size_t)other->count)
     {
-        if ((*p)->item == item)
+        return false;
+    }
+
+    for (Brick* p = other->items; p < other->items + other->count; p++)
+    {
+        if (!hash_table_get(instance, p))
         {
-            return ADD_RESULT_NOT_ADDED;
+            return false;
         }
     }
 
-    BrickSetEntry entry = malloc(sizeof * entry);
+    return true;
+}
 
-    if (!entry)
-    {
-        return ADD_RESULT_OUT_OF_MEMORY;
-    }
+static bool parse_point(StringView line, Point result)
+{
+    struct StringView x;
+    struct StringView y;
+    struct StringView z;
 
-    if (!instance->buckets[hash].firstEntry)
+    if (!string_view_next_token(line, DELIMITERS, &x) ||
+        !string_view_next_token(line, DELIMITERS, &y) ||
+        !string_view_next_token(line, DELIMITERS, &z))
     {
-        BrickSetBucket first = instance->firstBucket;
-
-        instance->buckets[hash].nextBucket = first;
-        instance->firstBucket = instance->buckets + hash;
+        return false;
     }
 
-    entry->item = item;
-    entry->nextEntry = NULL;
-    *p = entry;
-    instance->count++;
+    result->x = string_view_to_long(&x);
+    result->y = string_view_to_long(&y);
+    result->z = string_view_to_long(&z);
 
-    return ADD_RESULT_ADDED;
+    return true;
 }
 
-bool brick_set_contains(BrickSet instance, Brick item)
+static bool add(
+    Arena arena,
+    BrickCollection bricks,
+    Point p,
+    Point q,
+    int* floor)
 {
-    unsigned int hash = brick_get_hash_code(item) % BRICK_SET_BUCKETS;
+    Brick current = arena_allocate(arena, sizeof * current);
 
-    for (BrickSetEntry entry = instance->buckets[hash].firstEntry;
-        entry;
-        entry = entry->nextEntry)
+    if (!current)
     {
-        if (entry->item == item)
-        {
-            return true;
-        }
+        return false;
     }
 
-    return false;
-}
+    brick(current, p, q, arena);
 
-bool brick_set_is_superset(BrickSet instance, BrickCollection other)
-{
-    if (instance->count < other->count)
+    if (!brick_collection_add(bricks, current))
     {
         return false;
     }
 
-    for (Brick* p = other->items; p < other->items + other->count; p++)
+    if (current->floor < *floor)
     {
-        if (!brick_set_contains(instance, *p))
-        {
-            return false;
-        }
+        *floor = current->floor;
     }
 
     return true;
 }
 
-void brick_set_clear(BrickSet instance)
+static Exception read(
+    Stream reader,
+    Arena arena,
+    BrickCollection bricks,
+    int* floor)
 {
-    for (BrickSetBucket bucket = instance->firstBucket;
-        bucket;
-        bucket = bucket->nextBucket)
+    struct StringView line;
+
+    while (stream_next_line(reader, &line))
     {
-        BrickSetEntry entry = bucket->firstEntry;
+        struct Point p;
+        struct Point q;
 
-        while (entry)
+        if (line.begin == line.end)
         {
-            BrickSetEntry nextEntry = entry->nextEntry;
-
-            free(entry);
+            continue;
+        }
 
-            entry = nextEntry;
+        if (!parse_point(&line, &p) || !parse_point(&line, &q))
+        {
+            return EXCEPTION_FORMAT;
         }
 
-        bucket->firstEntry = NULL;
+        if (!add(arena, bricks, &p, &q, floor))
+        {
+            return EXCEPTION_OUT_OF_MEMORY;
+        }
     }
 
-    instance->firstBucket = NULL;
-    instance->count = 0;
+    return EXCEPTION_NONE;
 }
 
-int main(void)
+// The compiled form of the input holds the two endpoints of each brick, with
+// the bricks sorted from lowest to highest.
+
+static Exception load(
+    Cache cache,
+    Arena arena,
+    BrickCollection bricks,
+    int* floor)
 {
-    struct Point p;
-    struct Point q;
-    struct Brick* brickBuffer[BRICK_BUFFER_CAPACITY];
-    struct Brick* supportedBuffer[BRICK_BUFFER_CAPACITY];
-    struct BrickCollection bricks;
-    struct BrickCollection supported;
-    int floor = INT_MAX;
-    clock_t start = clock();
+    struct Point points[2];
+
+    if (cache->size % sizeof points)
+    {
+        return EXCEPTION_FORMAT;
+    }
 
-    brick_collection(&bricks, brickBuffer);
-    brick_collection(&supported, supportedBuffer);
+    const char* end = (const char*)cache->data + cache->size;
 
-    while (scanf("%d,%d,%d~%d,%d,%d\n", &p.x, &p.y, &p.z, &q.x, &q.y, &q.z) > 0)
+    for (const char* p = cache->data; p < end; p += sizeof points)
     {
-        Brick current = malloc(sizeof * current);
+        memcpy(points, p, sizeof points);
 
-        if (!brick(current, &p, &q))
+        if (!add(arena, bricks, points, points + 1, floor))
         {
-            fprintf(stderr, EXCEPTION_OUT_OF_MEMORY);
-
-            return 1;
+            return EXCEPTION_OUT_OF_MEMORY;
         }
+    }
 
-        brick_collection_add(&bricks, current);
+    return EXCEPTION_NONE;
+}
 
-        if (current->floor < floor)
-        {
-            floor = current->floor;
-        }
+// Part 1 compiles the same sorted bricks, so both parts share one cache
+// file per input.
+
+static void store(BrickCollection bricks, const char* input, size_t length)
+{
+    size_t size = bricks->count * 2 * sizeof(struct Point);
+    Point points = malloc(size);
+
+    if (!points)
+    {
+        return;
     }
 
-    brick_collection_sort(&bricks);
+    for (int i = 0; i < bricks->count; i++)
+    {
+        points[2 * i] = bricks->items[i]->p;
+        points[2 * i + 1] = bricks->items[i]->q;
+    }
+
+    cache_store(CACHE_NAME, input, length, points, size);
+    free(points);
+}
+
+// Settles the bricks, which must be sorted from lowest to highest.
 
-    for (Brick* p = bricks.items; p < bricks.items + bricks.count; p++)
+static bool settle(BrickCollection bricks, BrickCollection supported, int floor)
+{
+    for (Brick* p = bricks->items; p < bricks->items + bricks->count; p++)
     {
         if ((*p)->floor == floor)
         {
-            brick_collection_add(&supported, *p);
+            if (!brick_collection_add(supported, *p))
+            {
+                return false;
+            }
 
             continue;
         }
@@ -318,8 +343,8 @@ int main(void)
 
         (*p)->floor = 1;
 
-        for (Brick* q = supported.items;
-            q < supported.items + supported.count;
+        for (Brick* q = supported->items;
+            q < supported->items + supported->count;
             q++)
         {
             if ((*q)->p.x <= (*p)->q.x && (*p)->p.x <= (*q)->q.x &&
@@ -334,31 +359,90 @@ int main(void)
                     (*p)->floor = z;
                 }
 
-                if (z == (*p)->floor)
+                if (z == (*p)->floor &&
+                    !brick_collection_add(&(*p)->parents, *q))
                 {
-                    brick_collection_add(&(*p)->parents, *q);
+                    return false;
                 }
             }
         }
 
-        brick_collection_add(&supported, *p);
+        if (!brick_collection_add(supported, *p))
+        {
+            return false;
+        }
 
         for (Brick* parent = (*p)->parents.items;
             parent < (*p)->parents.items + (*p)->parents.count;
             parent++)
         {
-            brick_collection_add(&(*parent)->children, *p);
+            if (!brick_collection_add(&(*parent)->children, *p))
+            {
+                return false;
+            }
         }
     }
 
+    return true;
+}
+
+Exception solve(const char* input, size_t length, long long* result)
+{
+    int floor = INT_MAX;
+    struct Arena allocator;
+    struct BrickCollection bricks;
+    struct BrickCollection supported;
+    struct Stream reader;
+
+    stream(&reader, input, length);
+    arena(&allocator, ARENA_BLOCK_SIZE);
+    brick_collection(&bricks, NULL);
+    brick_collection(&supported, NULL);
+
+    Exception exception;
+    struct Cache cache;
+
+    if (cache_load(&cache, CACHE_NAME, input, length))
+    {
+        exception = load(&cache, &allocator, &bricks, &floor);
+
+        finalize_cache(&cache);
+    }
+    else
+    {
+        exception = read(&reader, &allocator, &bricks, &floor);
+
+        if (!exception)
+        {
+            brick_collection_sort(&bricks);
+
+            if (cache_enabled())
+            {
+                store(&bricks, input, length);
+            }
+        }
+    }
+
+    solver_phase("settle");
+
+    if (!exception && !settle(&bricks, &supported, floor))
+    {
+        exception = EXCEPTION_OUT_OF_MEMORY;
+    }
+
+    solver_phase("search");
+
     long total = 0;
-    struct BrickSet visited = { 0 };
+    long long insertions = 0;
+    struct HashTable visited;
     struct BrickCollection stack;
-    struct Brick* stackBuffer[BRICK_BUFFER_CAPACITY];
 
-    brick_collection(&stack, stackBuffer);
+    hash_table(&visited, sizeof(Brick), 0, NULL, NULL);
+    brick_collection(&stack, NULL);
 
-    for (Brick* q = supported.items; q < supported.items + supported.count; q++)
+    for (Brick* q = supported.items;
+        !exception && q < supported.items + supported.count;
+        q++)
     {
         brick_collection_clear(&stack);
 
@@ -366,50 +450,68 @@ int main(void)
             child < (*q)->children.items + (*q)->children.count;
             child++)
         {
-            if ((*child)->parents.count == 1)
+            if ((*child)->parents.count == 1 &&
+                !brick_collection_add(&stack, *child))
             {
-                brick_collection_add(&stack, *child);
+                exception = EXCEPTION_OUT_OF_MEMORY;
             }
         }
 
         Brick current;
 
-        while ((current = brick_collection_remove_first(&stack)))
+        while (!exception && (current = brick_collection_remove_first(&stack)))
         {
-            switch (brick_set_add(&visited, current))
+            bool added;
+
+            insertions++;
+
+            if (!hash_table_add(&visited, &current, &added))
             {
-                case ADD_RESULT_ADDED: break;
-                case ADD_RESULT_NOT_ADDED: continue;
+                exception = EXCEPTION_OUT_OF_MEMORY;
 
-                case ADD_RESULT_OUT_OF_MEMORY:
-                    fprintf(stderr, EXCEPTION_OUT_OF_MEMORY);
+                continue;
+            }
 
-                    return 1;
+            if (!added)
+            {
+                continue;
             }
 
             for (Brick* child = current->children.items;
                 child < current->children.items + current->children.count;
                 child++)
             {
-                if (brick_set_is_superset(&visited, &(*child)->parents))
+                if (brick_set_is_superset(&visited, &(*child)->parents) &&
+                    !brick_collection_add(&stack, *child))
                 {
-                    brick_collection_add(&stack, *child);
+                    exception = EXCEPTION_OUT_OF_MEMORY;
                 }
             }
         }
 
         total += visited.count;
 
-        brick_set_clear(&visited);
+        hash_table_clear(&visited);
     }
 
-    printf("22b %ld %lf\n", total, (double)(clock() - start) / CLOCKS_PER_SEC);
+    solver_work("insertions", insertions);
+    finalize_hash_table(&visited);
+    finalize_brick_collection(&stack);
+    finalize_brick_collection(&supported);
+    finalize_brick_collection(&bricks);
+    finalize_arena(&allocator);
 
-    for (Brick* p = bricks.items; p < bricks.items + bricks.count; p++)
+    if (exception)
     {
-        finalize_brick(*p);
-        free(*p);
+        return exception;
     }
 
-    return 0;
+    *result = total;
+
+    return EXCEPTION_NONE;
+}
+
+int main(void)
+{
+    return solver_main("22b", solve);
 }
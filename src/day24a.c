@@ -3,9 +3,14 @@
 // Never Tell Me The Odds Part 1
 
 #include <stdbool.h>
-#include <stdio.h>
-#include <time.h>
-#define BODY3_COLLECTION_CAPACITY 512
+#include <stdlib.h>
+#include <string.h>
+#include "../lib/number.h"
+#include "../lib/solver.h"
+#include "../lib/stream.h"
+#include "../lib/cache.h"
+#define BODY3_COLLECTION_INITIAL_CAPACITY 512
+#define CACHE_NAME "24"
 
 struct Body3
 {
@@ -19,8 +24,9 @@ struct Body3
 
 struct Body3Collection
 {
-    struct Body3 items[BODY3_COLLECTION_CAPACITY];
+    struct Body3* items;
     int count;
+    int capacity;
 };
 
 struct Point2
@@ -42,13 +48,44 @@ typedef struct Line2* Line2;
 
 void body3_collection(Body3Collection instance)
 {
+    instance->items = NULL;
     instance->count = 0;
+    instance->capacity = 0;
 }
 
-void body3_collection_add(Body3Collection instance, Body3 item)
+bool body3_collection_add(Body3Collection instance, Body3 item)
 {
+    if (instance->count == instance->capacity)
+    {
+        int newCapacity = instance->capacity * 2;
+
+        if (!newCapacity)
+        {
+            newCapacity = BODY3_COLLECTION_INITIAL_CAPACITY;
+        }
+
+        Body3 newItems = realloc(
+            instance->items,
+            newCapacity * sizeof * newItems);
+
+        if (!newItems)
+        {
+            return false;
+        }
+
+        instance->items = newItems;
+        instance->capacity = newCapacity;
+    }
+
     instance->items[instance->count] = *item;
     instance->count++;
+
+    return true;
+}
+
+void finalize_body3_collection(Body3Collection instance)
+{
+    free(instance->items);
 }
 
 bool line2_point_intersection(Line2 l, Line2 m, Point2 result)
@@ -74,23 +111,132 @@ bool line2_point_intersection(Line2 l, Line2 m, Point2 result)
     return true;
 }
 
-int main(void)
+static bool parse_body3(StringView line, Body3 result)
+{
+    long long values[6];
+    const char* p = line->begin;
+
+    for (int i = 0; i < 6; i++)
+    {
+        while (p < line->end && (*p == ',' || *p == '@' || *p == ' '))
+        {
+            p++;
+        }
+
+        const char* next = number_parse_decimal(p, line->end, values + i);
+
+        if (next == p)
+        {
+            return false;
+        }
+
+        p = next;
+    }
+
+    result->x = values[0];
+    result->y = values[1];
+    result->z = values[2];
+    result->dx = values[3];
+    result->dy = values[4];
+    result->dz = values[5];
+
+    return true;
+}
+
+static Exception read(Stream reader, Body3Collection bodies)
 {
     struct Body3 body;
+    struct StringView line;
+
+    while (stream_next_line(reader, &line))
+    {
+        if (line.begin == line.end)
+        {
+            continue;
+        }
+
+        if (!parse_body3(&line, &body))
+        {
+            return EXCEPTION_FORMAT;
+        }
+
+        if (!body3_collection_add(bodies, &body))
+        {
+            return EXCEPTION_OUT_OF_MEMORY;
+        }
+    }
+
+    return EXCEPTION_NONE;
+}
+
+static Exception load(Cache cache, Body3Collection bodies)
+{
+    struct Body3 body;
+
+    if (cache->size % sizeof body)
+    {
+        return EXCEPTION_FORMAT;
+    }
+
+    const char* end = (const char*)cache->data + cache->size;
+
+    for (const char* p = cache->data; p < end; p += sizeof body)
+    {
+        memcpy(&body, p, sizeof body);
+
+        if (!body3_collection_add(bodies, &body))
+        {
+            return EXCEPTION_OUT_OF_MEMORY;
+        }
+    }
+
+    return EXCEPTION_NONE;
+}
+
+// Part 2 parses the same hailstones, so both parts share one cache file per
+// input.
+
+static void store(Body3Collection bodies, const char* input, size_t length)
+{
+    cache_store(
+        CACHE_NAME,
+        input,
+        length,
+        bodies->items,
+        bodies->count * sizeof * bodies->items);
+}
+
+Exception solve(const char* input, size_t length, long long* result)
+{
+    Exception exception;
     struct Body3Collection bodies;
-    clock_t start = clock();
+    struct Cache cache;
+    struct Stream reader;
 
+    stream(&reader, input, length);
     body3_collection(&bodies);
 
-    while (scanf("%lld, %lld, %lld @ %d, %d, %d\n",
-        &body.x,
-        &body.y,
-        &body.z,
-        &body.dx,
-        &body.dy,
-        &body.dz) > 0)
+    if (cache_load(&cache, CACHE_NAME, input, length))
+    {
+        exception = load(&cache, &bodies);
+
+        finalize_cache(&cache);
+    }
+    else
+    {
+        exception = read(&reader, &bodies);
+
+        if (!exception && cache_enabled())
+        {
+            store(&bodies, input, length);
+        }
+    }
+
+    if (exception)
     {
-        body3_collection_add(&bodies, &body);
+        finalize_body3_collection(&bodies);
+
+        return exception;
     }
 
     int total = 0;
@@ -124,5 +270,14 @@ int main(void)
         }
     }
 
-    printf("24a %d %lf\n", total, (double)(clock() - start) / CLOCKS_PER_SEC);
+    finalize_body3_collection(&bodies);
+
+    *result = total;
+
+    return EXCEPTION_NONE;
+}
+
+int main(void)
+{
+    return solver_main("24a", solve);
 }
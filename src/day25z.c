@@ -4,58 +4,43 @@
 
 #include <limits.h>
 #include <stdbool.h>
-#include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
-#include <time.h>
-#define BUFFER_SIZE 64
-#define DELIMITERS " \n"
-#define EXCEPTION_OUT_OF_MEMORY "Error: Out of memory.\n"
-#define GRAPH_BUCKETS 3079
+#include "../lib/solver.h"
+#include "../lib/stream.h"
+#include "../lib/arena.h"
+#include "../lib/cache.h"
+#include "../lib/hash_table.h"
+#include "../lib/queue.h"
+#include "../lib/trace.h"
+#define ARENA_BLOCK_SIZE 65536
+#define CACHE_NAME "25z"
+#define DELIMITERS " "
+#define GRAPH_INITIAL_CAPACITY 64
 #define KEY_SIZE 3
-#define VERTEX_MAX_DEGREE 16
-#define VERTEX_QUEUE_CAPACITY 512
-
-struct Vertex;
+#define VERTEX_INITIAL_DEGREE 4
 
 struct Edge
 {
-    struct Vertex* target;
+    int target;
     int capacity;
 };
 
 struct Vertex
 {
-    struct Vertex* nextVertex;
-    struct Vertex* source;
-    struct Edge edges[VERTEX_MAX_DEGREE];
+    struct Edge* edges;
     int degree;
-    char key[KEY_SIZE];
-};
-
-struct VertexQueue
-{
-    struct Vertex* items[VERTEX_QUEUE_CAPACITY];
-    int first;
-    int last;
-};
-
-struct GraphBucket
-{
-    struct Vertex* firstVertex;
-    struct GraphBucket* nextBucket;
+    int edgeCapacity;
+    int source;
 };
 
 struct Graph
 {
-    struct GraphBucket* firstBucket;
-    struct GraphBucket buckets[GRAPH_BUCKETS];
-};
-
-struct GraphIterator
-{
-    struct Vertex* currentVertex;
-    struct GraphBucket* currentBucket;
+    struct Vertex* vertices;
+    int count;
+    int capacity;
+    struct HashTable keys;
+    struct Arena edges;
 };
 
 struct MinCut
@@ -63,25 +48,49 @@ struct MinCut
     int value;
     int reachable;
     int nonReachable;
+    int paths;
+    long long visits;
 };
 
-typedef char* String;
 typedef struct Vertex* Vertex;
 typedef struct Edge* Edge;
-typedef struct VertexQueue* VertexQueue;
-typedef struct GraphBucket* GraphBucket;
 typedef struct Graph* Graph;
-typedef struct GraphIterator* GraphIterator;
 typedef struct MinCut* MinCut;
 
-void vertex_add_edge(Vertex instance, Vertex target, int capacity)
+bool vertex_add_edge(Vertex instance, Arena arena, int target, int capacity)
 {
+    if (instance->degree == instance->edgeCapacity)
+    {
+        int newCapacity = instance->edgeCapacity * 2;
+
+        if (!newCapacity)
+        {
+            newCapacity = VERTEX_INITIAL_DEGREE;
+        }
+
+        Edge newEdges = arena_reallocate(
+            arena,
+            instance->edges,
+            instance->edgeCapacity * sizeof * newEdges,
+            newCapacity * sizeof * newEdges);
+
+        if (!newEdges)
+        {
+            return false;
+        }
+
+        instance->edges = newEdges;
+        instance->edgeCapacity = newCapacity;
+    }
+
     instance->edges[instance->degree].target = target;
     instance->edges[instance->degree].capacity = capacity;
     instance->degree++;
+
+    return true;
 }
 
-int* vertex_capacity(Vertex instance, Vertex target)
+int* vertex_capacity(Vertex instance, int target)
 {
     for (Edge e = instance->edges; e < instance->edges + instance->degree; e++)
     {
@@ -94,208 +103,143 @@ int* vertex_capacity(Vertex instance, Vertex target)
     return NULL;
 }
 
-void vertex_queue(VertexQueue instance)
+void graph(Graph instance)
 {
-    instance->first = -1;
-    instance->last = -1;
+    instance->vertices = NULL;
+    instance->count = 0;
+    instance->capacity = 0;
+
+    hash_table(&instance->keys, KEY_SIZE, sizeof(int), NULL, NULL);
+    arena(&instance->edges, ARENA_BLOCK_SIZE);
 }
 
-void vertex_queue_enqueue(VertexQueue instance, Vertex item)
+int graph_add_vertex(Graph instance)
 {
-    if (instance->first == -1)
-    {
-        instance->first = 0;
-        instance->last = 0;
-    }
-    else if (instance->first && instance->last == VERTEX_QUEUE_CAPACITY - 1)
+    if (instance->count == instance->capacity)
     {
-        instance->last = 0;
-    }
-    else
-    {
-        instance->last++;
-    }
+        int newCapacity = instance->capacity * 2;
 
-    instance->items[instance->last] = item;
-}
+        if (!newCapacity)
+        {
+            newCapacity = GRAPH_INITIAL_CAPACITY;
+        }
 
-Vertex vertex_queue_dequeue(VertexQueue instance)
-{
-    if (instance->first == -1)
-    {
-        return NULL;
-    }
+        Vertex newVertices = realloc(
+            instance->vertices,
+            newCapacity * sizeof * newVertices);
 
-    Vertex result = instance->items[instance->first];
+        if (!newVertices)
+        {
+            return -1;
+        }
 
-    if (instance->first == instance->last)
-    {
-        instance->first = -1;
-        instance->last = -1;
-    }
-    else if (instance->first == VERTEX_QUEUE_CAPACITY - 1)
-    {
-        instance->first = 0;
-    }
-    else
-    {
-        instance->first++;
+        instance->vertices = newVertices;
+        instance->capacity = newCapacity;
     }
 
-    return result;
-}
+    Vertex u = instance->vertices + instance->count;
 
-void graph_begin(Graph instance, GraphIterator iterator)
-{
-    iterator->currentBucket = instance->firstBucket;
+    u->edges = NULL;
+    u->degree = 0;
+    u->edgeCapacity = 0;
+    instance->count++;
 
-    if (iterator->currentBucket)
-    {
-        iterator->currentVertex = iterator->currentBucket->firstVertex;
-    }
-    else
-    {
-        iterator->currentVertex = NULL;
-    }
+    return instance->count - 1;
 }
 
-bool graph_end(GraphIterator iterator)
+int graph_vertex(Graph instance, const char key[])
 {
-    return !iterator->currentVertex && !iterator->currentBucket;
-}
+    bool added;
+    int* index = hash_table_add(&instance->keys, key, &added);
 
-void graph_next(GraphIterator iterator)
-{
-    if (graph_end(iterator))
+    if (!index)
     {
-        return;
+        return -1;
     }
 
-    if (iterator->currentVertex)
+    if (added)
     {
-        iterator->currentVertex = iterator->currentVertex->nextVertex;
+        *index = graph_add_vertex(instance);
     }
 
-    if (!iterator->currentVertex)
-    {
-        iterator->currentBucket = iterator->currentBucket->nextBucket;
-
-        if (iterator->currentBucket)
-        {
-            iterator->currentVertex = iterator->currentBucket->firstVertex;
-        }
-    }
+    return *index;
 }
 
-static unsigned int graph_hash(char key[])
+bool graph_search(
+    Graph instance,
+    Queue queue,
+    int source,
+    int target,
+    long long* visits)
 {
-    unsigned int hash = 0;
-
-    for (int i = 0; i < KEY_SIZE; i++)
+    for (int i = 0; i < instance->count; i++)
     {
-        hash = (hash * 36) + key[i] - 97;
+        instance->vertices[i].source = -1;
     }
 
-    return hash % GRAPH_BUCKETS;
-}
+    instance->vertices[source].source = source;
 
-Vertex graph_vertex(Graph instance, char key[])
-{
-    Vertex* p;
-    unsigned int hash = graph_hash(key);
+    int* next;
 
-    for (p = &instance->buckets[hash].firstVertex; *p; p = &(*p)->nextVertex)
-    {
-        if (memcmp(key, (*p)->key, KEY_SIZE) == 0)
-        {
-            return *p;
-        }
-    }
-
-    Vertex u = malloc(sizeof * u);
+    // Each vertex enters the queue at most once per search, and the caller
+    // reserves room for all of them, so these additions cannot fail.
 
-    if (!u)
-    {
-        return NULL;
-    }
+    queue_enqueue_many(queue, &source, 1);
 
-    if (!instance->buckets[hash].firstVertex)
+    while ((next = queue_dequeue(queue)))
     {
-        GraphBucket first = instance->firstBucket;
+        int current = *next;
+        Vertex u = instance->vertices + current;
 
-        instance->buckets[hash].nextBucket = first;
-        instance->firstBucket = instance->buckets + hash;
-    }
-
-    memcpy(u->key, key, KEY_SIZE);
-
-    u->nextVertex = NULL;
-    u->degree = 0;
-    *p = u;
-
-    return u;
-}
+        (*visits)++;
 
-bool graph_search(Graph instance, Vertex source, Vertex target)
-{
-    struct GraphIterator iter;
-
-    for (graph_begin(instance, &iter); !graph_end(&iter); graph_next(&iter))
-    {
-        iter.currentVertex->source = NULL;
-    }
-
-    source->source = source;
-
-    Vertex current;
-    struct VertexQueue queue;
-
-    vertex_queue(&queue);
-    vertex_queue_enqueue(&queue, source);
-
-    while ((current = vertex_queue_dequeue(&queue)))
-    {
-        for (Edge e = current->edges; e < current->edges + current->degree; e++)
+        for (Edge e = u->edges; e < u->edges + u->degree; e++)
         {
-            if (e->capacity <= 0 || e->target->source)
+            if (e->capacity <= 0 || instance->vertices[e->target].source != -1)
             {
                 continue;
             }
 
-            e->target->source = current;
+            instance->vertices[e->target].source = current;
 
-            vertex_queue_enqueue(&queue, e->target);
+            queue_enqueue_many(queue, &e->target, 1);
         }
     }
 
-    return target->source;
+    return instance->vertices[target].source != -1;
 }
 
-void graph_min_cut(Graph instance, Vertex source, Vertex target, MinCut result)
+void graph_min_cut(
+    Graph instance,
+    Queue queue,
+    int source,
+    int target,
+    MinCut result)
 {
     result->value = 0;
     result->reachable = 0;
     result->nonReachable = 0;
+    result->paths = 0;
+    result->visits = 0;
 
-    struct GraphIterator iter;
-
-    for (graph_begin(instance, &iter); !graph_end(&iter); graph_next(&iter))
+    for (Vertex u = instance->vertices;
+        u < instance->vertices + instance->count;
+        u++)
     {
-        Vertex u = iter.currentVertex;
-
         for (Edge e = u->edges; e < u->edges + u->degree; e++)
         {
             e->capacity = 1;
         }
     }
 
-    while (graph_search(instance, source, target))
+    while (graph_search(instance, queue, source, target, &result->visits))
     {
         int flow = INT_MAX;
 
-        for (Vertex u = target; u != source; u = u->source)
+        for (int v = target; v != source; v = instance->vertices[v].source)
         {
-            int* capacity = vertex_capacity(u->source, u);
+            int u = instance->vertices[v].source;
+            int* capacity = vertex_capacity(instance->vertices + u, v);
 
             if (*capacity < flow)
             {
@@ -303,15 +247,18 @@ void graph_min_cut(Graph instance, Vertex source, Vertex target, MinCut result)
             }
 
             *capacity -= flow;
-            *vertex_capacity(u, u->source) += flow;
+            *vertex_capacity(instance->vertices + v, u) += flow;
         }
 
         result->value += flow;
+        result->paths++;
     }
 
-    for (graph_begin(instance, &iter); !graph_end(&iter); graph_next(&iter))
+    for (Vertex u = instance->vertices;
+        u < instance->vertices + instance->count;
+        u++)
     {
-        if (iter.currentVertex->source)
+        if (u->source != -1)
         {
             result->reachable++;
         }
@@ -322,102 +269,242 @@ void graph_min_cut(Graph instance, Vertex source, Vertex target, MinCut result)
     }
 }
 
-void graph_clear(Graph instance)
+void finalize_graph(Graph instance)
 {
-    for (GraphBucket bucket = instance->firstBucket;
-        bucket;
-        bucket = bucket->nextBucket)
-    {
-        Vertex u = bucket->firstVertex;
+    free(instance->vertices);
+    finalize_hash_table(&instance->keys);
+    finalize_arena(&instance->edges);
+}
+
+long scan(Graph graph, Queue queue)
+{
+    long result = -1;
+    long long cuts = 0;
+    long long paths = 0;
+    long long visits = 0;
+    struct MinCut cut;
 
-        while (u)
+    for (int u = 0; result == -1 && u < graph->count; u++)
+    {
+        for (int v = u + 1; result == -1 && v < graph->count; v++)
         {
-            Vertex v = u->nextVertex;
+            trace_begin("min_cut");
+            graph_min_cut(graph, queue, u, v, &cut);
+            trace_end("min_cut");
 
-            free(u);
+            cuts++;
+            paths += cut.paths;
+            visits += cut.visits;
 
-            u = v;
+            if (cut.value == 3)
+            {
+                result = cut.reachable * cut.nonReachable;
+            }
         }
-
-        bucket->firstVertex = NULL;
     }
 
-    instance->firstBucket = NULL;
+    solver_work("min_cuts", cuts);
+    solver_work("augmenting_paths", paths);
+    solver_work("search_visits", visits);
+
+    return result;
 }
 
-long scan(Graph graph)
+static Exception read(Stream reader, Graph g)
 {
-    struct MinCut result;
-    struct GraphIterator u;
+    struct StringView line;
 
-    for (graph_begin(graph, &u); !graph_end(&u); graph_next(&u))
+    while (stream_next_line(reader, &line))
     {
-        struct GraphIterator v = u;
+        const char* mid = memchr(line.begin, ':', line.end - line.begin);
+
+        if (!mid || mid - line.begin != KEY_SIZE)
+        {
+            return EXCEPTION_FORMAT;
+        }
+
+        int u = graph_vertex(g, line.begin);
 
-        for (graph_next(&v); !graph_end(&v); graph_next(&v))
+        if (u == -1)
         {
-            graph_min_cut(graph, u.currentVertex, v.currentVertex, &result);
+            return EXCEPTION_OUT_OF_MEMORY;
+        }
 
-            if (result.value == 3)
+        struct StringView target;
+        struct StringView targets = { mid + 1, line.end };
+
+        while (string_view_next_token(&targets, DELIMITERS, &target))
+        {
+            if (target.end - target.begin != KEY_SIZE)
             {
-                return result.reachable * result.nonReachable;
+                return EXCEPTION_FORMAT;
+            }
+
+            int v = graph_vertex(g, target.begin);
+
+            if (v == -1 ||
+                !vertex_add_edge(g->vertices + u, &g->edges, v, 1) ||
+                !vertex_add_edge(g->vertices + v, &g->edges, u, 1))
+            {
+                return EXCEPTION_OUT_OF_MEMORY;
             }
         }
     }
 
-    return -1;
+    return EXCEPTION_NONE;
 }
 
-int main(void)
+// The compiled form of the input is the number of vertices followed by the
+// degree and the targets of each vertex in turn. Vertices are identified by
+// index, so the keys are not needed.
+
+static Exception load(Cache cache, Graph g)
 {
-    char buffer[BUFFER_SIZE];
-    struct Graph g = { 0 };
-    clock_t start = clock();
+    const int* p = cache->data;
+    const int* end = p + cache->size / sizeof * p;
 
-    while (fgets(buffer, sizeof buffer, stdin))
+    if (cache->size % sizeof * p || p == end)
     {
-        char* mid = strstr(buffer, ": ");
+        return EXCEPTION_FORMAT;
+    }
+
+    int count = *p;
+
+    p++;
 
-        if (!mid)
+    while (g->count < count)
+    {
+        if (graph_add_vertex(g) == -1)
         {
-            fprintf(stderr, "Error: Format.\n");
+            return EXCEPTION_OUT_OF_MEMORY;
+        }
+    }
 
-            return 1;
+    for (int u = 0; u < g->count; u++)
+    {
+        if (p == end || *p < 0 || *p > end - p - 1)
+        {
+            return EXCEPTION_FORMAT;
         }
 
-        *mid = '\0';
+        const int* targets = p + 1;
 
-        Vertex u = graph_vertex(&g, buffer);
+        p = targets + *p;
 
-        if (!u)
+        for (const int* v = targets; v < p; v++)
         {
-            fprintf(stderr, EXCEPTION_OUT_OF_MEMORY);
+            if (*v < 0 || *v >= g->count)
+            {
+                return EXCEPTION_FORMAT;
+            }
 
-            return 1;
+            if (!vertex_add_edge(g->vertices + u, &g->edges, *v, 1))
+            {
+                return EXCEPTION_OUT_OF_MEMORY;
+            }
         }
+    }
+
+    if (p != end)
+    {
+        return EXCEPTION_FORMAT;
+    }
+
+    return EXCEPTION_NONE;
+}
 
-        for (String target = strtok(mid + 2, DELIMITERS);
-            target;
-            target = strtok(NULL, DELIMITERS))
+static void store(Graph g, const char* input, size_t length)
+{
+    size_t count = g->count + 1;
+
+    for (int u = 0; u < g->count; u++)
+    {
+        count += g->vertices[u].degree;
+    }
+
+    int* items = malloc(count * sizeof * items);
+
+    if (!items)
+    {
+        return;
+    }
+
+    int* p = items;
+
+    *p = g->count;
+    p++;
+
+    for (int u = 0; u < g->count; u++)
+    {
+        Vertex vertex = g->vertices + u;
+
+        *p = vertex->degree;
+        p++;
+
+        for (Edge e = vertex->edges; e < vertex->edges + vertex->degree; e++)
         {
-            Vertex v = graph_vertex(&g, target);
+            *p = e->target;
+            p++;
+        }
+    }
 
-            if (!v)
-            {
-                fprintf(stderr, EXCEPTION_OUT_OF_MEMORY);
+    cache_store(CACHE_NAME, input, length, items, count * sizeof * items);
+    free(items);
+}
 
-                return 1;
-            }
+Exception solve(const char* input, size_t length, long long* result)
+{
+    Exception exception;
+    struct Cache cache;
+    struct Graph g;
+    struct Stream reader;
+
+    stream(&reader, input, length);
+    graph(&g);
 
-            vertex_add_edge(u, v, 1);
-            vertex_add_edge(v, u, 1);
+    if (cache_load(&cache, CACHE_NAME, input, length))
+    {
+        exception = load(&cache, &g);
+
+        finalize_cache(&cache);
+    }
+    else
+    {
+        exception = read(&reader, &g);
+
+        if (!exception && cache_enabled())
+        {
+            store(&g, input, length);
         }
     }
 
-    long result = scan(&g);
+    struct Queue frontier;
 
-    printf("25z %ld %lf\n", result, (double)(clock() - start) / CLOCKS_PER_SEC);
-    graph_clear(&g);
+    queue(&frontier, sizeof(int));
 
-    return 0;
+    if (!exception && !queue_reserve(&frontier, g.count))
+    {
+        exception = EXCEPTION_OUT_OF_MEMORY;
+    }
+
+    if (exception)
+    {
+        finalize_graph(&g);
+
+        return exception;
+    }
+
+    solver_phase("search");
+
+    *result = scan(&g, &frontier);
+
+    finalize_queue(&frontier);
+    finalize_graph(&g);
+
+    return EXCEPTION_NONE;
+}
+
+int main(void)
+{
+    return solver_main("25z", solve);
 }
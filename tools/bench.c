@@ -0,0 +1,574 @@
+// Licensed under the MIT License.
+
+// Benchmark Harness
+
+#define _POSIX_C_SOURCE 200809L
+#include <fcntl.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <time.h>
+#include <unistd.h>
+#define BUDGET_COLLECTION_INITIAL_CAPACITY 64
+#define BUFFER_SIZE 256
+#define DEFAULT_FACTOR 5
+#define DEFAULT_RUNS 20
+#define DEFAULT_WARMUPS 3
+#define DELIMITERS " \t\n"
+#define EXCEPTION_FORMAT "Error: Format.\n"
+#define EXCEPTION_OUT_OF_MEMORY "Error: Out of memory.\n"
+#define EXCEPTION_USAGE "Usage: bench [-n runs] [-w warmups] " \
+    "[-b budgets] [-f factor] manifest\n"
+
+struct Sample
+{
+    double wall;
+    double cpu;
+    double solver;
+};
+
+struct Statistics
+{
+    double min;
+    double median;
+    double p95;
+    double p99;
+};
+
+struct Budget
+{
+    char target[BUFFER_SIZE];
+    double seconds;
+};
+
+struct BudgetCollection
+{
+    struct Budget* items;
+    int count;
+    int capacity;
+};
+
+typedef const void* Object;
+typedef char* String;
+typedef struct Sample* Sample;
+typedef struct Statistics* Statistics;
+typedef struct Budget* Budget;
+typedef struct BudgetCollection* BudgetCollection;
+
+void budget_collection(BudgetCollection instance)
+{
+    instance->items = NULL;
+    instance->count = 0;
+    instance->capacity = 0;
+}
+
+int budget_collection_add(
+    BudgetCollection instance,
+    String target,
+    double seconds)
+{
+    if (instance->count == instance->capacity)
+    {
+        int newCapacity = instance->capacity * 2;
+
+        if (!newCapacity)
+        {
+            newCapacity = BUDGET_COLLECTION_INITIAL_CAPACITY;
+        }
+
+        Budget newItems = realloc(
+            instance->items,
+            newCapacity * sizeof * newItems);
+
+        if (!newItems)
+        {
+            return 0;
+        }
+
+        instance->items = newItems;
+        instance->capacity = newCapacity;
+    }
+
+    Budget item = instance->items + instance->count;
+
+    snprintf(item->target, sizeof item->target, "%s", target);
+
+    item->seconds = seconds;
+    instance->count++;
+
+    return 1;
+}
+
+// Returns the budget of the target in seconds, or a negative number if the
+// target has no budget.
+
+double budget_collection_get(BudgetCollection instance, String target)
+{
+    for (int i = 0; i < instance->count; i++)
+    {
+        if (strcmp(instance->items[i].target, target) == 0)
+        {
+            return instance->items[i].seconds;
+        }
+    }
+
+    return -1;
+}
+
+void finalize_budget_collection(BudgetCollection instance)
+{
+    free(instance->items);
+}
+
+static int compare(Object left, Object right)
+{
+    double leftValue = *(const double*)left;
+    double rightValue = *(const double*)right;
+
+    if (leftValue < rightValue)
+    {
+        return -1;
+    }
+
+    if (leftValue > rightValue)
+    {
+        return 1;
+    }
+
+    return 0;
+}
+
+static double percentile(double sorted[], int count, int percent)
+{
+    int rank = (percent * count + 99) / 100;
+
+    if (rank < 1)
+    {
+        rank = 1;
+    }
+
+    return sorted[rank - 1];
+}
+
+static void summarize(double values[], int count, Statistics result)
+{
+    qsort(values, count, sizeof * values, compare);
+
+    result->min = values[0];
+    result->median = percentile(values, count, 50);
+    result->p95 = percentile(values, count, 95);
+    result->p99 = percentile(values, count, 99);
+}
+
+static double seconds(struct timeval value)
+{
+    return value.tv_sec + value.tv_usec / 1e6;
+}
+
+static double cpu_time(void)
+{
+    struct rusage usage;
+
+    if (getrusage(RUSAGE_CHILDREN, &usage) == -1)
+    {
+        return 0;
+    }
+
+    return seconds(usage.ru_utime) + seconds(usage.ru_stime);
+}
+
+static double wall_time(void)
+{
+    struct timespec value;
+
+    if (clock_gettime(CLOCK_MONOTONIC, &value) == -1)
+    {
+        return 0;
+    }
+
+    return value.tv_sec + value.tv_nsec / 1e9;
+}
+
+// Reads the output of a child into the buffer until the end of the stream,
+// discarding whatever does not fit.
+
+static void read_output(int descriptor, char buffer[], size_t size)
+{
+    size_t length = 0;
+    char discarded[BUFFER_SIZE];
+
+    for (;;)
+    {
+        ssize_t count;
+
+        if (length < size - 1)
+        {
+            count = read(descriptor, buffer + length, size - 1 - length);
+
+            if (count > 0)
+            {
+                length += count;
+            }
+        }
+        else
+        {
+            count = read(descriptor, discarded, sizeof discarded);
+        }
+
+        if (count <= 0)
+        {
+            break;
+        }
+    }
+
+    buffer[length] = '\0';
+}
+
+static int run(String program, String input, Sample result)
+{
+    int descriptors[2];
+
+    if (pipe(descriptors) == -1)
+    {
+        return -1;
+    }
+
+    double cpuStart = cpu_time();
+    double wallStart = wall_time();
+    pid_t child = fork();
+
+    if (child == -1)
+    {
+        close(descriptors[0]);
+        close(descriptors[1]);
+
+        return -1;
+    }
+
+    if (!child)
+    {
+        int inputDescriptor = open(input, O_RDONLY);
+
+        if (inputDescriptor == -1 ||
+            dup2(inputDescriptor, STDIN_FILENO) == -1 ||
+            dup2(descriptors[1], STDOUT_FILENO) == -1)
+        {
+            _exit(127);
+        }
+
+        close(descriptors[0]);
+        execl(program, program, (char*)NULL);
+        _exit(127);
+    }
+
+    int status;
+    char output[BUFFER_SIZE];
+
+    close(descriptors[1]);
+    read_output(descriptors[0], output, sizeof output);
+    close(descriptors[0]);
+
+    if (waitpid(child, &status, 0) == -1)
+    {
+        return -1;
+    }
+
+    result->wall = wall_time() - wallStart;
+    result->cpu = cpu_time() - cpuStart;
+
+    if (!WIFEXITED(status))
+    {
+        return -1;
+    }
+
+    // Each program reports its own CPU time as the third field of its output,
+    // excluding the cost of starting the process.
+
+    if (!WEXITSTATUS(status) &&
+        sscanf(output, "%*s %*s %lf", &result->solver) != 1)
+    {
+        return -1;
+    }
+
+    return WEXITSTATUS(status);
+}
+
+static void print_statistics(Statistics value)
+{
+    printf(",%lf,%lf,%lf,%lf", value->min, value->median, value->p95,
+        value->p99);
+}
+
+// Measures a target on an input. If `budgeted`, the record ends with budget and
+// status columns: if `budget` is not negative, the median time reported by the
+// target is compared with `budget` multiplied by `factor`; otherwise, both
+// columns are empty. Returns 1 if the target fails or exceeds its budget.
+
+static int measure(
+    String target,
+    String input,
+    int runs,
+    int warmups,
+    bool budgeted,
+    double budget,
+    double factor)
+{
+    char program[BUFFER_SIZE];
+    struct Sample sample;
+    struct Statistics wall;
+    struct Statistics cpu;
+    struct Statistics solver;
+    double* walls = malloc(runs * sizeof * walls);
+    double* cpus = malloc(runs * sizeof * cpus);
+    double* solvers = malloc(runs * sizeof * solvers);
+
+    if (!walls || !cpus || !solvers)
+    {
+        free(walls);
+        free(cpus);
+        free(solvers);
+        fprintf(stderr, EXCEPTION_OUT_OF_MEMORY);
+
+        return 1;
+    }
+
+    snprintf(program, sizeof program, "./%s.o", target);
+
+    for (int i = 0; i < warmups + runs; i++)
+    {
+        int status = run(program, input, &sample);
+
+        if (status)
+        {
+            fprintf(stderr, "Error: %s %s exited with status %d.\n",
+                target, input, status);
+            free(walls);
+            free(cpus);
+            free(solvers);
+
+            return 1;
+        }
+
+        if (i < warmups)
+        {
+            continue;
+        }
+
+        walls[i - warmups] = sample.wall;
+        cpus[i - warmups] = sample.cpu;
+        solvers[i - warmups] = sample.solver;
+    }
+
+    summarize(walls, runs, &wall);
+    summarize(cpus, runs, &cpu);
+    summarize(solvers, runs, &solver);
+    printf("%s,%s,%d", target, input, runs);
+    print_statistics(&wall);
+    print_statistics(&cpu);
+    print_statistics(&solver);
+    free(walls);
+    free(cpus);
+    free(solvers);
+
+    if (!budgeted)
+    {
+        printf("\n");
+
+        return 0;
+    }
+
+    if (budget < 0)
+    {
+        printf(",,\n");
+
+        return 0;
+    }
+
+    if (solver.median > budget * factor)
+    {
+        printf(",%lf,over\n", budget);
+        fprintf(stderr, "Error: %s %s took %lf s, over its budget of %lf s.\n",
+            target, input, solver.median, budget * factor);
+
+        return 1;
+    }
+
+    printf(",%lf,ok\n", budget);
+
+    return 0;
+}
+
+static int read_budgets(String path, BudgetCollection result)
+{
+    FILE* stream = fopen(path, "r");
+
+    if (!stream)
+    {
+        fprintf(stderr, EXCEPTION_FORMAT);
+
+        return 0;
+    }
+
+    char buffer[BUFFER_SIZE];
+
+    while (fgets(buffer, sizeof buffer, stream))
+    {
+        if (buffer[0] == '#')
+        {
+            continue;
+        }
+
+        String target = strtok(buffer, DELIMITERS);
+
+        if (!target)
+        {
+            continue;
+        }
+
+        String seconds = strtok(NULL, DELIMITERS);
+
+        if (!seconds)
+        {
+            fprintf(stderr, EXCEPTION_FORMAT);
+            fclose(stream);
+
+            return 0;
+        }
+
+        if (!budget_collection_add(result, target, atof(seconds)))
+        {
+            fprintf(stderr, EXCEPTION_OUT_OF_MEMORY);
+            fclose(stream);
+
+            return 0;
+        }
+    }
+
+    fclose(stream);
+
+    return 1;
+}
+
+int main(int count, String args[])
+{
+    int option;
+    int runs = DEFAULT_RUNS;
+    int warmups = DEFAULT_WARMUPS;
+    double factor = DEFAULT_FACTOR;
+    String budgetPath = NULL;
+
+    while ((option = getopt(count, args, "n:w:b:f:")) != -1)
+    {
+        switch (option)
+        {
+            case 'b':
+                budgetPath = optarg;
+                break;
+            case 'f':
+                factor = atof(optarg);
+                break;
+            case 'n':
+                runs = atoi(optarg);
+                break;
+            case 'w':
+                warmups = atoi(optarg);
+                break;
+            default:
+                fprintf(stderr, EXCEPTION_USAGE);
+                return 1;
+        }
+    }
+
+    if (optind != count - 1 || runs < 1 || warmups < 0 || factor <= 0)
+    {
+        fprintf(stderr, EXCEPTION_USAGE);
+
+        return 1;
+    }
+
+    struct BudgetCollection budgets;
+
+    budget_collection(&budgets);
+
+    if (budgetPath && !read_budgets(budgetPath, &budgets))
+    {
+        finalize_budget_collection(&budgets);
+
+        return 1;
+    }
+
+    FILE* manifest = fopen(args[optind], "r");
+
+    if (!manifest)
+    {
+        finalize_budget_collection(&budgets);
+        fprintf(stderr, EXCEPTION_FORMAT);
+
+        return 1;
+    }
+
+    int failures = 0;
+    char buffer[BUFFER_SIZE];
+
+    printf("target,input,runs,"
+        "wall_min,wall_median,wall_p95,wall_p99,"
+        "cpu_min,cpu_median,cpu_p95,cpu_p99,"
+        "solver_min,solver_median,solver_p95,solver_p99");
+
+    if (budgetPath)
+    {
+        printf(",budget,status");
+    }
+
+    printf("\n");
+
+    while (fgets(buffer, sizeof buffer, manifest))
+    {
+        if (buffer[0] == '#')
+        {
+            continue;
+        }
+
+        String target = strtok(buffer, DELIMITERS);
+
+        if (!target)
+        {
+            continue;
+        }
+
+        String input = strtok(NULL, DELIMITERS);
+
+        if (!input)
+        {
+            fprintf(stderr, EXCEPTION_FORMAT);
+            fclose(manifest);
+            finalize_budget_collection(&budgets);
+
+            return 1;
+        }
+
+        double budget = budget_collection_get(&budgets, target);
+
+        if (budgetPath && budget < 0)
+        {
+            fprintf(stderr, "Warning: %s has no budget.\n", target);
+        }
+
+        failures += measure(
+            target,
+            input,
+            runs,
+            warmups,
+            budgetPath != NULL,
+            budget,
+            factor);
+    }
+
+    fclose(manifest);
+    finalize_budget_collection(&budgets);
+
+    return failures != 0;
+}
@@ -0,0 +1,1517 @@
+// Licensed under the MIT License.
+
+// Synthetic Input Generator
+
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#define DAYS 25
+#define DEFAULT_SEED 2023
+#define DIGIT_WORDS_CAPACITY 9
+#define EXCEPTION_ARGUMENT "Error: Argument out of range.\n"
+#define EXCEPTION_OUT_OF_MEMORY "Error: Out of memory.\n"
+#define EXCEPTION_USAGE "Usage: generate day scale [seed]\n"
+#define NAMES_CAPACITY 17576
+#define SYMBOLS "*#+$/@%=&-"
+
+struct Xorshift
+{
+    unsigned long long state;
+};
+
+typedef char* String;
+typedef struct Xorshift* Xorshift;
+typedef bool (*Generator)(Xorshift random, long scale);
+
+struct GeneratorInfo
+{
+    Generator generator;
+    long minScale;
+    long maxScale;
+};
+
+static const String DIGIT_WORDS[DIGIT_WORDS_CAPACITY] =
+{
+    "one", "two", "three", "four", "five", "six", "seven", "eight", "nine"
+};
+
+static const String MAP_NAMES[] =
+{
+    "seed-to-soil",
+    "soil-to-fertilizer",
+    "fertilizer-to-water",
+    "water-to-light",
+    "light-to-temperature",
+    "temperature-to-humidity",
+    "humidity-to-location"
+};
+
+void xorshift(Xorshift instance, unsigned long long seed)
+{
+    instance->state = seed * 2685821657736338717ull + 1;
+}
+
+unsigned long long xorshift_next(Xorshift instance)
+{
+    unsigned long long x = instance->state;
+
+    x ^= x >> 12;
+    x ^= x << 25;
+    x ^= x >> 27;
+    instance->state = x;
+
+    return x * 2685821657736338717ull;
+}
+
+long long xorshift_range(Xorshift instance, long long min, long long max)
+{
+    unsigned long long range = (unsigned long long)(max - min) + 1;
+
+    return min + (long long)(xorshift_next(instance) % range);
+}
+
+bool xorshift_chance(Xorshift instance, int percent)
+{
+    return xorshift_range(instance, 0, 99) < percent;
+}
+
+static void shuffle(Xorshift random, long items[], long count)
+{
+    for (long i = count - 1; i > 0; i--)
+    {
+        long j = xorshift_range(random, 0, i);
+        long swap = items[i];
+
+        items[i] = items[j];
+        items[j] = swap;
+    }
+}
+
+static long* permutation(Xorshift random, long count)
+{
+    long* result = malloc(count * sizeof * result);
+
+    if (!result)
+    {
+        return NULL;
+    }
+
+    for (long i = 0; i < count; i++)
+    {
+        result[i] = i;
+    }
+
+    shuffle(random, result, count);
+
+    return result;
+}
+
+static void name(long index, char first, char result[])
+{
+    result[0] = first + (index / 676) % 26;
+    result[1] = first + (index / 26) % 26;
+    result[2] = first + index % 26;
+    result[3] = '\0';
+}
+
+static int compare(const void* left, const void* right)
+{
+    long long leftValue = *(const long long*)left;
+    long long rightValue = *(const long long*)right;
+
+    if (leftValue < rightValue)
+    {
+        return -1;
+    }
+
+    if (leftValue > rightValue)
+    {
+        return 1;
+    }
+
+    return 0;
+}
+
+static void print_grid(Xorshift random, long size, String alphabet)
+{
+    int length = strlen(alphabet);
+
+    for (long i = 0; i < size; i++)
+    {
+        for (long j = 0; j < size; j++)
+        {
+            putchar(alphabet[xorshift_range(random, 0, length - 1)]);
+        }
+
+        putchar('\n');
+    }
+}
+
+static bool generate_day01(Xorshift random, long scale)
+{
+    for (long i = 0; i < scale; i++)
+    {
+        bool digit = false;
+        int length = xorshift_range(random, 8, 40);
+
+        for (int j = 0; j < length; j++)
+        {
+            if (xorshift_chance(random, 15))
+            {
+                putchar('1' + xorshift_range(random, 0, 8));
+
+                digit = true;
+
+                continue;
+            }
+
+            if (xorshift_chance(random, 15))
+            {
+                int k = xorshift_range(random, 0, DIGIT_WORDS_CAPACITY - 1);
+
+                fputs(DIGIT_WORDS[k], stdout);
+
+                continue;
+            }
+
+            putchar('a' + xorshift_range(random, 0, 25));
+        }
+
+        if (!digit)
+        {
+            putchar('1' + xorshift_range(random, 0, 8));
+        }
+
+        putchar('\n');
+    }
+
+    return true;
+}
+
+static bool generate_day02(Xorshift random, long scale)
+{
+    const String colors[] = { "red", "green", "blue" };
+
+    for (long i = 0; i < scale; i++)
+    {
+        int sets = xorshift_range(random, 1, 6);
+
+        printf("Game %ld: ", i + 1);
+
+        for (int j = 0; j < sets; j++)
+        {
+            long order[] = { 0, 1, 2 };
+            int cubes = xorshift_range(random, 1, 3);
+
+            shuffle(random, order, 3);
+
+            if (j)
+            {
+                fputs("; ", stdout);
+            }
+
+            for (int k = 0; k < cubes; k++)
+            {
+                if (k)
+                {
+                    fputs(", ", stdout);
+                }
+
+                printf("%d %s", (int)xorshift_range(random, 1, 20),
+                    colors[order[k]]);
+            }
+        }
+
+        putchar('\n');
+    }
+
+    return true;
+}
+
+static bool generate_day03(Xorshift random, long scale)
+{
+    String row = malloc(scale + 1);
+
+    if (!row)
+    {
+        return false;
+    }
+
+    for (long i = 0; i < scale; i++)
+    {
+        long j = 0;
+
+        while (j < scale)
+        {
+            int digits = xorshift_range(random, 1, 3);
+
+            if (j + digits < scale && xorshift_chance(random, 8))
+            {
+                row[j] = '1' + xorshift_range(random, 0, 8);
+
+                for (int k = 1; k < digits; k++)
+                {
+                    row[j + k] = '0' + xorshift_range(random, 0, 9);
+                }
+
+                row[j + digits] = '.';
+                j += digits + 1;
+
+                continue;
+            }
+
+            if (xorshift_chance(random, 6))
+            {
+                row[j] = SYMBOLS[xorshift_range(random, 0, 9)];
+            }
+            else
+            {
+                row[j] = '.';
+            }
+
+            j++;
+        }
+
+        row[scale] = '\0';
+
+        puts(row);
+    }
+
+    free(row);
+
+    return true;
+}
+
+static bool generate_day04(Xorshift random, long scale)
+{
+    long numbers[99];
+    int width = snprintf(NULL, 0, "%ld", scale);
+
+    for (long i = 0; i < scale; i++)
+    {
+        long have[25];
+        long maxMatches = scale - i - 1;
+
+        if (maxMatches > 4)
+        {
+            maxMatches = 4;
+        }
+
+        int matches = 0;
+
+        if (xorshift_chance(random, 25))
+        {
+            matches = xorshift_range(random, 0, maxMatches);
+        }
+
+        for (int j = 0; j < 99; j++)
+        {
+            numbers[j] = j + 1;
+        }
+
+        shuffle(random, numbers, 99);
+        memcpy(have, numbers, matches * sizeof * have);
+        memcpy(have + matches, numbers + 10, (25 - matches) * sizeof * have);
+        shuffle(random, have, 25);
+        printf("Card %*ld:", width, i + 1);
+
+        for (int j = 0; j < 10; j++)
+        {
+            printf(" %2ld", numbers[j]);
+        }
+
+        fputs(" |", stdout);
+
+        for (int j = 0; j < 25; j++)
+        {
+            printf(" %2ld", have[j]);
+        }
+
+        putchar('\n');
+    }
+
+    return true;
+}
+
+static bool generate_day05(Xorshift random, long scale)
+{
+    const long long universe = 4294967296ll;
+    long long* cuts = malloc((scale + 1) * sizeof * cuts);
+    long* order = malloc(scale * sizeof * order);
+
+    if (!cuts || !order)
+    {
+        free(cuts);
+        free(order);
+
+        return false;
+    }
+
+    fputs("seeds:", stdout);
+
+    for (int i = 0; i < 10; i++)
+    {
+        long long length = xorshift_range(random, 1, 400000000);
+        long long offset = xorshift_range(random, 0, universe - length);
+
+        printf(" %lld %lld", offset, length);
+    }
+
+    putchar('\n');
+
+    for (int i = 0; i < 7; i++)
+    {
+        cuts[0] = 0;
+
+        for (long j = 1; j < scale; j++)
+        {
+            cuts[j] = xorshift_range(random, 1, universe - 1);
+        }
+
+        qsort(cuts + 1, scale - 1, sizeof * cuts, compare);
+
+        long count = 1;
+
+        for (long j = 1; j < scale; j++)
+        {
+            if (cuts[j] != cuts[count - 1])
+            {
+                cuts[count] = cuts[j];
+                count++;
+            }
+        }
+
+        cuts[count] = universe;
+
+        for (long j = 0; j < count; j++)
+        {
+            order[j] = j;
+        }
+
+        shuffle(random, order, count);
+        printf("\n%s map:\n", MAP_NAMES[i]);
+
+        long long destination = 0;
+
+        for (long j = 0; j < count; j++)
+        {
+            long k = order[j];
+            long long length = cuts[k + 1] - cuts[k];
+
+            printf("%lld %lld %lld\n", destination, cuts[k], length);
+
+            destination += length;
+        }
+    }
+
+    free(cuts);
+    free(order);
+
+    return true;
+}
+
+static bool generate_day06(Xorshift random, long scale)
+{
+    long* times = malloc(scale * sizeof * times);
+
+    if (!times)
+    {
+        return false;
+    }
+
+    fputs("Time:    ", stdout);
+
+    for (long i = 0; i < scale; i++)
+    {
+        times[i] = xorshift_range(random, 40, 99);
+
+        printf(" %4ld", times[i]);
+    }
+
+    fputs("\nDistance:", stdout);
+
+    for (long i = 0; i < scale; i++)
+    {
+        long max = times[i] * times[i] / 4 - 1;
+
+        if (max > 999)
+        {
+            max = 999;
+        }
+
+        printf(" %4lld", xorshift_range(random, 100, max));
+    }
+
+    putchar('\n');
+    free(times);
+
+    return true;
+}
+
+static bool generate_day07(Xorshift random, long scale)
+{
+    const String cards = "23456789TJQKA";
+
+    for (long i = 0; i < scale; i++)
+    {
+        for (int j = 0; j < 5; j++)
+        {
+            putchar(cards[xorshift_range(random, 0, 12)]);
+        }
+
+        printf(" %d\n", (int)xorshift_range(random, 1, 1000));
+    }
+
+    return true;
+}
+
+static long next_prime(long value)
+{
+    for (;; value++)
+    {
+        bool prime = value > 1;
+
+        for (long d = 2; prime && d * d <= value; d++)
+        {
+            prime = value % d != 0;
+        }
+
+        if (prime)
+        {
+            return value;
+        }
+    }
+}
+
+static bool generate_day08(Xorshift random, long scale)
+{
+    const int ghosts = 6;
+    long periods[6];
+    long directions = 2;
+
+    while (directions * directions * ghosts < scale)
+    {
+        directions++;
+    }
+
+    directions = next_prime(directions);
+
+    long nodes = ghosts;
+    long period = next_prime(scale / (ghosts * directions));
+
+    for (int g = 0; g < ghosts; g++)
+    {
+        if (period == directions)
+        {
+            period = next_prime(period + 1);
+        }
+
+        periods[g] = period;
+        nodes += period * directions;
+        period = next_prime(period + 1);
+    }
+
+    if (nodes - 2 * ghosts > 26 * 26 * 24)
+    {
+        return false;
+    }
+
+    String path = malloc(directions + 1);
+    long* names = malloc(nodes * sizeof * names);
+    long* lefts = malloc(nodes * sizeof * lefts);
+    long* rights = malloc(nodes * sizeof * rights);
+    long* pool = permutation(random, NAMES_CAPACITY);
+    long* prefixes = permutation(random, 26 * 26);
+
+    if (!path || !names || !lefts || !rights || !pool || !prefixes)
+    {
+        free(path);
+        free(names);
+        free(lefts);
+        free(rights);
+        free(pool);
+        free(prefixes);
+
+        return false;
+    }
+
+    for (long i = 0; i < directions; i++)
+    {
+        path[i] = "LR"[xorshift_range(random, 0, 1)];
+    }
+
+    path[directions] = '\0';
+
+    long next = 0;
+    long count = 0;
+    long prefix = 0;
+
+    for (int g = 0; g < ghosts; g++)
+    {
+        long length = periods[g] * directions;
+        long first = count;
+
+        if (g)
+        {
+            while (prefixes[prefix] == 0 || prefixes[prefix] == 26 * 26 - 1)
+            {
+                prefix++;
+            }
+
+            names[first] = prefixes[prefix] * 26;
+            prefix++;
+        }
+        else
+        {
+            names[first] = 0;
+        }
+
+        if (g)
+        {
+            names[first + length] = names[first] + 25;
+        }
+        else
+        {
+            names[first + length] = NAMES_CAPACITY - 1;
+        }
+
+        for (long i = 1; i < length; i++)
+        {
+
+            while (pool[next] % 26 == 0 || pool[next] % 26 == 25)
+            {
+                next++;
+            }
+
+            names[first + i] = pool[next];
+            next++;
+        }
+
+        for (long i = 0; i < length; i++)
+        {
+            long other = first + xorshift_range(random, 0, length - 1);
+
+            if (path[i % directions] == 'L')
+            {
+                lefts[first + i] = first + i + 1;
+                rights[first + i] = other;
+            }
+            else
+            {
+                lefts[first + i] = other;
+                rights[first + i] = first + i + 1;
+            }
+        }
+
+        if (path[0] == 'L')
+        {
+            lefts[first + length] = first + 1;
+            rights[first + length] = rights[first];
+        }
+        else
+        {
+            lefts[first + length] = lefts[first];
+            rights[first + length] = first + 1;
+        }
+
+        count += length + 1;
+    }
+
+    long* order = permutation(random, count);
+
+    if (!order)
+    {
+        free(path);
+        free(names);
+        free(lefts);
+        free(rights);
+        free(pool);
+        free(prefixes);
+
+        return false;
+    }
+
+    printf("%s\n\n", path);
+
+    for (long i = 0; i < count; i++)
+    {
+        char key[4];
+        char left[4];
+        char right[4];
+        long k = order[i];
+
+        name(names[k], 'A', key);
+        name(names[lefts[k]], 'A', left);
+        name(names[rights[k]], 'A', right);
+        printf("%s = (%s, %s)\n", key, left, right);
+    }
+
+    free(path);
+    free(names);
+    free(lefts);
+    free(rights);
+    free(pool);
+    free(prefixes);
+    free(order);
+
+    return true;
+}
+
+static bool generate_day09(Xorshift random, long scale)
+{
+    for (long i = 0; i < scale; i++)
+    {
+        long coefficients[7];
+        int degree = xorshift_range(random, 0, 6);
+
+        coefficients[0] = xorshift_range(random, -20, 20);
+
+        for (int k = 1; k <= degree; k++)
+        {
+            coefficients[k] = xorshift_range(random, -3, 3);
+        }
+
+        for (long x = 0; x <= 20; x++)
+        {
+            long y = 0;
+
+            for (int k = degree; k >= 0; k--)
+            {
+                y = y * x + coefficients[k];
+            }
+
+            if (x)
+            {
+                putchar(' ');
+            }
+
+            printf("%ld", y);
+        }
+
+        putchar('\n');
+    }
+
+    return true;
+}
+
+static char pipe(int from, int to)
+{
+    const String pipes = ".|-LJ7F";
+    int mask = (1 << from) | (1 << to);
+
+    switch (mask)
+    {
+        case 0x3: return pipes[1];
+        case 0xc: return pipes[2];
+        case 0x5: return pipes[3];
+        case 0x9: return pipes[4];
+        case 0xa: return pipes[5];
+        case 0x6: return pipes[6];
+    }
+
+    return pipes[0];
+}
+
+static int direction(long di, long dj)
+{
+    if (di < 0)
+    {
+        return 0;
+    }
+
+    if (di > 0)
+    {
+        return 1;
+    }
+
+    if (dj > 0)
+    {
+        return 2;
+    }
+
+    return 3;
+}
+
+static bool generate_day10(Xorshift random, long scale)
+{
+    long rows = (scale - 2) & ~1l;
+    long columns = scale - 2;
+    long count = rows * columns;
+    long stride = scale + 1;
+    long* is = malloc(count * sizeof * is);
+    long* js = malloc(count * sizeof * js);
+    String grid = malloc(scale * stride);
+
+    if (!is || !js || !grid)
+    {
+        free(is);
+        free(js);
+        free(grid);
+
+        return false;
+    }
+
+    long n = 0;
+
+    for (long j = 1; j <= columns; j++)
+    {
+        is[n] = 1;
+        js[n] = j;
+        n++;
+    }
+
+    for (long i = 2; i <= rows; i++)
+    {
+        for (long k = 0; k < columns - 1; k++)
+        {
+            is[n] = i;
+
+            if (i % 2 == 0)
+            {
+                js[n] = columns - k;
+            }
+            else
+            {
+                js[n] = k + 2;
+            }
+
+            n++;
+        }
+    }
+
+    for (long i = rows; i >= 2; i--)
+    {
+        is[n] = i;
+        js[n] = 1;
+        n++;
+    }
+
+    for (long i = 0; i < scale; i++)
+    {
+        for (long j = 0; j < scale; j++)
+        {
+            grid[i * stride + j] = ".|-LJ7F"[xorshift_range(random, 0, 6)];
+        }
+
+        grid[i * stride + scale] = '\n';
+    }
+
+    for (long k = 0; k < n; k++)
+    {
+        long previous = (k + n - 1) % n;
+        long next = (k + 1) % n;
+        int from = direction(is[previous] - is[k], js[previous] - js[k]);
+        int to = direction(is[next] - is[k], js[next] - js[k]);
+
+        grid[is[k] * stride + js[k]] = pipe(from, to);
+    }
+
+    grid[stride + 1] = 'S';
+    grid[1] = '.';
+    grid[stride] = '.';
+
+    fwrite(grid, 1, scale * stride, stdout);
+    free(is);
+    free(js);
+    free(grid);
+
+    return true;
+}
+
+static bool generate_day11(Xorshift random, long scale)
+{
+    bool* emptyColumns = malloc(scale * sizeof * emptyColumns);
+
+    if (!emptyColumns)
+    {
+        return false;
+    }
+
+    for (long j = 0; j < scale; j++)
+    {
+        emptyColumns[j] = xorshift_chance(random, 10);
+    }
+
+    for (long i = 0; i < scale; i++)
+    {
+        bool emptyRow = xorshift_chance(random, 10);
+
+        for (long j = 0; j < scale; j++)
+        {
+            if (!emptyRow && !emptyColumns[j] && xorshift_chance(random, 2))
+            {
+                putchar('#');
+            }
+            else
+            {
+                putchar('.');
+            }
+        }
+
+        putchar('\n');
+    }
+
+    free(emptyColumns);
+
+    return true;
+}
+
+static bool generate_day12(Xorshift random, long scale)
+{
+    char springs[21];
+
+    for (long i = 0; i < scale; i++)
+    {
+        int length = xorshift_range(random, 5, 20);
+        bool damaged = false;
+
+        for (int j = 0; j < length; j++)
+        {
+            springs[j] = ".#"[xorshift_range(random, 0, 1)];
+            damaged |= springs[j] == '#';
+        }
+
+        if (!damaged)
+        {
+            springs[xorshift_range(random, 0, length - 1)] = '#';
+        }
+
+        for (int j = 0; j < length; j++)
+        {
+            if (xorshift_chance(random, 40))
+            {
+                putchar('?');
+            }
+            else
+            {
+                putchar(springs[j]);
+            }
+        }
+
+        int run = 0;
+        char separator = ' ';
+
+        for (int j = 0; j <= length; j++)
+        {
+            if (j < length && springs[j] == '#')
+            {
+                run++;
+
+                continue;
+            }
+
+            if (run)
+            {
+                printf("%c%d", separator, run);
+
+                separator = ',';
+                run = 0;
+            }
+        }
+
+        putchar('\n');
+    }
+
+    return true;
+}
+
+static bool generate_day13(Xorshift random, long scale)
+{
+    char pattern[17][17];
+
+    for (long p = 0; p < scale; p++)
+    {
+        int rows = xorshift_range(random, 5, 17);
+        int columns = xorshift_range(random, 5, 17);
+        bool horizontal = xorshift_chance(random, 50);
+        int size = columns;
+
+        if (horizontal)
+        {
+            size = rows;
+        }
+
+        int line = xorshift_range(random, 1, size - 1);
+        int width = line;
+
+        if (size - line < width)
+        {
+            width = size - line;
+        }
+
+        for (int i = 0; i < rows; i++)
+        {
+            for (int j = 0; j < columns; j++)
+            {
+                pattern[i][j] = ".#"[xorshift_range(random, 0, 1)];
+            }
+        }
+
+        for (int d = 0; d < width; d++)
+        {
+            for (int k = 0; k < (horizontal ? columns : rows); k++)
+            {
+                if (horizontal)
+                {
+                    pattern[line + d][k] = pattern[line - 1 - d][k];
+                }
+                else
+                {
+                    pattern[k][line + d] = pattern[k][line - 1 - d];
+                }
+            }
+        }
+
+        if (p % 2)
+        {
+            int d = xorshift_range(random, 0, width - 1);
+
+            if (horizontal)
+            {
+                int k = xorshift_range(random, 0, columns - 1);
+
+                pattern[line + d][k] ^= '.' ^ '#';
+            }
+            else
+            {
+                int k = xorshift_range(random, 0, rows - 1);
+
+                pattern[k][line + d] ^= '.' ^ '#';
+            }
+        }
+
+        if (p)
+        {
+            putchar('\n');
+        }
+
+        for (int i = 0; i < rows; i++)
+        {
+            fwrite(pattern[i], 1, columns, stdout);
+            putchar('\n');
+        }
+    }
+
+    return true;
+}
+
+static bool generate_day14(Xorshift random, long scale)
+{
+    print_grid(random, scale, "OO#.......");
+
+    return true;
+}
+
+static bool generate_day15(Xorshift random, long scale)
+{
+    long labels = scale / 10 + 10;
+
+    for (long i = 0; i < scale; i++)
+    {
+        struct Xorshift label;
+
+        xorshift(&label, xorshift_range(random, 0, labels - 1));
+
+        int length = xorshift_range(&label, 1, 6);
+
+        if (i)
+        {
+            putchar(',');
+        }
+
+        for (int j = 0; j < length; j++)
+        {
+            putchar('a' + xorshift_range(&label, 0, 25));
+        }
+
+        if (xorshift_chance(random, 30))
+        {
+            putchar('-');
+        }
+        else
+        {
+            printf("=%d", (int)xorshift_range(random, 1, 9));
+        }
+    }
+
+    putchar('\n');
+
+    return true;
+}
+
+static bool generate_day16(Xorshift random, long scale)
+{
+    print_grid(random, scale, "..................................../\\|-");
+
+    return true;
+}
+
+static bool generate_day17(Xorshift random, long scale)
+{
+    print_grid(random, scale, "123456789");
+
+    return true;
+}
+
+static void print_trench(char direction, long distance, long color)
+{
+    int code = strchr("RDLU", direction) - "RDLU";
+
+    printf("%c %ld (#%05lx%d)\n", direction, distance, color, code);
+}
+
+static void print_trench_split(char direction, long distance, long color)
+{
+    long pieces = (distance + 8) / 9;
+
+    for (long i = 0; i < pieces; i++)
+    {
+        long part = distance / pieces + (i < distance % pieces);
+        long colorPart = color / pieces + (i < color % pieces);
+
+        print_trench(direction, part, colorPart);
+    }
+}
+
+static bool generate_day18(Xorshift random, long scale)
+{
+    long height = 0;
+    long width = 0;
+    long colorHeight = 0;
+    long colorWidth = 0;
+    long max = 0xfffff / scale;
+
+    for (long i = 0; i < scale; i++)
+    {
+        long up = xorshift_range(random, 1, 9);
+        long right = xorshift_range(random, 1, 9);
+        long colorUp = xorshift_range(random, 1, max);
+        long colorRight = xorshift_range(random, 1, max);
+
+        print_trench('U', up, colorUp);
+        print_trench('R', right, colorRight);
+
+        height += up;
+        width += right;
+        colorHeight += colorUp;
+        colorWidth += colorRight;
+    }
+
+    print_trench_split('D', height, colorHeight);
+    print_trench_split('L', width, colorWidth);
+
+    return true;
+}
+
+static bool generate_day19(Xorshift random, long scale)
+{
+    long* pool = permutation(random, NAMES_CAPACITY);
+
+    if (!pool)
+    {
+        return false;
+    }
+
+    long created = 1;
+
+    for (long i = 0; i < scale; i++)
+    {
+        char key[4] = "in";
+        int rules = xorshift_range(random, 1, 3);
+
+        if (i)
+        {
+            name(pool[i], 'a', key);
+        }
+
+        printf("%s{", key);
+
+        for (int j = 0; j <= rules; j++)
+        {
+            char target[4] = "A";
+
+            if (created < scale && (j == 0 || xorshift_chance(random, 80)))
+            {
+                name(pool[created], 'a', target);
+
+                created++;
+            }
+            else if (xorshift_chance(random, 50))
+            {
+                target[0] = 'R';
+            }
+
+            if (j == rules)
+            {
+                printf("%s}\n", target);
+
+                continue;
+            }
+
+            printf("%c%c%d:%s,",
+                "xmas"[xorshift_range(random, 0, 3)],
+                "<>"[xorshift_range(random, 0, 1)],
+                (int)xorshift_range(random, 2, 3999),
+                target);
+        }
+    }
+
+    putchar('\n');
+
+    for (long i = 0; i < scale; i++)
+    {
+        printf("{x=%d,m=%d,a=%d,s=%d}\n",
+            (int)xorshift_range(random, 1, 4000),
+            (int)xorshift_range(random, 1, 4000),
+            (int)xorshift_range(random, 1, 4000),
+            (int)xorshift_range(random, 1, 4000));
+    }
+
+    free(pool);
+
+    return true;
+}
+
+static bool generate_day20(Xorshift random, long scale)
+{
+    const int counters = 4;
+    long* pool = permutation(random, 26 * 26);
+
+    if (!pool)
+    {
+        return false;
+    }
+
+    long next = 0;
+    char names[4][32][3];
+    char hubs[4][3];
+    char inverters[4][3];
+    char sink[3];
+
+    for (int g = 0; g < counters; g++)
+    {
+        for (long i = 0; i < scale + 2; i++)
+        {
+            if (pool[next] == ('r' - 'a') * 26 + ('x' - 'a'))
+            {
+                next++;
+            }
+
+            char* key = names[g][i];
+
+            if (i == scale)
+            {
+                key = hubs[g];
+            }
+            else if (i == scale + 1)
+            {
+                key = inverters[g];
+            }
+
+            key[0] = 'a' + pool[next] / 26;
+            key[1] = 'a' + pool[next] % 26;
+            key[2] = '\0';
+            next++;
+        }
+    }
+
+    if (pool[next] == ('r' - 'a') * 26 + ('x' - 'a'))
+    {
+        next++;
+    }
+
+    sink[0] = 'a' + pool[next] / 26;
+    sink[1] = 'a' + pool[next] % 26;
+    sink[2] = '\0';
+
+    printf("broadcaster -> %s, %s, %s, %s\n",
+        names[0][0], names[1][0], names[2][0], names[3][0]);
+
+    for (int g = 0; g < counters; g++)
+    {
+        long mask = (1l << (scale - 1)) - 1;
+        long period = (mask + 1) |
+            xorshift_range(random, 0, mask) |
+            xorshift_range(random, 0, mask) | 1;
+
+        for (long i = 0; i < scale; i++)
+        {
+            printf("%%%s -> ", names[g][i]);
+
+            if (i + 1 < scale)
+            {
+                printf("%s", names[g][i + 1]);
+
+                if (period >> i & 1)
+                {
+                    fputs(", ", stdout);
+                }
+            }
+
+            if (period >> i & 1)
+            {
+                fputs(hubs[g], stdout);
+            }
+
+            putchar('\n');
+        }
+
+        printf("&%s -> %s", hubs[g], names[g][0]);
+
+        for (long i = 1; i < scale; i++)
+        {
+            if (!(period >> i & 1))
+            {
+                printf(", %s", names[g][i]);
+            }
+        }
+
+        printf(", %s\n&%s -> %s\n", inverters[g], inverters[g], sink);
+    }
+
+    printf("&%s -> rx\n", sink);
+    free(pool);
+
+    return true;
+}
+
+static bool generate_day21(Xorshift random, long scale)
+{
+    String row = malloc(scale + 1);
+
+    if (!row)
+    {
+        return false;
+    }
+
+    for (long i = 0; i < scale; i++)
+    {
+        for (long j = 0; j < scale; j++)
+        {
+            row[j] = "#........."[xorshift_range(random, 0, 9)];
+        }
+
+        if (i == scale / 2)
+        {
+            row[scale / 2] = 'S';
+        }
+
+        row[scale] = '\0';
+
+        puts(row);
+    }
+
+    free(row);
+
+    return true;
+}
+
+static bool generate_day22(Xorshift random, long scale)
+{
+    long* order = permutation(random, scale);
+    long* bricks = malloc(6 * scale * sizeof * bricks);
+
+    if (!order || !bricks)
+    {
+        free(order);
+        free(bricks);
+
+        return false;
+    }
+
+    long z = 1;
+
+    for (long i = 0; i < scale; i++)
+    {
+        long* p = bricks + 6 * i;
+        int axis = xorshift_range(random, 0, 2);
+        int extent = xorshift_range(random, 0, 3);
+
+        z += xorshift_range(random, 0, 2);
+        p[0] = xorshift_range(random, 0, 9);
+        p[1] = xorshift_range(random, 0, 9);
+        p[2] = z;
+        p[3] = p[0];
+        p[4] = p[1];
+        p[5] = p[2];
+
+        if (axis < 2 && p[axis] + extent > 9)
+        {
+            p[axis] -= extent;
+        }
+
+        p[3 + axis] = p[axis] + extent;
+        z = p[5] + 1;
+    }
+
+    for (long i = 0; i < scale; i++)
+    {
+        long* p = bricks + 6 * order[i];
+
+        printf("%ld,%ld,%ld~%ld,%ld,%ld\n", p[0], p[1], p[2], p[3], p[4],
+            p[5]);
+    }
+
+    free(order);
+    free(bricks);
+
+    return true;
+}
+
+static bool generate_day24(Xorshift random, long scale)
+{
+    long long rock[3];
+    long long rockVelocity[3];
+
+    for (int k = 0; k < 3; k++)
+    {
+        rock[k] = xorshift_range(random, 100000000000000ll, 400000000000000ll);
+        rockVelocity[k] = xorshift_range(random, -300, 300);
+    }
+
+    for (long i = 0; i < scale; i++)
+    {
+        long long position[3];
+        long long velocity[3];
+        long long t = xorshift_range(random, 100000000000ll, 500000000000ll);
+
+        for (int k = 0; k < 3; k++)
+        {
+            velocity[k] = xorshift_range(random, -300, 300);
+            position[k] = rock[k] + (rockVelocity[k] - velocity[k]) * t;
+        }
+
+        printf("%lld, %lld, %lld @ %lld, %lld, %lld\n",
+            position[0], position[1], position[2],
+            velocity[0], velocity[1], velocity[2]);
+    }
+
+    return true;
+}
+
+static bool generate_day25(Xorshift random, long scale)
+{
+    long* pool = permutation(random, NAMES_CAPACITY);
+    long* order = permutation(random, scale);
+
+    if (!pool || !order)
+    {
+        free(pool);
+        free(order);
+
+        return false;
+    }
+
+    long sizes[] = { scale / 2, scale - scale / 2 };
+    long first = 0;
+
+    for (int c = 0; c < 2; c++)
+    {
+        long size = sizes[c];
+        long stride = xorshift_range(random, 2, (size - 1) / 2);
+
+        for (long i = 0; i < size; i++)
+        {
+            char key[4];
+            char near[4];
+            char far[4];
+
+            name(pool[order[first + i]], 'a', key);
+            name(pool[order[first + (i + 1) % size]], 'a', near);
+            name(pool[order[first + (i + stride) % size]], 'a', far);
+            printf("%s: %s %s", key, near, far);
+
+            if (c == 0 && i < 3)
+            {
+                char bridge[4];
+
+                name(pool[order[sizes[0] + 2 * i]], 'a', bridge);
+                printf(" %s", bridge);
+            }
+
+            putchar('\n');
+        }
+
+        first += size;
+    }
+
+    free(pool);
+    free(order);
+
+    return true;
+}
+
+// The largest scale of each day is the largest whose answers every solver of
+// that day can represent: beyond it, a sum, product, or square overflows, or a
+// grid has more cells than an `int` can index.
+
+static const struct GeneratorInfo GENERATORS[DAYS] =
+{
+    { generate_day01, 1, 100000000 },
+    { generate_day02, 1, 100000000 },
+    { generate_day03, 2, 100000 },
+    { generate_day04, 1, 100000000 },
+    { generate_day05, 1, 100000000 },
+    { generate_day06, 1, 4 },
+    { generate_day07, 1, 2000000 },
+    { generate_day08, 12, 10000 },
+    { generate_day09, 1, 100000000 },
+    { generate_day10, 5, 46340 },
+    { generate_day11, 1, 3500 },
+    { generate_day12, 1, 100000000 },
+    { generate_day13, 1, 10000000 },
+    { generate_day14, 1, 46340 },
+    { generate_day15, 1, 100000000 },
+    { generate_day16, 1, 23170 },
+    { generate_day17, 1, 46340 },
+    { generate_day18, 1, 0xfffff },
+    { generate_day19, 1, NAMES_CAPACITY },
+    { generate_day20, 2, 15 },
+    { generate_day21, 1, 46340 },
+    { generate_day22, 1, 100000000 },
+    { NULL, 0, 0 },
+    { generate_day24, 1, 65536 },
+    { generate_day25, 14, NAMES_CAPACITY }
+};
+
+int main(int count, String args[])
+{
+    if (count < 3 || count > 4)
+    {
+        fprintf(stderr, EXCEPTION_USAGE);
+
+        return 1;
+    }
+
+    int day = atoi(args[1]);
+    long scale = atol(args[2]);
+    unsigned long long seed = DEFAULT_SEED;
+
+    if (count == 4)
+    {
+        seed = strtoull(args[3], NULL, 10);
+    }
+
+    if (day < 1 || day > DAYS || !GENERATORS[day - 1].generator ||
+        scale < GENERATORS[day - 1].minScale ||
+        scale > GENERATORS[day - 1].maxScale)
+    {
+        fprintf(stderr, EXCEPTION_ARGUMENT);
+
+        return 1;
+    }
+
+    struct Xorshift random;
+
+    xorshift(&random, seed);
+
+    if (!GENERATORS[day - 1].generator(&random, scale))
+    {
+        fprintf(stderr, EXCEPTION_OUT_OF_MEMORY);
+
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,89 @@
+// Licensed under the MIT License.
+
+// Microbenchmarks: Scratchcards Part 1
+
+#include <stdlib.h>
+#include "../../src/day04a.c"
+#include "micro.h"
+#define MICRO_KEY_COUNT 4096
+
+struct MicroDecimalSet
+{
+    struct DecimalSet set;
+    char keys[MICRO_KEY_COUNT][2];
+    int cursor;
+};
+
+typedef struct MicroDecimalSet* MicroDecimalSet;
+
+// Fills the set with `size` of the numbers from 1 to 99, written as they are
+// in the input, with a leading space for numbers below 10.
+
+static void* micro_decimal_set_setup(int size)
+{
+    unsigned long long seed = 1;
+    MicroDecimalSet result = malloc(sizeof * result);
+
+    if (!result)
+    {
+        return NULL;
+    }
+
+    memset(result->set.set, 0, sizeof result->set.set);
+
+    for (int i = 0; i < MICRO_KEY_COUNT; i++)
+    {
+        int value = micro_random(&seed) % DECIMAL_SET_CAPACITY + 1;
+
+        result->keys[i][0] = ' ';
+
+        if (value >= 10)
+        {
+            result->keys[i][0] = '0' + value / 10;
+        }
+
+        result->keys[i][1] = '0' + value % 10;
+
+        if (i < size)
+        {
+            decimal_set_add(&result->set, result->keys[i][0],
+                result->keys[i][1]);
+        }
+    }
+
+    result->cursor = 0;
+
+    return result;
+}
+
+static long long micro_decimal_set_contains(void* state, int count)
+{
+    long long result = 0;
+    MicroDecimalSet instance = state;
+
+    for (int i = 0; i < count; i++)
+    {
+        const char* key = instance->keys[instance->cursor % MICRO_KEY_COUNT];
+
+        result += decimal_set_contains(&instance->set, key[0], key[1]);
+        instance->cursor++;
+    }
+
+    return result;
+}
+
+MicroBenchmark micro_day04a(void)
+{
+    static const struct MicroBenchmark result[] =
+    {
+        {
+            "DecimalSet", "contains", DECIMAL_SET_CAPACITY,
+            micro_decimal_set_setup,
+            micro_decimal_set_contains,
+            free
+        },
+        { NULL, NULL, 0, NULL, NULL, NULL }
+    };
+
+    return result;
+}
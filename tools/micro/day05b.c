@@ -0,0 +1,76 @@
+// Licensed under the MIT License.
+
+// Microbenchmarks: If You Give A Seed A Fertilizer Part 2
+
+#include "../../src/day05b.c"
+#include "micro.h"
+
+struct MicroIntervalList
+{
+    struct IntervalList list;
+    int size;
+};
+
+typedef struct MicroIntervalList* MicroIntervalList;
+
+static void* micro_interval_list_setup(int size)
+{
+    MicroIntervalList result = malloc(sizeof * result);
+
+    if (!result)
+    {
+        return NULL;
+    }
+
+    interval_list(&result->list);
+
+    result->size = size;
+
+    return result;
+}
+
+// Adds intervals, emptying the list after every `size` of them.
+
+static long long micro_interval_list_add(void* state, int count)
+{
+    long long result = 0;
+    MicroIntervalList instance = state;
+
+    for (int i = 0; i < count; i++)
+    {
+        struct Interval item = { i, i + instance->size };
+
+        if (instance->list.count == instance->size)
+        {
+            instance->list.count = 0;
+        }
+
+        result += interval_list_add(&instance->list, &item);
+    }
+
+    return result;
+}
+
+static void micro_interval_list_finalize(void* state)
+{
+    MicroIntervalList instance = state;
+
+    finalize_interval_list(&instance->list);
+    free(instance);
+}
+
+MicroBenchmark micro_day05b(void)
+{
+    static const struct MicroBenchmark result[] =
+    {
+        {
+            "IntervalList", "add", INT_MAX,
+            micro_interval_list_setup,
+            micro_interval_list_add,
+            micro_interval_list_finalize
+        },
+        { NULL, NULL, 0, NULL, NULL, NULL }
+    };
+
+    return result;
+}
@@ -0,0 +1,85 @@
+// Licensed under the MIT License.
+
+// Microbenchmarks: Hot Springs Part 2
+
+#include <limits.h>
+#include "../../src/day12b.c"
+#include "micro.h"
+#define MICRO_KEY_COUNT 4096
+
+struct MicroDictionary
+{
+    struct Dictionary dictionary;
+    int keys[MICRO_KEY_COUNT];
+    int cursor;
+};
+
+typedef struct MicroDictionary* MicroDictionary;
+
+static void* micro_dictionary_setup(int size)
+{
+    unsigned long long seed = 1;
+    MicroDictionary result = malloc(sizeof * result);
+
+    if (!result)
+    {
+        return NULL;
+    }
+
+    dictionary(&result->dictionary);
+
+    if (!dictionary_reset(&result->dictionary, size))
+    {
+        free(result);
+
+        return NULL;
+    }
+
+    for (int i = 0; i < MICRO_KEY_COUNT; i++)
+    {
+        result->keys[i] = micro_random(&seed) % size;
+    }
+
+    result->cursor = 0;
+
+    return result;
+}
+
+static long long micro_dictionary_increment(void* state, int count)
+{
+    MicroDictionary instance = state;
+
+    for (int i = 0; i < count; i++)
+    {
+        int key = instance->keys[instance->cursor % MICRO_KEY_COUNT];
+
+        dictionary_increment(&instance->dictionary, key, 1);
+        instance->cursor++;
+    }
+
+    return instance->dictionary.first->value;
+}
+
+static void micro_dictionary_finalize(void* state)
+{
+    MicroDictionary instance = state;
+
+    finalize_dictionary(&instance->dictionary);
+    free(instance);
+}
+
+MicroBenchmark micro_day12b(void)
+{
+    static const struct MicroBenchmark result[] =
+    {
+        {
+            "Dictionary", "increment", INT_MAX,
+            micro_dictionary_setup,
+            micro_dictionary_increment,
+            micro_dictionary_finalize
+        },
+        { NULL, NULL, 0, NULL, NULL, NULL }
+    };
+
+    return result;
+}
@@ -0,0 +1,60 @@
+// Licensed under the MIT License.
+
+// Microbenchmarks: Point of Incidence Part 1
+
+#include <limits.h>
+#include <stdlib.h>
+#include "../../src/day13a.c"
+#include "micro.h"
+
+// Builds a pattern of `size` distinct rows whose only line of reflection lies
+// after the last two rows, so that every candidate line is examined.
+
+static void* micro_bit_matrix_setup(int size)
+{
+    BitMatrix result = malloc(DIMENSION * sizeof * result);
+
+    if (!result)
+    {
+        return NULL;
+    }
+
+    bit_matrix_clear(result);
+
+    for (int i = 0; i < size - 1; i++)
+    {
+        result[i] = i + 1;
+    }
+
+    result[size - 1] = result[size - 2];
+
+    return result;
+}
+
+static long long micro_bit_matrix_realize(void* state, int count)
+{
+    long long result = 0;
+
+    for (int i = 0; i < count; i++)
+    {
+        result += realize(state);
+    }
+
+    return result;
+}
+
+MicroBenchmark micro_day13a(void)
+{
+    static const struct MicroBenchmark result[] =
+    {
+        {
+            "BitMatrix", "realize", DIMENSION - 1,
+            micro_bit_matrix_setup,
+            micro_bit_matrix_realize,
+            free
+        },
+        { NULL, NULL, 0, NULL, NULL, NULL }
+    };
+
+    return result;
+}
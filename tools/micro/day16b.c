@@ -0,0 +1,75 @@
+// Licensed under the MIT License.
+
+// Microbenchmarks: The Floor Will Be Lava Part 2
+
+#include <limits.h>
+#include "../../src/day16b.c"
+#include "micro.h"
+
+static void* micro_coordinate_stack_setup(int size)
+{
+    CoordinateStack result = malloc(sizeof * result);
+
+    if (!result)
+    {
+        return NULL;
+    }
+
+    coordinate_stack(result);
+
+    for (int i = 0; i < size; i++)
+    {
+        struct Coordinate item = { i, i, DIRECTION_NONE };
+
+        if (!coordinate_stack_push(result, &item))
+        {
+            finalize_coordinate_stack(result);
+            free(result);
+
+            return NULL;
+        }
+    }
+
+    return result;
+}
+
+// Pops an item and pushes it again, so the size is unchanged.
+
+static long long micro_coordinate_stack_run(void* state, int count)
+{
+    long long result = 0;
+    struct Coordinate item;
+
+    for (int i = 0; i < count; i++)
+    {
+        coordinate_stack_try_pop(state, &item);
+
+        result += item.i;
+
+        coordinate_stack_push(state, &item);
+    }
+
+    return result;
+}
+
+static void micro_coordinate_stack_finalize(void* state)
+{
+    finalize_coordinate_stack(state);
+    free(state);
+}
+
+MicroBenchmark micro_day16b(void)
+{
+    static const struct MicroBenchmark result[] =
+    {
+        {
+            "CoordinateStack", "pop_push", INT_MAX,
+            micro_coordinate_stack_setup,
+            micro_coordinate_stack_run,
+            micro_coordinate_stack_finalize
+        },
+        { NULL, NULL, 0, NULL, NULL, NULL }
+    };
+
+    return result;
+}
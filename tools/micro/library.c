@@ -0,0 +1,289 @@
+// Licensed under the MIT License.
+
+// Microbenchmarks: Support Library
+
+#include <limits.h>
+#include <stdlib.h>
+#include "../../lib/arena.h"
+#include "../../lib/hash_table.h"
+#include "../../lib/queue.h"
+#include "micro.h"
+#define ARENA_BLOCK_SIZE 65536
+#define ARENA_ITEM_SIZE 24
+#define KEY_COUNT 4096
+#define QUEUE_BATCH_SIZE 16
+
+struct MicroHashTable
+{
+    struct HashTable table;
+    int keys[KEY_COUNT];
+    int cursor;
+    int size;
+};
+
+struct MicroArena
+{
+    struct Arena arena;
+    int count;
+    int size;
+};
+
+struct MicroQueue
+{
+    struct Queue queue;
+    int batch[QUEUE_BATCH_SIZE];
+};
+
+typedef struct MicroHashTable* MicroHashTable;
+typedef struct MicroArena* MicroArena;
+typedef struct MicroQueue* MicroQueue;
+
+static void* micro_hash_table_setup(int size)
+{
+    unsigned long long seed = 1;
+    MicroHashTable result = malloc(sizeof * result);
+
+    if (!result)
+    {
+        return NULL;
+    }
+
+    hash_table(&result->table, sizeof(int), sizeof(int), NULL, NULL);
+
+    for (int i = 0; i < size; i++)
+    {
+        int* value = hash_table_add(&result->table, &i, NULL);
+
+        if (!value)
+        {
+            finalize_hash_table(&result->table);
+            free(result);
+
+            return NULL;
+        }
+
+        *value = i;
+    }
+
+    for (int i = 0; i < KEY_COUNT; i++)
+    {
+        result->keys[i] = micro_random(&seed) % size;
+    }
+
+    result->cursor = 0;
+    result->size = size;
+
+    return result;
+}
+
+static long long micro_hash_table_get(void* state, int count)
+{
+    long long result = 0;
+    MicroHashTable instance = state;
+
+    for (int i = 0; i < count; i++)
+    {
+        int key = instance->keys[instance->cursor % KEY_COUNT];
+
+        result += *(int*)hash_table_get(&instance->table, &key);
+        instance->cursor++;
+    }
+
+    return result;
+}
+
+// Adds a key that is absent and removes it again, so the size is unchanged.
+
+static long long micro_hash_table_add_remove(void* state, int count)
+{
+    long long result = 0;
+    MicroHashTable instance = state;
+
+    for (int i = 0; i < count; i++)
+    {
+        int key = instance->size + instance->keys[instance->cursor % KEY_COUNT];
+
+        result += hash_table_add(&instance->table, &key, NULL) != NULL;
+        result += hash_table_remove(&instance->table, &key);
+        instance->cursor++;
+    }
+
+    return result;
+}
+
+static void micro_hash_table_finalize(void* state)
+{
+    MicroHashTable instance = state;
+
+    finalize_hash_table(&instance->table);
+    free(instance);
+}
+
+static void* micro_arena_setup(int size)
+{
+    MicroArena result = malloc(sizeof * result);
+
+    if (!result)
+    {
+        return NULL;
+    }
+
+    arena(&result->arena, ARENA_BLOCK_SIZE);
+
+    result->count = 0;
+    result->size = size;
+
+    return result;
+}
+
+// Allocates small objects, resetting the arena after every `size` of them.
+
+static long long micro_arena_allocate(void* state, int count)
+{
+    long long result = 0;
+    MicroArena instance = state;
+
+    for (int i = 0; i < count; i++)
+    {
+        if (instance->count == instance->size)
+        {
+            arena_reset(&instance->arena);
+
+            instance->count = 0;
+        }
+
+        result += arena_allocate(&instance->arena, ARENA_ITEM_SIZE) != NULL;
+        instance->count++;
+    }
+
+    return result;
+}
+
+static void micro_arena_finalize(void* state)
+{
+    MicroArena instance = state;
+
+    finalize_arena(&instance->arena);
+    free(instance);
+}
+
+static void* micro_queue_setup(int size)
+{
+    MicroQueue result = malloc(sizeof * result);
+
+    if (!result)
+    {
+        return NULL;
+    }
+
+    queue(&result->queue, sizeof(int));
+
+    for (int i = 0; i < size; i++)
+    {
+        int* item = queue_enqueue(&result->queue);
+
+        if (!item)
+        {
+            finalize_queue(&result->queue);
+            free(result);
+
+            return NULL;
+        }
+
+        *item = i;
+    }
+
+    return result;
+}
+
+// Dequeues an item and enqueues it again, so the size is unchanged.
+
+static long long micro_queue_dequeue_enqueue(void* state, int count)
+{
+    long long result = 0;
+    MicroQueue instance = state;
+
+    for (int i = 0; i < count; i++)
+    {
+        int item = *(int*)queue_dequeue(&instance->queue);
+
+        result += item;
+        *(int*)queue_enqueue(&instance->queue) = item;
+    }
+
+    return result;
+}
+
+// Moves items from the front to the back in batches, counting each item as
+// one operation.
+
+static long long micro_queue_dequeue_enqueue_many(void* state, int count)
+{
+    long long result = 0;
+    MicroQueue instance = state;
+
+    for (int i = 0; i < count; i += QUEUE_BATCH_SIZE)
+    {
+        int batch = count - i;
+
+        if (batch > QUEUE_BATCH_SIZE)
+        {
+            batch = QUEUE_BATCH_SIZE;
+        }
+
+        batch = queue_dequeue_many(&instance->queue, instance->batch, batch);
+        result += instance->batch[0];
+
+        queue_enqueue_many(&instance->queue, instance->batch, batch);
+    }
+
+    return result;
+}
+
+static void micro_queue_finalize(void* state)
+{
+    MicroQueue instance = state;
+
+    finalize_queue(&instance->queue);
+    free(instance);
+}
+
+MicroBenchmark micro_library(void)
+{
+    static const struct MicroBenchmark result[] =
+    {
+        {
+            "HashTable", "get", INT_MAX,
+            micro_hash_table_setup,
+            micro_hash_table_get,
+            micro_hash_table_finalize
+        },
+        {
+            "HashTable", "add_remove", INT_MAX,
+            micro_hash_table_setup,
+            micro_hash_table_add_remove,
+            micro_hash_table_finalize
+        },
+        {
+            "Arena", "allocate", INT_MAX,
+            micro_arena_setup,
+            micro_arena_allocate,
+            micro_arena_finalize
+        },
+        {
+            "Queue", "dequeue_enqueue", INT_MAX,
+            micro_queue_setup,
+            micro_queue_dequeue_enqueue,
+            micro_queue_finalize
+        },
+        {
+            "Queue", "dequeue_enqueue_many", INT_MAX,
+            micro_queue_setup,
+            micro_queue_dequeue_enqueue_many,
+            micro_queue_finalize
+        },
+        { NULL, NULL, 0, NULL, NULL, NULL }
+    };
+
+    return result;
+}
@@ -0,0 +1,197 @@
+// Licensed under the MIT License.
+
+// Microbenchmark Driver
+
+#define _POSIX_C_SOURCE 200809L
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include "micro.h"
+#define BATCH_SIZE 1024
+#define DEFAULT_SAMPLES 200
+#define ERROR_OUT_OF_MEMORY "Error: Out of memory.\n"
+#define ERROR_USAGE "Usage: micro [-n samples] [container]\n"
+
+typedef const void* Object;
+typedef MicroBenchmark (*MicroSuite)(void);
+
+static const int SIZES[] = { 64, 4096, 262144 };
+
+static const MicroSuite SUITES[] =
+{
+    micro_library,
+    micro_day04a,
+    micro_day05b,
+    micro_day12b,
+    micro_day13a,
+    micro_day16b
+};
+
+static volatile long long microSink;
+
+unsigned int micro_random(unsigned long long* state)
+{
+    *state ^= *state << 13;
+    *state ^= *state >> 7;
+    *state ^= *state << 17;
+
+    return *state >> 32;
+}
+
+static int compare(Object left, Object right)
+{
+    double leftValue = *(const double*)left;
+    double rightValue = *(const double*)right;
+
+    if (leftValue < rightValue)
+    {
+        return -1;
+    }
+
+    if (leftValue > rightValue)
+    {
+        return 1;
+    }
+
+    return 0;
+}
+
+static double percentile(double sorted[], int count, int percent)
+{
+    int rank = (percent * count + 99) / 100;
+
+    if (rank < 1)
+    {
+        rank = 1;
+    }
+
+    return sorted[rank - 1];
+}
+
+static double wall_time(void)
+{
+    struct timespec value;
+
+    if (clock_gettime(CLOCK_MONOTONIC, &value) == -1)
+    {
+        return 0;
+    }
+
+    return value.tv_sec + value.tv_nsec / 1e9;
+}
+
+// Times `samples` batches of operations after one batch of warm-up. The
+// latency of each batch is divided by its size, so the distribution is of the
+// mean latency per operation over each batch.
+
+static int measure(MicroBenchmark benchmark, int size, int samples)
+{
+    void* state = benchmark->setup(size);
+    double* latencies = malloc(samples * sizeof * latencies);
+
+    if (!state || !latencies)
+    {
+        if (state)
+        {
+            benchmark->finalize(state);
+        }
+
+        free(latencies);
+        fprintf(stderr, ERROR_OUT_OF_MEMORY);
+
+        return 1;
+    }
+
+    double total = 0;
+    long long checksum = benchmark->run(state, BATCH_SIZE);
+
+    for (int i = 0; i < samples; i++)
+    {
+        double start = wall_time();
+
+        checksum += benchmark->run(state, BATCH_SIZE);
+
+        double elapsed = wall_time() - start;
+
+        latencies[i] = elapsed * 1e9 / BATCH_SIZE;
+        total += elapsed;
+    }
+
+    microSink = checksum;
+
+    qsort(latencies, samples, sizeof * latencies, compare);
+    printf("%s,%s,%d,%d,%lf,%lf,%lf,%lf,%lf\n",
+        benchmark->container,
+        benchmark->operation,
+        size,
+        samples * BATCH_SIZE,
+        samples * BATCH_SIZE / total,
+        percentile(latencies, samples, 50),
+        percentile(latencies, samples, 90),
+        percentile(latencies, samples, 99),
+        latencies[samples - 1]);
+    benchmark->finalize(state);
+    free(latencies);
+
+    return 0;
+}
+
+int main(int count, char* args[])
+{
+    int option;
+    int samples = DEFAULT_SAMPLES;
+
+    while ((option = getopt(count, args, "n:")) != -1)
+    {
+        switch (option)
+        {
+            case 'n':
+                samples = atoi(optarg);
+                break;
+            default:
+                fprintf(stderr, ERROR_USAGE);
+                return 1;
+        }
+    }
+
+    if (optind < count - 1 || samples < 1)
+    {
+        fprintf(stderr, ERROR_USAGE);
+
+        return 1;
+    }
+
+    const char* filter = NULL;
+
+    if (optind < count)
+    {
+        filter = args[optind];
+    }
+
+    int failures = 0;
+    int suites = sizeof SUITES / sizeof * SUITES;
+    int sizes = sizeof SIZES / sizeof * SIZES;
+
+    printf("container,operation,size,operations,throughput,"
+        "latency_p50,latency_p90,latency_p99,latency_max\n");
+
+    for (int i = 0; i < suites; i++)
+    {
+        for (MicroBenchmark p = SUITES[i](); p->container; p++)
+        {
+            if (filter && strcmp(filter, p->container) != 0)
+            {
+                continue;
+            }
+
+            for (int j = 0; j < sizes && SIZES[j] <= p->maxSize; j++)
+            {
+                failures += measure(p, SIZES[j], samples);
+            }
+        }
+    }
+
+    return failures != 0;
+}
@@ -0,0 +1,49 @@
+// Licensed under the MIT License.
+
+// Microbenchmarks
+
+#ifndef MICRO_H
+#define MICRO_H
+
+// Builds a container holding `size` elements. Returns NULL if memory is
+// exhausted.
+
+typedef void* (*MicroSetup)(int size);
+
+// Performs `count` operations on the container. Returns a value derived from
+// their results, so that the operations cannot be optimized away.
+
+typedef long long (*MicroRun)(void* state, int count);
+typedef void (*MicroFinalize)(void* state);
+
+// One operation on one container, measured at every size up to `maxSize`.
+
+struct MicroBenchmark
+{
+    const char* container;
+    const char* operation;
+    int maxSize;
+    MicroSetup setup;
+    MicroRun run;
+    MicroFinalize finalize;
+};
+
+typedef const struct MicroBenchmark* MicroBenchmark;
+
+// Returns a pseudorandom number and advances the state, which must not be
+// zero.
+
+unsigned int micro_random(unsigned long long* state);
+
+// Each solver is compiled together with a file that benchmarks its containers
+// and exports only the function below that is named after it. Each function
+// returns an array terminated by an entry whose container is NULL.
+
+MicroBenchmark micro_library(void);
+MicroBenchmark micro_day04a(void);
+MicroBenchmark micro_day05b(void);
+MicroBenchmark micro_day12b(void);
+MicroBenchmark micro_day13a(void);
+MicroBenchmark micro_day16b(void);
+
+#endif
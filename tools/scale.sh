@@ -0,0 +1,22 @@
+directory=scale
+manifest=${directory}/bench.txt
+
+mkdir -p ${directory}
+: > ${manifest}
+
+grep -v '^#' tools/scale.txt | while read day targets scales;
+do
+    for scale in ${scales};
+    do
+        input=${directory}/${day}-${scale}.txt
+
+        ./generate.o ${day} ${scale} > ${input} || exit 1
+
+        for target in ${targets//,/ };
+        do
+            echo "${target} ${input}" >> ${manifest}
+        done
+    done
+done
+
+./bench.o -n ${SCALE_RUNS:-5} -w 1 ${manifest}
@@ -0,0 +1,556 @@
+// Licensed under the MIT License.
+
+// Suite Driver
+
+#define _POSIX_C_SOURCE 200809L
+#include <pthread.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include "../lib/input.h"
+#include "../lib/solver.h"
+#include "../lib/workspace.h"
+#define BUFFER_SIZE 256
+#define COLLECTION_INITIAL_CAPACITY 64
+#define DELIMITERS " \t\n"
+#define ERROR_USAGE "Usage: suite [-j threads] manifest\n"
+
+// Each solver is compiled with its `solve` function renamed after its target
+// and every other global symbol made local, so that all of them can be linked
+// into this program.
+
+Exception day01a_solve(const char* input, size_t length, long long* result);
+Exception day01b_solve(const char* input, size_t length, long long* result);
+Exception day02a_solve(const char* input, size_t length, long long* result);
+Exception day02b_solve(const char* input, size_t length, long long* result);
+Exception day03a_solve(const char* input, size_t length, long long* result);
+Exception day03b_solve(const char* input, size_t length, long long* result);
+Exception day04a_solve(const char* input, size_t length, long long* result);
+Exception day04b_solve(const char* input, size_t length, long long* result);
+Exception day05a_solve(const char* input, size_t length, long long* result);
+Exception day05b_solve(const char* input, size_t length, long long* result);
+Exception day06a_solve(const char* input, size_t length, long long* result);
+Exception day06b_solve(const char* input, size_t length, long long* result);
+Exception day07a_solve(const char* input, size_t length, long long* result);
+Exception day07b_solve(const char* input, size_t length, long long* result);
+Exception day08a_solve(const char* input, size_t length, long long* result);
+Exception day08b_solve(const char* input, size_t length, long long* result);
+Exception day09a_solve(const char* input, size_t length, long long* result);
+Exception day09b_solve(const char* input, size_t length, long long* result);
+Exception day10a_solve(const char* input, size_t length, long long* result);
+Exception day11a_solve(const char* input, size_t length, long long* result);
+Exception day11b_solve(const char* input, size_t length, long long* result);
+Exception day12a_solve(const char* input, size_t length, long long* result);
+Exception day12b_solve(const char* input, size_t length, long long* result);
+Exception day13a_solve(const char* input, size_t length, long long* result);
+Exception day13b_solve(const char* input, size_t length, long long* result);
+Exception day14a_solve(const char* input, size_t length, long long* result);
+Exception day14b_solve(const char* input, size_t length, long long* result);
+Exception day15a_solve(const char* input, size_t length, long long* result);
+Exception day15b_solve(const char* input, size_t length, long long* result);
+Exception day16a_solve(const char* input, size_t length, long long* result);
+Exception day16b_solve(const char* input, size_t length, long long* result);
+Exception day17a_solve(const char* input, size_t length, long long* result);
+Exception day17b_solve(const char* input, size_t length, long long* result);
+Exception day18a_solve(const char* input, size_t length, long long* result);
+Exception day18b_solve(const char* input, size_t length, long long* result);
+Exception day19a_solve(const char* input, size_t length, long long* result);
+Exception day19b_solve(const char* input, size_t length, long long* result);
+Exception day20a_solve(const char* input, size_t length, long long* result);
+Exception day20b_solve(const char* input, size_t length, long long* result);
+Exception day21a_solve(const char* input, size_t length, long long* result);
+Exception day22a_solve(const char* input, size_t length, long long* result);
+Exception day22b_solve(const char* input, size_t length, long long* result);
+Exception day24a_solve(const char* input, size_t length, long long* result);
+Exception day24b_solve(const char* input, size_t length, long long* result);
+Exception day25z_solve(const char* input, size_t length, long long* result);
+
+struct Solution
+{
+    const char* name;
+    Solver solver;
+};
+
+struct Source
+{
+    char* path;
+    struct Input input;
+};
+
+struct SourceCollection
+{
+    struct Source* items;
+    int count;
+    int capacity;
+};
+
+struct Job
+{
+    const struct Solution* solution;
+    int source;
+    Exception exception;
+    long long result;
+    double wall;
+};
+
+struct JobCollection
+{
+    struct Job* items;
+    int count;
+    int capacity;
+};
+
+struct Pool
+{
+    struct JobCollection* jobs;
+    struct SourceCollection* sources;
+    pthread_mutex_t mutex;
+    int next;
+};
+
+typedef char* String;
+typedef const struct Solution* Solution;
+typedef struct Source* Source;
+typedef struct SourceCollection* SourceCollection;
+typedef struct Job* Job;
+typedef struct JobCollection* JobCollection;
+typedef struct Pool* Pool;
+
+static const struct Solution SOLUTIONS[] =
+{
+    { "day01a", day01a_solve },
+    { "day01b", day01b_solve },
+    { "day02a", day02a_solve },
+    { "day02b", day02b_solve },
+    { "day03a", day03a_solve },
+    { "day03b", day03b_solve },
+    { "day04a", day04a_solve },
+    { "day04b", day04b_solve },
+    { "day05a", day05a_solve },
+    { "day05b", day05b_solve },
+    { "day06a", day06a_solve },
+    { "day06b", day06b_solve },
+    { "day07a", day07a_solve },
+    { "day07b", day07b_solve },
+    { "day08a", day08a_solve },
+    { "day08b", day08b_solve },
+    { "day09a", day09a_solve },
+    { "day09b", day09b_solve },
+    { "day10a", day10a_solve },
+    { "day11a", day11a_solve },
+    { "day11b", day11b_solve },
+    { "day12a", day12a_solve },
+    { "day12b", day12b_solve },
+    { "day13a", day13a_solve },
+    { "day13b", day13b_solve },
+    { "day14a", day14a_solve },
+    { "day14b", day14b_solve },
+    { "day15a", day15a_solve },
+    { "day15b", day15b_solve },
+    { "day16a", day16a_solve },
+    { "day16b", day16b_solve },
+    { "day17a", day17a_solve },
+    { "day17b", day17b_solve },
+    { "day18a", day18a_solve },
+    { "day18b", day18b_solve },
+    { "day19a", day19a_solve },
+    { "day19b", day19b_solve },
+    { "day20a", day20a_solve },
+    { "day20b", day20b_solve },
+    { "day21a", day21a_solve },
+    { "day22a", day22a_solve },
+    { "day22b", day22b_solve },
+    { "day24a", day24a_solve },
+    { "day24b", day24b_solve },
+    { "day25z", day25z_solve },
+};
+
+static double wall_time(void)
+{
+    struct timespec value;
+
+    if (clock_gettime(CLOCK_MONOTONIC, &value) == -1)
+    {
+        return 0;
+    }
+
+    return value.tv_sec + value.tv_nsec / 1e9;
+}
+
+static Solution find_solution(String name)
+{
+    int count = sizeof SOLUTIONS / sizeof * SOLUTIONS;
+
+    for (int i = 0; i < count; i++)
+    {
+        if (strcmp(SOLUTIONS[i].name, name) == 0)
+        {
+            return SOLUTIONS + i;
+        }
+    }
+
+    return NULL;
+}
+
+static void source_collection(SourceCollection instance)
+{
+    instance->items = NULL;
+    instance->count = 0;
+    instance->capacity = 0;
+}
+
+// Returns the index of the source with the given path, reading the file into
+// memory the first time the path is seen. Returns -1 on failure.
+
+static int source_collection_load(
+    SourceCollection instance,
+    String path,
+    Exception* exception)
+{
+    for (int i = 0; i < instance->count; i++)
+    {
+        if (strcmp(instance->items[i].path, path) == 0)
+        {
+            return i;
+        }
+    }
+
+    if (instance->count == instance->capacity)
+    {
+        int newCapacity = instance->capacity * 2;
+
+        if (!newCapacity)
+        {
+            newCapacity = COLLECTION_INITIAL_CAPACITY;
+        }
+
+        Source newItems = realloc(
+            instance->items,
+            newCapacity * sizeof * newItems);
+
+        if (!newItems)
+        {
+            *exception = EXCEPTION_OUT_OF_MEMORY;
+
+            return -1;
+        }
+
+        instance->items = newItems;
+        instance->capacity = newCapacity;
+    }
+
+    Source source = instance->items + instance->count;
+
+    source->path = malloc(strlen(path) + 1);
+
+    if (!source->path)
+    {
+        *exception = EXCEPTION_OUT_OF_MEMORY;
+
+        return -1;
+    }
+
+    strcpy(source->path, path);
+
+    *exception = input_open(&source->input, path);
+
+    if (*exception)
+    {
+        free(source->path);
+
+        return -1;
+    }
+
+    instance->count++;
+
+    return instance->count - 1;
+}
+
+static void finalize_source_collection(SourceCollection instance)
+{
+    for (Source p = instance->items; p < instance->items + instance->count; p++)
+    {
+        free(p->path);
+        finalize_input(&p->input);
+    }
+
+    free(instance->items);
+}
+
+static void job_collection(JobCollection instance)
+{
+    instance->items = NULL;
+    instance->count = 0;
+    instance->capacity = 0;
+}
+
+static bool job_collection_add(
+    JobCollection instance,
+    Solution solution,
+    int source)
+{
+    if (instance->count == instance->capacity)
+    {
+        int newCapacity = instance->capacity * 2;
+
+        if (!newCapacity)
+        {
+            newCapacity = COLLECTION_INITIAL_CAPACITY;
+        }
+
+        Job newItems = realloc(
+            instance->items,
+            newCapacity * sizeof * newItems);
+
+        if (!newItems)
+        {
+            return false;
+        }
+
+        instance->items = newItems;
+        instance->capacity = newCapacity;
+    }
+
+    Job job = instance->items + instance->count;
+
+    job->solution = solution;
+    job->source = source;
+    job->exception = EXCEPTION_NONE;
+    job->result = 0;
+    job->wall = 0;
+    instance->count++;
+
+    return true;
+}
+
+static void finalize_job_collection(JobCollection instance)
+{
+    free(instance->items);
+}
+
+static void* work(void* argument)
+{
+    Pool pool = argument;
+
+    for (;;)
+    {
+        pthread_mutex_lock(&pool->mutex);
+
+        int index = pool->next;
+
+        pool->next++;
+
+        pthread_mutex_unlock(&pool->mutex);
+
+        if (index >= pool->jobs->count)
+        {
+            return NULL;
+        }
+
+        Job job = pool->jobs->items + index;
+        Input input = &pool->sources->items[job->source].input;
+        double start = wall_time();
+
+        job->exception = job->solution->solver(
+            input->buffer,
+            input->length,
+            &job->result);
+        job->wall = wall_time() - start;
+    }
+}
+
+static int read_manifest(
+    FILE* manifest,
+    JobCollection jobs,
+    SourceCollection sources)
+{
+    char buffer[BUFFER_SIZE];
+
+    while (fgets(buffer, sizeof buffer, manifest))
+    {
+        if (buffer[0] == '#')
+        {
+            continue;
+        }
+
+        String target = strtok(buffer, DELIMITERS);
+
+        if (!target)
+        {
+            continue;
+        }
+
+        String path = strtok(NULL, DELIMITERS);
+
+        if (!path)
+        {
+            fprintf(stderr, "%s", exception_message(EXCEPTION_FORMAT));
+
+            return 1;
+        }
+
+        Solution solution = find_solution(target);
+
+        if (!solution)
+        {
+            fprintf(stderr, "Error: Unknown target %s.\n", target);
+
+            return 1;
+        }
+
+        Exception exception;
+        int source = source_collection_load(sources, path, &exception);
+
+        if (source == -1)
+        {
+            if (exception == EXCEPTION_OUT_OF_MEMORY)
+            {
+                fprintf(stderr, "%s", exception_message(exception));
+            }
+            else
+            {
+                fprintf(stderr, "Error: Could not read %s.\n", path);
+            }
+
+            return 1;
+        }
+
+        if (!job_collection_add(jobs, solution, source))
+        {
+            fprintf(stderr, "%s", exception_message(EXCEPTION_OUT_OF_MEMORY));
+
+            return 1;
+        }
+    }
+
+    return 0;
+}
+
+static void run(Pool pool, int threads)
+{
+    pthread_t* workers = malloc(threads * sizeof * workers);
+    int started = 0;
+
+    if (workers)
+    {
+        while (started < threads &&
+            pthread_create(workers + started, NULL, work, pool) == 0)
+        {
+            started++;
+        }
+    }
+
+    if (!started)
+    {
+        work(pool);
+    }
+
+    for (int i = 0; i < started; i++)
+    {
+        pthread_join(workers[i], NULL);
+    }
+
+    free(workers);
+}
+
+int main(int count, String args[])
+{
+    int option;
+    long threads = sysconf(_SC_NPROCESSORS_ONLN);
+
+    while ((option = getopt(count, args, "j:")) != -1)
+    {
+        switch (option)
+        {
+            case 'j':
+                threads = atoi(optarg);
+                break;
+            default:
+                fprintf(stderr, ERROR_USAGE);
+                return 1;
+        }
+    }
+
+    if (optind != count - 1 || threads < 1)
+    {
+        fprintf(stderr, ERROR_USAGE);
+
+        return 1;
+    }
+
+    FILE* manifest = fopen(args[optind], "r");
+
+    if (!manifest)
+    {
+        fprintf(stderr, "%s", exception_message(EXCEPTION_IO));
+
+        return 1;
+    }
+
+    struct JobCollection jobs;
+    struct SourceCollection sources;
+
+    job_collection(&jobs);
+    source_collection(&sources);
+
+    int failures = read_manifest(manifest, &jobs, &sources);
+
+    fclose(manifest);
+
+    if (failures)
+    {
+        finalize_job_collection(&jobs);
+        finalize_source_collection(&sources);
+
+        return 1;
+    }
+
+    struct Pool pool;
+
+    pool.jobs = &jobs;
+    pool.sources = &sources;
+    pool.next = 0;
+
+    if (threads > jobs.count)
+    {
+        threads = jobs.count;
+    }
+
+    double start = wall_time();
+
+    pthread_mutex_init(&pool.mutex, NULL);
+    run(&pool, threads);
+    workspace_release();
+    pthread_mutex_destroy(&pool.mutex);
+
+    double wall = wall_time() - start;
+
+    printf("target,input,result,wall\n");
+
+    for (Job job = jobs.items; job < jobs.items + jobs.count; job++)
+    {
+        String path = sources.items[job->source].path;
+
+        if (job->exception)
+        {
+            fprintf(stderr, "%s %s: %s", job->solution->name, path,
+                exception_message(job->exception));
+
+            failures++;
+
+            continue;
+        }
+
+        printf("%s,%s,%lld,%lf\n", job->solution->name, path, job->result,
+            job->wall);
+    }
+
+    printf("total,,%d,%lf\n", jobs.count, wall);
+    finalize_job_collection(&jobs);
+    finalize_source_collection(&sources);
+
+    return failures != 0;
+}